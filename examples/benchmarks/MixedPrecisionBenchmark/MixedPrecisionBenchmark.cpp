@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+
+namespace ls = viennals;
+
+/**
+  This benchmark compares the memory used by the values of a level set and
+  the time advection takes when the values are stored in single precision to
+  the same level set stored in double precision. In both cases, the updates
+  of the values are accumulated in double precision. The results of both
+  are compared by the MixedPrecision test.
+  \example MixedPrecisionBenchmark.cpp
+*/
+
+template <class T> class ConstantVelocity : public ls::VelocityField<T> {
+public:
+  T getScalarVelocity(const ls::Vec3D<T> & /*coordinate*/, int /*material*/,
+                      const ls::Vec3D<T> & /*normalVector*/,
+                      unsigned long /*pointId*/) override {
+    return 1.;
+  }
+};
+
+template <class T> void runBenchmark(unsigned numberOfSteps) {
+  constexpr int D = 3;
+
+  auto levelSet = ls::SmartPointer<ls::Domain<T, D>>::New(0.2);
+  T origin[3] = {0., 0., 0.};
+  ls::MakeGeometry<T, D>(levelSet, ls::Sphere<T, D>::New(origin, 10.)).apply();
+
+  ls::Advect<T, D> advectionKernel(
+      levelSet, ls::SmartPointer<ConstantVelocity<T>>::New());
+  advectionKernel.setSingleStep(true);
+
+  const auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned i = 0; i < numberOfSteps; ++i) {
+    advectionKernel.apply();
+  }
+  const auto stop = std::chrono::high_resolution_clock::now();
+
+  const auto milliseconds =
+      std::chrono::duration_cast<std::chrono::milliseconds>(stop - start)
+          .count();
+  std::cout << sizeof(T) * 8 << " bit values: "
+            << levelSet->getNumberOfPoints() << " points, "
+            << levelSet->getNumberOfPoints() * sizeof(T) / 1024
+            << " KiB of values, " << milliseconds << " ms for "
+            << numberOfSteps << " steps ("
+            << levelSet->getNumberOfPoints() * numberOfSteps /
+                   std::max<double>(milliseconds, 1.) / 1e3
+            << " million points per second)\n";
+}
+
+int main() {
+  const unsigned numberOfSteps = 20;
+  for (unsigned cores = 1; cores < 17; cores *= 4) {
+    omp_set_num_threads(cores);
+    std::cout << cores << " threads:\n";
+    runBenchmark<double>(numberOfSteps);
+    runBenchmark<float>(numberOfSteps);
+  }
+
+  return 0;
+}
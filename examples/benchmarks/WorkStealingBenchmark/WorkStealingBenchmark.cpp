@@ -0,0 +1,75 @@
+#include <chrono>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+
+namespace ls = viennals;
+
+/**
+  This benchmark compares the time advection takes when each thread works on
+  one static segment of the level set to the time it takes when the active
+  points are distributed between threads using work stealing. The velocity
+  field is much more expensive to evaluate on the top of the sphere, so most
+  of the work falls into few segments. That both give the same result is
+  checked by the WorkStealing test.
+  \example WorkStealingBenchmark.cpp
+*/
+
+class UnevenVelocity : public ls::VelocityField<double> {
+public:
+  double getScalarVelocity(const ls::Vec3D<double> &coordinate,
+                           int /*material*/,
+                           const ls::Vec3D<double> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    if (coordinate[2] < 5.)
+      return 1.;
+
+    // simulate an expensive model for the points at the top
+    double velocity = 0.;
+    for (unsigned i = 1; i < 2000; ++i)
+      velocity += std::sin(coordinate[0] * i) / (i * i);
+    return 1. + 1e-3 * velocity;
+  }
+};
+
+int main() {
+  constexpr int D = 3;
+  using T = double;
+
+  double gridDelta = 0.25;
+  auto sphere = ls::SmartPointer<ls::Domain<T, D>>::New(gridDelta);
+  T origin[3] = {0., 0., 0.};
+  ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 8.)).apply();
+
+  auto velocities = ls::SmartPointer<UnevenVelocity>::New();
+
+  const unsigned numberOfSteps = 10;
+  for (unsigned cores = 1; cores < 17; cores *= 2) {
+    omp_set_num_threads(cores);
+
+    for (bool workStealing : {false, true}) {
+      auto levelSet = ls::SmartPointer<ls::Domain<T, D>>::New(sphere);
+      levelSet->getDomain().segment();
+
+      ls::Advect<T, D> advectionKernel(levelSet, velocities);
+      advectionKernel.setWorkStealing(workStealing);
+      advectionKernel.setSingleStep(true);
+
+      const auto start = std::chrono::high_resolution_clock::now();
+      for (unsigned i = 0; i < numberOfSteps; ++i) {
+        advectionKernel.apply();
+      }
+      const auto stop = std::chrono::high_resolution_clock::now();
+      std::cout << (workStealing ? "Work stealing" : "Static segments")
+                << " with " << cores << " threads: "
+                << std::chrono::duration_cast<std::chrono::milliseconds>(
+                       stop - start)
+                       .count()
+                << " ms\n";
+    }
+  }
+
+  return 0;
+}
@@ -2,8 +2,14 @@
 
 #include <lsPreCompileMacros.hpp>
 
+#include <algorithm>
+#include <array>
 #include <functional>
+#include <future>
 #include <limits>
+#include <optional>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <hrleSparseIterator.hpp>
@@ -13,9 +19,13 @@
 #include <vcSmartPointer.hpp>
 
 #include <lsBooleanOperation.hpp>
+#include <lsChunkScheduler.hpp>
 #include <lsDomain.hpp>
+#include <lsIndexRegion.hpp>
 #include <lsMarkVoidPoints.hpp>
 #include <lsReduce.hpp>
+#include <lsReinitialize.hpp>
+#include <lsStencilBatch.hpp>
 
 // Spatial discretization schemes
 #include <lsEngquistOsher.hpp>
@@ -30,6 +40,10 @@
 #include <lsAdvectIntegrationSchemes.hpp>
 
 // Velocity accessor
+#include <lsDissipationCache.hpp>
+#include <lsFrozenRates.hpp>
+#include <lsMaterialIndexField.hpp>
+#include <lsVelocityCache.hpp>
 #include <lsVelocityField.hpp>
 
 // #define DEBUG_LS_ADVECT_HPP
@@ -50,23 +64,34 @@ using namespace viennacore;
 /// LS_top = LS_top U LS_i for i = {0 ... n}, where n is the number of level
 /// sets. The velocities used to advect the level set are given in a concrete
 /// implementation of the lsVelocityField (check Advection examples for
-/// guidance)
-template <class T, int D> class Advect {
+/// guidance). By default, the velocity field is called through the virtual
+/// interface of VelocityField and can be exchanged at runtime. If the type
+/// of the velocity field is known at compile time, it can be passed as
+/// VelocityType instead. If that class is final, e.g. FunctionVelocityField,
+/// the velocities are evaluated without virtual calls, so they can be
+/// inlined into the spatial discretization schemes.
+template <class T, int D, class VelocityType = VelocityField<T>> class Advect {
+  static_assert(std::is_base_of_v<VelocityField<T>, VelocityType>,
+                "Advect: VelocityType must be derived from VelocityField.");
+
   using ConstSparseIterator =
       viennahrle::ConstSparseIterator<typename Domain<T, D>::DomainType>;
   using hrleIndexType = viennahrle::IndexType;
+  using AccumulationType = typename Domain<T, D>::AccumulationType;
 
   // Allow the time integration struct to access private members
-  friend struct lsInternal::AdvectTimeIntegration<T, D>;
+  using TimeIntegration = lsInternal::AdvectTimeIntegration<T, D, VelocityType>;
+  friend TimeIntegration;
 
   std::vector<SmartPointer<Domain<T, D>>> levelSets;
-  SmartPointer<VelocityField<T>> velocities = nullptr;
+  SmartPointer<VelocityType> velocities = nullptr;
   SpatialSchemeEnum spatialScheme = SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER;
   TemporalSchemeEnum temporalScheme = TemporalSchemeEnum::FORWARD_EULER;
   double timeStepRatio = 0.4999;
   double dissipationAlpha = 1.0;
   bool calculateNormalVectors = true;
   bool ignoreVoids = false;
+  bool incrementalVoidDetection = false;
   double advectionTime = 0.;
   bool performOnlySingleStep = false;
   double advectedTime = 0.;
@@ -77,19 +102,91 @@ template <class T, int D> class Advect {
   double integrationCutoff = 0.5;
   bool adaptiveTimeStepping = false;
   unsigned adaptiveTimeStepSubdivisions = 20;
+  bool multirateTimeStepping = false;
+  unsigned multirateSubcycles = 4;
+  bool fusedRateUpdate = false;
+  bool batchedSchemeEvaluation = false;
+  bool cacheDissipation = false;
+  bool cacheVelocities = false;
+  bool reuseStageVelocities = false;
+  bool workStealing = false;
+  bool euclideanReinitialization = false;
+  bool restrictLayerAdjustment = false;
+  bool asyncVelocityPreparation = false;
+  double errorTolerance = 0.01;
+  unsigned numberOfRejectedTimeSteps = 0;
+  // grid points of the top level set which moved during this time step
+  IndexRegion<D> changedRegion;
+  // whether the lower level sets were adjusted to the top level set at the
+  // end of the last time step and at the start of the current one
+  bool lowerLayersAdjusted = false;
+  bool lowerLayersAdjustedAtStepStart = false;
+  // moved points change the rebuilt narrow band of the top level set and the
+  // pruned lower level sets a few grid points away
+  static constexpr viennahrle::IndexType changedRegionMargin = 6;
   static constexpr double wrappingLayerEpsilon = 1e-4;
   std::vector<SmartPointer<Domain<T, D>>> initialLevelSets;
   std::function<bool(SmartPointer<Domain<T, D>>)> velocityUpdateCallback =
       nullptr;
+  // combines the largest stable time step with the ones of other advection
+  // kernels, e.g. of the other processes of a distributed advection
+  std::function<double(double)> timeStepReduction = nullptr;
+  // kept between time steps, so the void points can be marked incrementally
+  MarkVoidPoints<T, D> voidPointMarker;
+  // asynchronous preparation of the velocities of the top level set with
+  // the version preparedVersion, 0 if no preparation was started
+  std::shared_future<void> velocityPreparation;
+  std::size_t preparedVersion = 0;
+  VelocityType *preparedVelocities = nullptr;
 
   // this vector will hold the maximum time step for each point and the
   // corresponding velocity
   std::vector<std::vector<std::pair<std::pair<T, T>, T>>> storedRates;
   double currentTimeStep = -1.;
+  // Runge-Kutta stage whose rates are computed next, the time of the stage
+  // relative to the start of its time step and the time of the start of the
+  // time step since the start of apply(), passed to VelocityField::prepare2D
+  // or prepare3D
+  unsigned currentStage = 0;
+  double stageTimeOffset = 0.;
+  double stepStartTime = 0.;
+  // largest time step allowed by the estimated error of the last time step,
+  // if the time step is controlled by the error
+  double errorControlledTimeStep = std::numeric_limits<double>::max();
+
+  // velocities of the active points, if the velocity field evaluates batches
+  lsInternal::VelocityCache<T> velocityCache;
+  static constexpr unsigned velocityBatchSize = 1024;
+  // velocities cached by the first stage of the current time step, which
+  // are reused by its later stages if keepStageVelocities is set
+  lsInternal::StageVelocities<T, D> stageVelocities;
+  bool keepStageVelocities = false;
+  bool stageVelocitiesCached = false;
+  VectorType<T, D> stageAlphas{};
+
+  // dissipation coefficients of stencil points, shared by all stencils of
+  // the local Lax Friedrichs schemes within one time step
+  lsInternal::DissipationCache<T, D> dissipationCache;
+
+  // material and value of the level set below of each active point of the
+  // top level set, found once before the spatial scheme is applied
+  lsInternal::MaterialIndexField<T, D> materialIndices;
+
+  // materials which never move according to the velocity field, only found
+  // if the spatial scheme does not move points with zero velocity
+  std::vector<bool> staticMaterials;
+
+  // rates of slowly moving points reused for several time steps, if
+  // multirate time stepping is enabled
+  lsInternal::FrozenRates<T, D> frozenRates;
+
+  // chunks of the top level set distributed using work stealing, only
+  // created if work stealing is enabled
+  std::optional<lsInternal::ChunkScheduler<T, D>> chunkScheduler;
 
   VectorType<T, D> findGlobalAlphas() const {
 
-    auto &topDomain = levelSets.back()->getDomain();
+    const auto &topDomain = std::as_const(*levelSets.back()).getDomain();
     auto &grid = levelSets.back()->getGrid();
 
     const T gridDelta = grid.getGridDelta();
@@ -113,12 +210,6 @@ template <class T, int D> class Advect {
               ? topDomain.getSegmentation()[p]
               : grid.incrementIndices(grid.getMaxGridPoint());
 
-      // an iterator for each level set
-      std::vector<ConstSparseIterator> iterators;
-      for (auto const &ls : levelSets) {
-        iterators.emplace_back(ls->getDomain());
-      }
-
       // neighborIterator for the top level set
       viennahrle::ConstSparseStarIterator<typename Domain<T, D>::DomainType, 1>
           neighborIterator(topDomain);
@@ -129,60 +220,267 @@ template <class T, int D> class Advect {
         if (!it.isDefined() || std::abs(it.getValue()) > integrationCutoff)
           continue;
 
-        const T value = it.getValue();
         const auto indices = it.getStartIndices();
 
-        // check if there is any other levelset at the same point:
-        // if yes, take the velocity of the lowest levelset
-        for (unsigned lowerLevelSetId = 0; lowerLevelSetId < levelSets.size();
-             ++lowerLevelSetId) {
-          // put iterator to same position as the top levelset
-          iterators[lowerLevelSetId].goToIndicesSequential(indices);
+        // take the velocity of the lowest level set at this point
+        const int material = materialIndices.getMaterial(it.getPointId());
+        if (material < 0)
+          continue;
 
-          // if the lower surface is actually outside, i.e. its LS value
-          // is lower or equal
-          if (iterators[lowerLevelSetId].getValue() <=
-              value + wrappingLayerEpsilon) {
+        // move neighborIterator to current position
+        neighborIterator.goToIndicesSequential(indices);
+
+        Vec3D<T> coords{};
+        for (unsigned i = 0; i < D; ++i) {
+          coords[i] = indices[i] * gridDelta;
+        }
 
-            // move neighborIterator to current position
-            neighborIterator.goToIndicesSequential(indices);
+        Vec3D<T> normal{};
+        T normalModulus = 0.;
+        for (unsigned i = 0; i < D; ++i) {
+          const T phiPos = neighborIterator.getNeighbor(i).getValue();
+          const T phiNeg = neighborIterator.getNeighbor(i + D).getValue();
 
-            Vec3D<T> coords{};
-            for (unsigned i = 0; i < D; ++i) {
-              coords[i] = indices[i] * gridDelta;
-            }
+          normal[i] = phiPos - phiNeg;
+          normalModulus += normal[i] * normal[i];
+        }
+        normalModulus = 1. / std::sqrt(normalModulus);
+        for (unsigned i = 0; i < D; ++i)
+          normal[i] *= normalModulus;
 
-            Vec3D<T> normal{};
-            T normalModulus = 0.;
-            for (unsigned i = 0; i < D; ++i) {
-              const T phiPos = neighborIterator.getNeighbor(i).getValue();
-              const T phiNeg = neighborIterator.getNeighbor(i + D).getValue();
+        T scaVel = velocities->getScalarVelocity(
+            coords, material, normal,
+            neighborIterator.getCenter().getPointId());
+        auto vecVel = velocities->getVectorVelocity(
+            coords, material, normal,
+            neighborIterator.getCenter().getPointId());
 
-              normal[i] = phiPos - phiNeg;
-              normalModulus += normal[i] * normal[i];
-            }
+        for (unsigned i = 0; i < D; ++i) {
+          T tempAlpha = std::abs((scaVel + vecVel[i]) * normal[i]);
+          localAlphas[i] = std::max(localAlphas[i], tempAlpha);
+        }
+      }
+
+#pragma omp critical
+      {
+        for (unsigned i = 0; i < D; ++i) {
+          finalAlphas[i] = std::max(finalAlphas[i], localAlphas[i]);
+        }
+      }
+    } // end of parallel section
+
+    return finalAlphas;
+  }
+
+  /// Whether the rates of slowly moving points are reused for several time
+  /// steps. This requires the rates to be stored and is only consistent for
+  /// forward Euler time integration.
+  bool usesMultirate() const {
+    return multirateTimeStepping && multirateSubcycles > 1 &&
+           !fusedRateUpdate &&
+           temporalScheme == TemporalSchemeEnum::FORWARD_EULER;
+  }
+
+  /// Finds the materials which are static according to the velocity field.
+  /// The Lax Friedrichs schemes add dissipation to points with zero
+  /// velocity, so static points can only be skipped for the upwind schemes.
+  void findStaticMaterials() {
+    staticMaterials.clear();
+    switch (spatialScheme) {
+    case SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER:
+    case SpatialSchemeEnum::ENGQUIST_OSHER_2ND_ORDER:
+    case SpatialSchemeEnum::WENO_3RD_ORDER:
+    case SpatialSchemeEnum::WENO_5TH_ORDER:
+      break;
+    default:
+      return;
+    }
+    for (unsigned i = 0; i < levelSets.size(); ++i)
+      staticMaterials.push_back(velocities->isStaticMaterial(i));
+  }
+
+  bool isStaticMaterial(int material) const {
+    return material >= 0 &&
+           material < static_cast<int>(staticMaterials.size()) &&
+           staticMaterials[material];
+  }
+
+  /// Whether the selected spatial discretization scheme passes normal
+  /// vectors to the velocity field.
+  bool usesNormalVectors() const {
+    switch (spatialScheme) {
+    case SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER:
+    case SpatialSchemeEnum::ENGQUIST_OSHER_2ND_ORDER:
+    case SpatialSchemeEnum::LAX_FRIEDRICHS_1ST_ORDER:
+    case SpatialSchemeEnum::LAX_FRIEDRICHS_2ND_ORDER:
+    case SpatialSchemeEnum::WENO_3RD_ORDER:
+    case SpatialSchemeEnum::WENO_5TH_ORDER:
+      return calculateNormalVectors;
+    default:
+      return true;
+    }
+  }
+
+  /// Evaluates the velocities of all active points of the top level set and
+  /// stores them in velocityCache. If the velocity field implements the
+  /// batched interface, it is queried in batches. Otherwise, velocities are
+  /// only cached if cacheVelocities or cacheAll is set, since the spatial
+  /// scheme requests them point by point anyway. Normal vectors are
+  /// calculated using central differences. Returns the largest dissipation
+  /// coefficients of all cached points, as needed by the global Lax
+  /// Friedrichs schemes.
+  VectorType<T, D> updateVelocityCache(bool cacheAll = false) {
+    // later stages of a time step use the velocities of the first stage
+    if (stageVelocitiesCached) {
+      stageVelocities.restore(velocityCache, *levelSets.back(),
+                              integrationCutoff);
+      return stageAlphas;
+    }
+
+    velocityCache.clear();
+
+    // check whether the velocity field evaluates batches at all
+    bool batched = false;
+    {
+      VelocityBatch<T> emptyBatch;
+      batched = velocities->getVelocities(emptyBatch);
+    }
+
+    VectorType<T, D> finalAlphas{};
+    if (!batched && !cacheVelocities && !keepStageVelocities && !cacheAll)
+      return finalAlphas;
+
+    const auto &topDomain = std::as_const(*levelSets.back()).getDomain();
+    auto &grid = levelSets.back()->getGrid();
+    const T gridDelta = grid.getGridDelta();
+    const bool calculateNormals = usesNormalVectors();
+
+    velocityCache.reset(topDomain.getNumberOfPoints());
+
+    if (chunkScheduler)
+      chunkScheduler->restart();
+    const unsigned numberOfThreads = chunkScheduler
+                                         ? chunkScheduler->getNumberOfThreads()
+                                         : topDomain.getNumberOfSegments();
+
+#pragma omp parallel num_threads(numberOfThreads)
+    {
+      VectorType<T, D> localAlphas{};
+
+      // neighborIterator for the top level set
+      viennahrle::ConstSparseStarIterator<typename Domain<T, D>::DomainType, 1>
+          neighborIterator(topDomain);
+
+      // normals used for the dissipation coefficients, these are also
+      // needed if no normals are passed to the velocity field
+      std::vector<Vec3D<T>> alphaNormals;
+      VelocityBatch<T> batch;
+      if (batched) {
+        alphaNormals.reserve(velocityBatchSize);
+        batch.reserve(velocityBatchSize);
+      }
+
+      auto insertVelocities = [&](unsigned long pointId, int material,
+                                  T scaVel, const Vec3D<T> &vecVel,
+                                  const Vec3D<T> &normal) {
+        velocityCache.insert(pointId, material, scaVel, vecVel);
+        for (unsigned i = 0; i < D; ++i) {
+          T tempAlpha = std::abs((scaVel + vecVel[i]) * normal[i]);
+          localAlphas[i] = std::max(localAlphas[i], tempAlpha);
+        }
+      };
+
+      auto evaluateBatch = [&]() {
+        batch.scalarVelocities.resize(batch.size());
+        batch.vectorVelocities.resize(batch.size());
+        velocities->getVelocities(batch);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+          insertVelocities(batch.pointIds[i], batch.materials[i],
+                           batch.scalarVelocities[i],
+                           batch.vectorVelocities[i], alphaNormals[i]);
+        }
+        batch.clear();
+        alphaNormals.clear();
+      };
+
+      auto cacheRange = [&](const viennahrle::Index<D> &startVector,
+                            const viennahrle::Index<D> &endVector) {
+        // the velocities of frozen points are not needed
+        auto frozenCursor = frozenRates.getCursor(startVector);
+        for (ConstSparseIterator it(topDomain, startVector);
+             it.getStartIndices() < endVector; it.next()) {
+
+          if (!it.isDefined() || std::abs(it.getValue()) > integrationCutoff)
+            continue;
+
+          const auto indices = it.getStartIndices();
+          if (frozenCursor.find(indices) != nullptr)
+            continue;
+
+          // the velocity of the lowest level set at this point is used
+          const int material = materialIndices.getMaterial(it.getPointId());
+          if (material < 0 || isStaticMaterial(material))
+            continue;
+
+          Vec3D<T> coordinate{};
+          for (unsigned i = 0; i < D; ++i) {
+            coordinate[i] = indices[i] * gridDelta;
+          }
+
+          neighborIterator.goToIndicesSequential(indices);
+          Vec3D<T> normal{};
+          T normalModulus = 0.;
+          for (unsigned i = 0; i < D; ++i) {
+            const T phiPos = neighborIterator.getNeighbor(i).getValue();
+            const T phiNeg = neighborIterator.getNeighbor(i + D).getValue();
+            normal[i] = phiPos - phiNeg;
+            normalModulus += normal[i] * normal[i];
+          }
+          if (normalModulus > 0.) {
             normalModulus = 1. / std::sqrt(normalModulus);
             for (unsigned i = 0; i < D; ++i)
               normal[i] *= normalModulus;
-
-            T scaVel = velocities->getScalarVelocity(
-                coords, lowerLevelSetId, normal,
-                neighborIterator.getCenter().getPointId());
+          }
+          const Vec3D<T> velocityNormal =
+              calculateNormals ? normal : Vec3D<T>{};
+
+          if (batched) {
+            batch.push_back(coordinate, material, velocityNormal,
+                            it.getPointId());
+            alphaNormals.push_back(normal);
+            if (batch.size() == velocityBatchSize)
+              evaluateBatch();
+          } else {
+            T scaVel = velocities->getScalarVelocity(coordinate, material,
+                                                     velocityNormal,
+                                                     it.getPointId());
             auto vecVel = velocities->getVectorVelocity(
-                coords, lowerLevelSetId, normal,
-                neighborIterator.getCenter().getPointId());
-
-            for (unsigned i = 0; i < D; ++i) {
-              T tempAlpha = std::abs((scaVel + vecVel[i]) * normal[i]);
-              localAlphas[i] = std::max(localAlphas[i], tempAlpha);
-            }
-
-            // exit material loop
-            break;
+                coordinate, material, velocityNormal, it.getPointId());
+            insertVelocities(it.getPointId(), material, scaVel, vecVel, normal);
           }
         }
+      };
+
+      if (chunkScheduler) {
+        chunkScheduler->processChunks([&](unsigned chunk) {
+          cacheRange(chunkScheduler->getStartIndices(chunk),
+                     chunkScheduler->getEndIndices(chunk));
+        });
+      } else {
+        int p = 0;
+#ifdef _OPENMP
+        p = omp_get_thread_num();
+#endif
+        cacheRange((p == 0) ? grid.getMinGridPoint()
+                            : topDomain.getSegmentation()[p - 1],
+                   (p != static_cast<int>(topDomain.getNumberOfSegments() - 1))
+                       ? topDomain.getSegmentation()[p]
+                       : grid.incrementIndices(grid.getMaxGridPoint()));
       }
 
+      if (!batch.empty())
+        evaluateBatch();
+
 #pragma omp critical
       {
         for (unsigned i = 0; i < D; ++i) {
@@ -191,59 +489,79 @@ template <class T, int D> class Advect {
       }
     } // end of parallel section
 
+    if (keepStageVelocities) {
+      stageVelocities.store(velocityCache, *levelSets.back());
+      stageVelocitiesCached = true;
+      stageAlphas = finalAlphas;
+    }
+
     return finalAlphas;
   }
 
-  // Helper function for linear combination:
-  // target = wTarget * target + wSource * source
-  bool combineLevelSets(T wTarget, T wSource) {
+  /// Starts a time step with several stages. If velocities should be reused
+  /// in later stages, the velocities cached by the first stage are kept.
+  /// This is not done if a velocity update callback changes the velocity
+  /// field between the stages.
+  void beginStageVelocityReuse() {
+    keepStageVelocities = reuseStageVelocities && !velocityUpdateCallback;
+    stageVelocitiesCached = false;
+    stageVelocities.clear();
+  }
+
+  /// Ends a time step with several stages, so the next time step evaluates
+  /// the velocities again.
+  void endStageVelocityReuse() {
+    keepStageVelocities = false;
+    stageVelocitiesCached = false;
+    stageVelocities.clear();
+  }
+
+  /// Replaces the top level set by the convex combination
+  /// wSource * current + wTarget * initial of the current and the initial
+  /// top level set of the time step, as needed by the Runge-Kutta schemes.
+  /// The combined values are calculated while the narrow band is rebuilt, so
+  /// no intermediate level set is created. Returns whether any point moved
+  /// down compared to the initial level set.
+  bool combineLevelSets(AccumulationType wTarget, AccumulationType wSource) {
     // Calculate required expansion width based on CFL and RK steps
     int steps = 1;
     if (temporalScheme == TemporalSchemeEnum::RUNGE_KUTTA_2ND_ORDER) {
       steps = 2;
-    } else if (temporalScheme == TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER) {
+    } else if (temporalScheme == TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER ||
+               temporalScheme ==
+                   TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER_ADAPTIVE) {
       steps = 3;
     }
 
-    // Expand both level sets to ensure sufficient overlap
+    // Expand both level sets to ensure sufficient overlap. The initial level
+    // set is not changed between the combinations of a time step, so it only
+    // has to be expanded by the first one.
     int expansionWidth = std::ceil(2.0 * steps * timeStepRatio + 1);
     viennals::Expand<T, D>(levelSets.back(), expansionWidth).apply();
-    viennals::Expand<T, D>(initialLevelSets.back(), expansionWidth).apply();
-
-    bool movedDown = false;
-
-    viennals::BooleanOperation<T, D> op(levelSets.back(),
-                                        initialLevelSets.back(),
-                                        viennals::BooleanOperationEnum::CUSTOM);
-    op.setBooleanOperationComparator(
-        [wTarget, wSource, &movedDown](const T &a, const T &b) {
-          if (a != Domain<T, D>::POS_VALUE && a != Domain<T, D>::NEG_VALUE &&
-              b != Domain<T, D>::POS_VALUE && b != Domain<T, D>::NEG_VALUE) {
-            T res = wSource * a + wTarget * b;
-            if (res > b)
-              movedDown = true;
-            return std::make_pair(res, true);
-          }
-          if (a == Domain<T, D>::POS_VALUE || a == Domain<T, D>::NEG_VALUE)
-            return std::make_pair(a, false);
-          return std::make_pair(b, false);
-        });
-    op.apply();
+    if (initialLevelSets.back()->getLevelSetWidth() < expansionWidth)
+      viennals::Expand<T, D>(initialLevelSets.back(), expansionWidth).apply();
 
-    rebuildLS();
-
-    return movedDown;
+    return rebuildLS(initialLevelSets.back().get(), wTarget, wSource);
   }
 
-  void rebuildLS() {
-    // TODO: this function uses Manhattan distances for renormalisation,
-    // since this is the quickest. For visualisation applications, better
-    // renormalisation is needed, so it might be good to implement
-    // Euler distance renormalisation as an option
+  void rebuildLS() { rebuildLS(nullptr, 0., 1.); }
+
+  /// Rebuilds the narrow band of the top level set. If initialLevelSet is
+  /// given, the narrow band is rebuilt from the convex combination
+  /// currentWeight * current + initialWeight * initial of both level sets,
+  /// which is only defined where both level sets are defined and calculated
+  /// in the accumulation type. Returns whether any combined value is larger
+  /// than the initial value.
+  bool rebuildLS(const Domain<T, D> *initialLevelSet,
+                 AccumulationType initialWeight,
+                 AccumulationType currentWeight) {
+    // This function uses Manhattan distances for renormalisation, since this
+    // is the quickest. If euclideanReinitialization is set, the values
+    // outside the interface are replaced by Euclidean distances afterwards.
     auto &grid = levelSets.back()->getGrid();
-    auto newlsDomain = SmartPointer<Domain<T, D>>::New(grid);
-    auto &newDomain = newlsDomain->getDomain();
-    auto &domain = levelSets.back()->getDomain();
+    // the new values are written into the buffer domain and swapped in
+    auto &newDomain = levelSets.back()->getBufferDomain();
+    const auto &domain = std::as_const(*levelSets.back()).getDomain();
 
     // Determine cutoff and width based on discretization scheme to avoid
     // immediate re-expansion
@@ -274,7 +592,10 @@ template <class T, int D> class Advect {
     }
 #endif
 
-#pragma omp parallel num_threads(newDomain.getNumberOfSegments())
+    bool movedDown = false;
+
+#pragma omp parallel num_threads(newDomain.getNumberOfSegments())              \
+    reduction(|| : movedDown)
     {
       int p = 0;
 #ifdef _OPENMP
@@ -296,33 +617,66 @@ template <class T, int D> class Advect {
       if (updateData)
         newDataSourceIds[p].reserve(2.5 * domainSegment.getNumberOfPoints());
 
-      for (viennahrle::ConstSparseStarIterator<
-               typename Domain<T, D>::DomainType, 1>
-               it(domain, startVector);
-           it.getIndices() < endVector; ++it) {
+      using StarIterator =
+          viennahrle::ConstSparseStarIterator<typename Domain<T, D>::DomainType,
+                                              1>;
+      std::optional<StarIterator> initialIt;
+      if (initialLevelSet != nullptr)
+        initialIt.emplace(std::as_const(*initialLevelSet).getDomain());
+
+      // value of the level set to rebuild at a point of the stencil, the
+      // combination is undefined if any of both level sets is undefined
+      auto getValue = [&](const auto &currentPoint, const auto &initialPoint) {
+        if (!initialIt || !currentPoint.isDefined())
+          return currentPoint.getValue();
+        if (!initialPoint.isDefined())
+          return initialPoint.getValue();
+        return static_cast<T>(currentWeight * currentPoint.getValue() +
+                              initialWeight * initialPoint.getValue());
+      };
+
+      std::array<T, 2 * D> neighborValues;
+
+      for (StarIterator it(domain, startVector); it.getIndices() < endVector;
+           ++it) {
+
+        // without a combination, the initial iterator is never read
+        if (initialIt)
+          initialIt->goToIndicesSequential(it.getIndices());
+        const auto &initialStar = initialIt ? *initialIt : it;
+
+        const T centerValue = getValue(it.getCenter(), initialStar.getCenter());
+        for (int i = 0; i < 2 * D; ++i)
+          neighborValues[i] =
+              getValue(it.getNeighbor(i), initialStar.getNeighbor(i));
+
+        if (initialIt && it.getCenter().isDefined() &&
+            initialStar.getCenter().isDefined() &&
+            centerValue > initialStar.getCenter().getValue())
+          movedDown = true;
 
         // if the center is an active grid point
         // <1.0 since it could have been change by 0.5 max
-        if (std::abs(it.getCenter().getValue()) <= 1.0) {
+        if (std::abs(centerValue) <= 1.0) {
 
           int k = 0;
           for (; k < 2 * D; k++)
-            if (std::signbit(it.getNeighbor(k).getValue() - 1e-7) !=
-                std::signbit(it.getCenter().getValue() + 1e-7))
+            if (std::signbit(neighborValues[k] - 1e-7) !=
+                std::signbit(centerValue + 1e-7))
               break;
 
           // if there is at least one neighbor of opposite sign
           if (k != 2 * D) {
-            if (it.getCenter().getDefinedValue() > 0.5) {
+            if (centerValue > 0.5) {
               int j = 0;
               for (; j < 2 * D; j++) {
-                if (std::abs(it.getNeighbor(j).getValue()) <= 1.0)
-                  if (it.getNeighbor(j).getDefinedValue() < -0.5)
+                if (std::abs(neighborValues[j]) <= 1.0)
+                  if (neighborValues[j] < -0.5)
                     break;
               }
               if (j == 2 * D) {
-                domainSegment.insertNextDefinedPoint(
-                    it.getIndices(), it.getCenter().getDefinedValue());
+                domainSegment.insertNextDefinedPoint(it.getIndices(),
+                                                     centerValue);
                 if (updateData)
                   newDataSourceIds[p].push_back(it.getCenter().getPointId());
                 // if there is at least one active grid point, which is < -0.5
@@ -331,17 +685,17 @@ template <class T, int D> class Advect {
                 if (updateData)
                   newDataSourceIds[p].push_back(it.getNeighbor(j).getPointId());
               }
-            } else if (it.getCenter().getDefinedValue() < -0.5) {
+            } else if (centerValue < -0.5) {
               int j = 0;
               for (; j < 2 * D; j++) {
-                if (std::abs(it.getNeighbor(j).getValue()) <= 1.0)
-                  if (it.getNeighbor(j).getDefinedValue() > 0.5)
+                if (std::abs(neighborValues[j]) <= 1.0)
+                  if (neighborValues[j] > 0.5)
                     break;
               }
 
               if (j == 2 * D) {
-                domainSegment.insertNextDefinedPoint(
-                    it.getIndices(), it.getCenter().getDefinedValue());
+                domainSegment.insertNextDefinedPoint(it.getIndices(),
+                                                     centerValue);
                 if (updateData)
                   newDataSourceIds[p].push_back(it.getCenter().getPointId());
                 // if there is at least one active grid point, which is > 0.5
@@ -351,24 +705,23 @@ template <class T, int D> class Advect {
                   newDataSourceIds[p].push_back(it.getNeighbor(j).getPointId());
               }
             } else {
-              domainSegment.insertNextDefinedPoint(
-                  it.getIndices(), it.getCenter().getDefinedValue());
+              domainSegment.insertNextDefinedPoint(it.getIndices(),
+                                                   centerValue);
               if (updateData)
                 newDataSourceIds[p].push_back(it.getCenter().getPointId());
             }
           } else {
             domainSegment.insertNextUndefinedPoint(
-                it.getIndices(), (it.getCenter().getDefinedValue() < 0)
-                                     ? Domain<T, D>::NEG_VALUE
-                                     : Domain<T, D>::POS_VALUE);
+                it.getIndices(), (centerValue < 0) ? Domain<T, D>::NEG_VALUE
+                                                   : Domain<T, D>::POS_VALUE);
           }
 
         } else { // if the center is not an active grid point
-          if (it.getCenter().getValue() >= 0) {
+          if (centerValue >= 0) {
             int usedNeighbor = -1;
             T distance = Domain<T, D>::POS_VALUE;
             for (int i = 0; i < 2 * D; i++) {
-              T value = it.getNeighbor(i).getValue();
+              T value = neighborValues[i];
               if (std::abs(value) <= 1.0 && (value < 0.)) {
                 if (distance > value + 1.0) {
                   distance = value + 1.0;
@@ -391,7 +744,7 @@ template <class T, int D> class Advect {
             int usedNeighbor = -1;
             T distance = Domain<T, D>::NEG_VALUE;
             for (int i = 0; i < 2 * D; i++) {
-              T value = it.getNeighbor(i).getValue();
+              T value = neighborValues[i];
               if (std::abs(value) <= 1.0 && (value > 0)) {
                 if (distance < value - 1.0) {
                   // distance = std::max(distance, value - T(1.0));
@@ -416,180 +769,435 @@ template <class T, int D> class Advect {
     }
 
     // now copy old data into new level set
+    typename Domain<T, D>::PointDataType newPointData;
     if (updateData) {
-      auto &pointData = levelSets.back()->getPointData();
-      newlsDomain->getPointData().translateFromMultiData(pointData,
-                                                         newDataSourceIds);
+      const auto &pointData = std::as_const(*levelSets.back()).getPointData();
+      newPointData.translateFromMultiData(pointData, newDataSourceIds);
     }
 
     newDomain.finalize();
     newDomain.segment();
-    levelSets.back()->deepCopy(newlsDomain);
+    levelSets.back()->swapBuffer(std::move(newPointData));
     levelSets.back()->finalize(finalWidth);
+
+    if (euclideanReinitialization)
+      Reinitialize<T, D>(levelSets.back()).apply();
+
+    return movedDown;
+  }
+
+  /// Evaluates the spatial discretization scheme at an active point of the top
+  /// level set and appends the rates for all materials the point can pass
+  /// through within one time step to rates. Returns the maximum time step
+  /// this point allows. The material and the value below the top level set
+  /// are taken from materialIndices, the iterators of the lower level sets
+  /// are only moved if the point passes through a material. If topRate is
+  /// given, it is used as the result of the scheme for the material of the
+  /// top level set instead of evaluating the scheme.
+  template <class DiscretizationSchemeType, class RatesType>
+  double calculatePointRates(DiscretizationSchemeType &scheme,
+                             std::vector<ConstSparseIterator> &iterators,
+                             const viennahrle::Index<D> &indices,
+                             unsigned long pointId, T value, bool isVoid,
+                             RatesType &rates,
+                             const std::pair<T, T> *topRate = nullptr) const {
+    const auto adaptiveFactor = 1.0 / adaptiveTimeStepSubdivisions;
+    double maxStepTime = 0;
+    double cfl = timeStepRatio;
+    const int topLevelSetId = levelSets.size() - 1;
+
+    for (int currentLevelSetId = topLevelSetId; currentLevelSetId >= 0;
+         --currentLevelSetId) {
+
+      std::pair<T, T> gradNDissipation;
+
+      if (!isVoid && currentLevelSetId == topLevelSetId) {
+        gradNDissipation =
+            (topRate != nullptr)
+                ? *topRate
+                : scheme(indices, materialIndices.getMaterial(pointId));
+      } else if (!isVoid) {
+        // check if there is any other levelset at the same point:
+        // if yes, take the velocity of the lowest levelset
+        for (unsigned lowerLevelSetId = 0; lowerLevelSetId < levelSets.size();
+             ++lowerLevelSetId) {
+          // put iterator to same position as the top levelset
+          iterators[lowerLevelSetId].goToIndicesSequential(indices);
+
+          // if the lower surface is actually outside, i.e. its LS value
+          // is lower or equal
+          if (iterators[lowerLevelSetId].getValue() <=
+              value + wrappingLayerEpsilon) {
+            if (!isStaticMaterial(lowerLevelSetId))
+              gradNDissipation = scheme(indices, lowerLevelSetId);
+            break;
+          }
+        }
+      }
+
+      T velocity = gradNDissipation.first - gradNDissipation.second;
+      if (velocity > 0.) {
+        // Case 1: Growth / Deposition (Velocity > 0)
+        // Limit the time step based on the standard CFL condition.
+        maxStepTime += cfl / velocity;
+        rates.emplace_back(gradNDissipation, -std::numeric_limits<T>::max());
+        break;
+      } else if (velocity == 0.) {
+        // Case 2: Static (Velocity == 0)
+        // No time step limit imposed by this point.
+        maxStepTime = std::numeric_limits<T>::max();
+        rates.emplace_back(gradNDissipation, std::numeric_limits<T>::max());
+        break;
+      } else {
+        // Case 3: Etching (Velocity < 0)
+        // Retrieve the interface location of the underlying material.
+        T valueBelow;
+        if (currentLevelSetId == topLevelSetId) {
+          valueBelow = materialIndices.getValueBelow(pointId);
+        } else if (currentLevelSetId > 0) {
+          iterators[currentLevelSetId - 1].goToIndicesSequential(indices);
+          valueBelow = iterators[currentLevelSetId - 1].getValue();
+        } else {
+          valueBelow = std::numeric_limits<T>::max();
+        }
+        // Calculate the top material thickness
+        T difference = std::abs(valueBelow - value);
+
+        if (difference >= cfl) {
+          // Sub-case 3a: Standard Advection
+          // Far from interface: Use full CFL time step.
+          maxStepTime -= cfl / velocity;
+          rates.emplace_back(gradNDissipation, std::numeric_limits<T>::max());
+          break;
+        } else {
+          // Sub-case 3b: Interface Interaction
+          // Use adaptiveFactor as threshold.
+          if (adaptiveTimeStepping && difference > adaptiveFactor * cfl) {
+            // Adaptive Sub-stepping:
+            // Approaching boundary: Force small steps to gather
+            // flux statistics and prevent numerical overshoot ("Soft
+            // Landing").
+            maxStepTime -= adaptiveFactor * cfl / velocity;
+            rates.emplace_back(gradNDissipation,
+                               std::numeric_limits<T>::max());
+            break;
+          } else {
+            // Terminal Step:
+            // Within tolerance: Snap to boundary, consume budget, and
+            // switch material.
+            cfl -= difference;
+            value = valueBelow;
+            maxStepTime -= difference / velocity;
+            rates.emplace_back(gradNDissipation, valueBelow);
+          }
+        }
+      }
+    }
+
+    return maxStepTime;
+  }
+
+  /// Moves value by the time step dt using the rates of one point, starting
+  /// at itRS. If the point reaches a lower material during the time step, the
+  /// remaining time is spent with the rate of that material. Afterwards, itRS
+  /// points to the first rate of the next point. Returns the applied change
+  /// and writes the dissipation of the last used rate to dissipation. The
+  /// change is calculated in the accumulation type and value is only rounded
+  /// once at the end.
+  template <class RateIterator>
+  static T applyPointRates(T &value, double dt, RateIterator &itRS,
+                           bool checkDiss, T &dissipation) {
+    double time = dt;
+    AccumulationType newValue = value;
+
+    // if there is a change in materials during one time step, deduct
+    // the time taken to advect up to the end of the top material and
+    // set the LS value to the one below
+    auto const [gradient, diss] = itRS->first;
+    AccumulationType velocity = AccumulationType(gradient) - diss;
+    // check if dissipation is too high and would cause a change in
+    // direction of the velocity
+    if (checkDiss && (gradient < 0 && velocity > 0) ||
+        (gradient > 0 && velocity < 0)) {
+      velocity = 0;
+    }
+
+    AccumulationType rate = time * velocity;
+    while (std::abs(itRS->second - newValue) < std::abs(rate)) {
+      time -= std::abs((itRS->second - newValue) / velocity);
+      newValue = itRS->second;
+      ++itRS; // advance the TempStopRates iterator by one
+
+      // recalculate velocity and rate
+      velocity = AccumulationType(itRS->first.first) - itRS->first.second;
+      if (checkDiss && (itRS->first.first < 0 && velocity > 0) ||
+          (itRS->first.first > 0 && velocity < 0)) {
+        velocity = 0;
+      }
+      rate = time * velocity;
+    }
+
+    // now deduct the velocity times the time step we take
+    newValue -= rate;
+    value = static_cast<T>(newValue);
+    dissipation = itRS->first.second;
+
+    // this is run when two materials are close but the velocity is too slow
+    // to actually reach the second material, to get rid of the extra
+    // entry in the TempRatesStop
+    while (std::abs(itRS->second) != std::numeric_limits<T>::max())
+      ++itRS;
+
+    // advance the TempStopRates iterator by one
+    ++itRS;
+
+    return static_cast<T>(rate);
+  }
+
+  /// Marks void points if voids should be ignored and returns the void point
+  /// markers of the top level set, or nullptr if voids are not ignored.
+  const typename PointData<T>::ScalarDataType *
+  getVoidPointMarkers(bool markVoids) {
+    if (!ignoreVoids)
+      return nullptr;
+
+    if (markVoids) {
+      voidPointMarker.setLevelSet(levelSets.back());
+      voidPointMarker.setIncremental(incrementalVoidDetection);
+      voidPointMarker.apply();
+    }
+    auto voidMarkerPointer =
+        std::as_const(*levelSets.back())
+            .getPointData()
+            .getScalarData(MarkVoidPoints<T, D>::voidPointLabel, true);
+    if (voidMarkerPointer == nullptr) {
+      VIENNACORE_LOG_WARNING("Advect: Cannot find void point markers. Not "
+                             "ignoring void points.");
+      ignoreVoids = false;
+    }
+    return voidMarkerPointer;
   }
 
   /// Internal function used to calculate the deltas to be applied to the LS
   /// values from the given velocities and the spatial discretization scheme to
   /// be used. This function fills up the storedRates to be used when moving the
-  /// LS
+  /// LS. If storeRates is false, only the maximum time step is calculated.
   template <class DiscretizationSchemeType>
   double integrateTime(DiscretizationSchemeType spatialScheme,
-                       double maxTimeStep) {
+                       double maxTimeStep, bool storeRates = true) {
 
-    auto &topDomain = levelSets.back()->getDomain();
+    const auto &topDomain = std::as_const(*levelSets.back()).getDomain();
     auto &grid = levelSets.back()->getGrid();
 
-    typename PointData<T>::ScalarDataType *voidMarkerPointer;
-    if (ignoreVoids) {
-      MarkVoidPoints<T, D>(levelSets.back()).apply();
-      auto &pointData = levelSets.back()->getPointData();
-      voidMarkerPointer =
-          pointData.getScalarData(MarkVoidPoints<T, D>::voidPointLabel, true);
-      if (voidMarkerPointer == nullptr) {
-        VIENNACORE_LOG_WARNING("Advect: Cannot find void point markers. Not "
-                               "ignoring void points.");
-        ignoreVoids = false;
+    auto voidMarkerPointer = getVoidPointMarkers(true);
+    const bool ignoreVoidPoints = voidMarkerPointer != nullptr;
+
+    // velocities were cached before the scheme was created
+    const auto *cache = velocityCache.empty() ? nullptr : &velocityCache;
+
+    if (storeRates) {
+      if (!storedRates.empty()) {
+        VIENNACORE_LOG_WARNING("Advect: Overwriting previously stored rates.");
       }
+      storedRates.resize(topDomain.getNumberOfSegments());
     }
-    const bool ignoreVoidPoints = ignoreVoids;
-    const bool useAdaptiveTimeStepping = adaptiveTimeStepping;
-    const auto adaptiveFactor = 1.0 / adaptiveTimeStepSubdivisions;
 
-    if (!storedRates.empty()) {
-      VIENNACORE_LOG_WARNING("Advect: Overwriting previously stored rates.");
+    // with work stealing, the rates are stored per chunk first and then
+    // joined into the rates of each segment
+    std::vector<std::vector<std::pair<std::pair<T, T>, T>>> chunkRates;
+    if (chunkScheduler) {
+      chunkScheduler->restart();
+      if (storeRates)
+        chunkRates.resize(chunkScheduler->getNumberOfChunks());
     }
 
-    storedRates.resize(topDomain.getNumberOfSegments());
-
-#pragma omp parallel num_threads(topDomain.getNumberOfSegments())
+    const unsigned numberOfThreads = chunkScheduler
+                                         ? chunkScheduler->getNumberOfThreads()
+                                         : topDomain.getNumberOfSegments();
+
+    const bool trackChanges = restrictLayerAdjustment;
+
+    // With multirate time stepping, the rates of all points are calculated
+    // in the first time step and the rates of slow points are frozen. The
+    // following time steps only calculate the rates of the other points.
+    using FrozenEntryType = typename lsInternal::FrozenRates<T, D>::EntryType;
+    using FrozenRateType = typename lsInternal::FrozenRates<T, D>::RateType;
+    const bool multirate = storeRates && usesMultirate();
+    const bool freezeRates = multirate && frozenRates.empty();
+    // points which could be frozen and their maximum time step
+    std::vector<std::pair<FrozenEntryType, double>> freezeCandidates;
+
+    // evaluate the scheme for batches of points, if it supports it
+    constexpr unsigned batchSize = lsInternal::stencilBatchSize;
+    const bool batched =
+        batchedSchemeEvaluation &&
+        lsInternal::HasBatchEvaluation<DiscretizationSchemeType>::value;
+
+#pragma omp parallel num_threads(numberOfThreads)
     {
-      int p = 0;
-#ifdef _OPENMP
-      p = omp_get_thread_num();
-#endif
-      viennahrle::Index<D> startVector =
-          (p == 0) ? grid.getMinGridPoint()
-                   : topDomain.getSegmentation()[p - 1];
-
-      viennahrle::Index<D> endVector =
-          (p != static_cast<int>(topDomain.getNumberOfSegments() - 1))
-              ? topDomain.getSegmentation()[p]
-              : grid.incrementIndices(grid.getMaxGridPoint());
-
       double tempMaxTimeStep = maxTimeStep;
-      // store the rates and value of underneath LS for this segment
-      auto &rates = storedRates[p];
-      rates.reserve(
-          topDomain.getNumberOfPoints() /
-              static_cast<double>((levelSets.back())->getNumberOfSegments()) +
-          10);
+      // if the rates are not stored, only keep the rates of the current point
+      std::vector<std::pair<std::pair<T, T>, T>> pointRates;
+      IndexRegion<D> movedPoints;
+      std::vector<std::pair<FrozenEntryType, double>> localCandidates;
 
       // an iterator for each level set
       std::vector<ConstSparseIterator> iterators;
       for (auto const &ls : levelSets) {
-        iterators.emplace_back(ls->getDomain());
+        iterators.emplace_back(std::as_const(*ls).getDomain());
       }
 
       DiscretizationSchemeType scheme(spatialScheme);
+      scheme.setVelocityCache(cache);
+
+      // calculates the rates of one active point, using the result of the
+      // scheme for the top material if it was evaluated in a batch
+      auto processPoint = [&](const viennahrle::Index<D> &indices,
+                              unsigned long pointId, T value, bool isVoid,
+                              const FrozenRateType *frozenRate,
+                              const std::pair<T, T> *topRate,
+                              std::vector<std::pair<std::pair<T, T>, T>>
+                                  &rates) {
+        if (!storeRates)
+          rates.clear();
+
+        const auto firstRate = rates.size();
+        double maxStepTime = std::numeric_limits<double>::max();
+        if (frozenRate != nullptr) {
+          // the time step limit of the point was checked when it was frozen
+          rates.push_back(*frozenRate);
+        } else {
+          maxStepTime = calculatePointRates(scheme, iterators, indices, pointId,
+                                            value, isVoid, rates, topRate);
+          // points passing through several materials are never frozen
+          if (freezeRates && rates.size() == firstRate + 1)
+            localCandidates.emplace_back(FrozenEntryType(indices, rates.back()),
+                                         maxStepTime);
+        }
 
-      for (ConstSparseIterator it(topDomain, startVector);
-           it.getStartIndices() < endVector; it.next()) {
-
-        if (!it.isDefined() || std::abs(it.getValue()) > integrationCutoff)
-          continue;
+        // the point moves if any of its rates has a non-zero velocity
+        if (trackChanges &&
+            std::any_of(rates.begin() + firstRate, rates.end(),
+                        [](const auto &rate) {
+                          return rate.first.first != rate.first.second;
+                        }))
+          movedPoints.insert(indices);
 
-        T value = it.getValue();
-        double maxStepTime = 0;
-        double cfl = timeStepRatio;
-
-        for (int currentLevelSetId = levelSets.size() - 1;
-             currentLevelSetId >= 0; --currentLevelSetId) {
-
-          std::pair<T, T> gradNDissipation;
-
-          if (!(ignoreVoidPoints && (*voidMarkerPointer)[it.getPointId()])) {
-            // check if there is any other levelset at the same point:
-            // if yes, take the velocity of the lowest levelset
-            for (unsigned lowerLevelSetId = 0;
-                 lowerLevelSetId < levelSets.size(); ++lowerLevelSetId) {
-              // put iterator to same position as the top levelset
-              iterators[lowerLevelSetId].goToIndicesSequential(
-                  it.getStartIndices());
-
-              // if the lower surface is actually outside, i.e. its LS value
-              // is lower or equal
-              if (iterators[lowerLevelSetId].getValue() <=
-                  value + wrappingLayerEpsilon) {
-                gradNDissipation =
-                    scheme(it.getStartIndices(), lowerLevelSetId);
-                break;
-              }
+        if (maxStepTime < tempMaxTimeStep)
+          tempMaxTimeStep = maxStepTime;
+      };
+
+      // With batched evaluation, the points are kept until the scheme has to
+      // be evaluated for a full batch of them. The rates are then calculated
+      // in the order of the points, so they are stored in the same order.
+      struct PendingPoint {
+        viennahrle::Index<D> indices;
+        unsigned long pointId;
+        T value;
+        bool isVoid;
+        const FrozenRateType *frozenRate;
+        bool inBatch;
+      };
+      std::vector<PendingPoint> pendingPoints;
+      std::array<viennahrle::Index<D>, batchSize> batchIndices;
+      std::array<int, batchSize> batchMaterials;
+      std::array<std::pair<T, T>, batchSize> batchRates;
+      unsigned batchCount = 0;
+
+      auto processPendingPoints =
+          [&](std::vector<std::pair<std::pair<T, T>, T>> &rates) {
+            if constexpr (lsInternal::HasBatchEvaluation<
+                              DiscretizationSchemeType>::value) {
+              if (batchCount > 0)
+                scheme.evaluateBatch(batchIndices.data(),
+                                     batchMaterials.data(), batchCount,
+                                     batchRates.data());
+            }
+            unsigned batchId = 0;
+            for (const auto &point : pendingPoints) {
+              processPoint(point.indices, point.pointId, point.value,
+                           point.isVoid, point.frozenRate,
+                           point.inBatch ? &batchRates[batchId++] : nullptr,
+                           rates);
             }
+            pendingPoints.clear();
+            batchCount = 0;
+          };
+
+      auto integrateRange = [&](const viennahrle::Index<D> &startVector,
+                                const viennahrle::Index<D> &endVector,
+                                std::vector<std::pair<std::pair<T, T>, T>>
+                                    &rates) {
+        auto frozenCursor = frozenRates.getCursor(startVector);
+        auto staticCursor = materialIndices.getStaticRunCursor(startVector);
+        for (ConstSparseIterator it(topDomain, startVector);
+             it.getStartIndices() < endVector; it.next()) {
+
+          if (!it.isDefined() || std::abs(it.getValue()) > integrationCutoff)
+            continue;
+
+          // static points keep their value and have no rates, so the whole
+          // run is skipped
+          if (const auto *run = staticCursor.find(it.getStartIndices())) {
+            it.goToIndicesSequential(run->second);
+            continue;
           }
 
-          T velocity = gradNDissipation.first - gradNDissipation.second;
-          if (velocity > 0.) {
-            // Case 1: Growth / Deposition (Velocity > 0)
-            // Limit the time step based on the standard CFL condition.
-            maxStepTime += cfl / velocity;
-            rates.emplace_back(gradNDissipation,
-                               -std::numeric_limits<T>::max());
-            break;
-          } else if (velocity == 0.) {
-            // Case 2: Static (Velocity == 0)
-            // No time step limit imposed by this point.
-            maxStepTime = std::numeric_limits<T>::max();
-            rates.emplace_back(gradNDissipation, std::numeric_limits<T>::max());
-            break;
-          } else {
-            // Case 3: Etching (Velocity < 0)
-            // Retrieve the interface location of the underlying material.
-            T valueBelow;
-            if (currentLevelSetId > 0) {
-              iterators[currentLevelSetId - 1].goToIndicesSequential(
-                  it.getStartIndices());
-              valueBelow = iterators[currentLevelSetId - 1].getValue();
-            } else {
-              valueBelow = std::numeric_limits<T>::max();
-            }
-            // Calculate the top material thickness
-            T difference = std::abs(valueBelow - value);
-
-            if (difference >= cfl) {
-              // Sub-case 3a: Standard Advection
-              // Far from interface: Use full CFL time step.
-              maxStepTime -= cfl / velocity;
-              rates.emplace_back(gradNDissipation,
-                                 std::numeric_limits<T>::max());
-              break;
-            } else {
-              // Sub-case 3b: Interface Interaction
-              // Use adaptiveFactor as threshold.
-              if (useAdaptiveTimeStepping &&
-                  difference > adaptiveFactor * cfl) {
-                // Adaptive Sub-stepping:
-                // Approaching boundary: Force small steps to gather
-                // flux statistics and prevent numerical overshoot ("Soft
-                // Landing").
-                maxStepTime -= adaptiveFactor * cfl / velocity;
-                rates.emplace_back(gradNDissipation,
-                                   std::numeric_limits<T>::max());
-                break;
-              } else {
-                // Terminal Step:
-                // Within tolerance: Snap to boundary, consume budget, and
-                // switch material.
-                cfl -= difference;
-                value = valueBelow;
-                maxStepTime -= difference / velocity;
-                rates.emplace_back(gradNDissipation, valueBelow);
-              }
-            }
+          const auto *frozenRate =
+              multirate ? frozenCursor.find(it.getStartIndices()) : nullptr;
+          const bool isVoid =
+              ignoreVoidPoints && (*voidMarkerPointer)[it.getPointId()];
+
+          if (!batched) {
+            processPoint(it.getStartIndices(), it.getPointId(), it.getValue(),
+                         isVoid, frozenRate, nullptr, rates);
+            continue;
           }
-        }
 
-        if (maxStepTime < tempMaxTimeStep)
-          tempMaxTimeStep = maxStepTime;
+          // only the top material of moving points is evaluated in batches
+          const int material = materialIndices.getMaterial(it.getPointId());
+          const bool inBatch = frozenRate == nullptr && !isVoid;
+          pendingPoints.push_back({it.getStartIndices(), it.getPointId(),
+                                   it.getValue(), isVoid, frozenRate, inBatch});
+          if (inBatch) {
+            batchIndices[batchCount] = it.getStartIndices();
+            batchMaterials[batchCount] = material;
+            if (++batchCount == batchSize)
+              processPendingPoints(rates);
+          }
+        }
+        processPendingPoints(rates);
+      };
+
+      if (chunkScheduler) {
+        chunkScheduler->processChunks([&](unsigned chunk) {
+          integrateRange(chunkScheduler->getStartIndices(chunk),
+                         chunkScheduler->getEndIndices(chunk),
+                         storeRates ? chunkRates[chunk] : pointRates);
+        });
+      } else {
+        int p = 0;
+#ifdef _OPENMP
+        p = omp_get_thread_num();
+#endif
+        viennahrle::Index<D> startVector =
+            (p == 0) ? grid.getMinGridPoint()
+                     : topDomain.getSegmentation()[p - 1];
+
+        viennahrle::Index<D> endVector =
+            (p != static_cast<int>(topDomain.getNumberOfSegments() - 1))
+                ? topDomain.getSegmentation()[p]
+                : grid.incrementIndices(grid.getMaxGridPoint());
+
+        // store the rates and value of underneath LS for this segment
+        auto &rates = storeRates ? storedRates[p] : pointRates;
+        if (storeRates)
+          rates.reserve(topDomain.getNumberOfPoints() /
+                            static_cast<double>(
+                                (levelSets.back())->getNumberOfSegments()) +
+                        10);
+
+        integrateRange(startVector, endVector, rates);
       }
 
 #pragma omp critical
@@ -603,84 +1211,361 @@ template <class T, int D> class Advect {
         // set global timestep maximum
         if (tempMaxTimeStep < maxTimeStep)
           maxTimeStep = tempMaxTimeStep;
+
+        changedRegion.insert(movedPoints);
+        freezeCandidates.insert(freezeCandidates.end(),
+                                localCandidates.begin(), localCandidates.end());
       }
     } // end of parallel section
 
+    if (chunkScheduler && storeRates) {
+#pragma omp parallel num_threads(topDomain.getNumberOfSegments())
+      {
+        int p = 0;
+#ifdef _OPENMP
+        p = omp_get_thread_num();
+#endif
+        std::size_t numberOfRates = 0;
+        for (unsigned chunk = chunkScheduler->getFirstChunk(p);
+             chunk < chunkScheduler->getLastChunk(p); ++chunk) {
+          numberOfRates += chunkRates[chunk].size();
+        }
+        storedRates[p].reserve(numberOfRates);
+        for (unsigned chunk = chunkScheduler->getFirstChunk(p);
+             chunk < chunkScheduler->getLastChunk(p); ++chunk) {
+          storedRates[p].insert(storedRates[p].end(), chunkRates[chunk].begin(),
+                                chunkRates[chunk].end());
+        }
+      }
+    }
+
+    if (multirate) {
+      if (!freezeRates) {
+        // the frozen rates are only valid for a limited time
+        maxTimeStep = std::min(maxTimeStep, frozenRates.getRemainingTime());
+        frozenRates.advance(maxTimeStep);
+      } else if (maxTimeStep < std::numeric_limits<double>::max()) {
+        // a point is slow if it could take multirateSubcycles steps of the
+        // current size with its rate
+        std::vector<FrozenEntryType> slowPoints;
+        for (auto &[entry, pointTimeStep] : freezeCandidates) {
+          if (pointTimeStep >= multirateSubcycles * maxTimeStep)
+            slowPoints.push_back(std::move(entry));
+        }
+        frozenRates.freeze(std::move(slowPoints),
+                           (multirateSubcycles - 1) * maxTimeStep,
+                           multirateSubcycles - 1);
+      }
+    }
+
     // maxTimeStep is now the maximum time step possible for all points
     // and rates are stored in a vector
     return maxTimeStep;
   }
 
-  /// This function applies the discretization scheme and calculates the rates
-  /// and the maximum time step, but it does **not** move the surface.
-  void computeRates(double maxTimeStep = std::numeric_limits<double>::max()) {
-    prepareLS();
+  /// Fused version of integrateTime and updateLevelSet, which does not store
+  /// any rates. The rates of each active point are calculated again and
+  /// applied directly while the top level set is reduced to a single layer.
+  /// The time step dt must have been determined beforehand, usually by
+  /// calling integrateTime without storing rates.
+  template <class DiscretizationSchemeType>
+  void updateLevelSetFused(DiscretizationSchemeType spatialScheme, double dt) {
+    if (timeStepRatio >= 0.5) {
+      VIENNACORE_LOG_WARNING(
+          "Integration time step ratio should be smaller than 0.5. "
+          "Advection might fail!");
+    }
+
+    assert(dt >= 0. && "No time step set!");
+
+    const auto &topDomain = std::as_const(*levelSets.back()).getDomain();
+    auto &grid = levelSets.back()->getGrid();
+    auto &newDomain = levelSets.back()->getBufferDomain();
+
+    // markers were already set when the time step was calculated
+    auto voidMarkerPointer = getVoidPointMarkers(false);
+    const bool ignoreVoidPoints = voidMarkerPointer != nullptr;
+    // velocities were cached before the scheme was created
+    const auto *cache = velocityCache.empty() ? nullptr : &velocityCache;
+
+    // DO NOT CHANGE SEGMENTATION HERE, same as reducing the level set. With
+    // work stealing, each chunk is written to its own segment instead.
+    if (chunkScheduler) {
+      chunkScheduler->restart();
+      newDomain.initialize(chunkScheduler->getSegmentation(),
+                           topDomain.getAllocation());
+    } else {
+      newDomain.initialize(topDomain.getSegmentation(),
+                           topDomain.getAllocation());
+    }
+
+    std::vector<std::vector<unsigned>> newDataSourceIds(
+        newDomain.getNumberOfSegments());
+
+    const bool saveVelocities = saveAdvectionVelocities;
+    std::vector<std::vector<double>> dissipationVectors(
+        newDomain.getNumberOfSegments());
+    std::vector<std::vector<double>> velocityVectors(
+        newDomain.getNumberOfSegments());
+
+    const bool checkDiss = checkDissipation;
+
+    const unsigned numberOfThreads = chunkScheduler
+                                         ? chunkScheduler->getNumberOfThreads()
+                                         : newDomain.getNumberOfSegments();
+
+#pragma omp parallel num_threads(numberOfThreads)
+    {
+      // an iterator for each level set
+      std::vector<ConstSparseIterator> iterators;
+      for (auto const &ls : levelSets) {
+        iterators.emplace_back(std::as_const(*ls).getDomain());
+      }
+
+      DiscretizationSchemeType scheme(spatialScheme);
+      scheme.setVelocityCache(cache);
+
+      // rates of the current point only
+      std::vector<std::pair<std::pair<T, T>, T>> pointRates;
+
+      auto updateSegment = [&](unsigned p) {
+        auto &domainSegment = newDomain.getDomainSegment(p);
+
+        viennahrle::Index<D> startVector =
+            (p == 0) ? grid.getMinGridPoint()
+                     : newDomain.getSegmentation()[p - 1];
+
+        viennahrle::Index<D> endVector =
+            (p != newDomain.getNumberOfSegments() - 1)
+                ? newDomain.getSegmentation()[p]
+                : grid.incrementIndices(grid.getMaxGridPoint());
+
+        auto staticCursor = materialIndices.getStaticRunCursor(startVector);
+        for (ConstSparseIterator it(topDomain, startVector);
+             it.getStartIndices() < endVector; it.next()) {
+          T value = it.getValue();
+
+          if (!it.isDefined() || std::abs(value) > integrationCutoff) {
+            domainSegment.insertNextUndefinedPoint(
+                it.getStartIndices(), (value < 0) ? Domain<T, D>::NEG_VALUE
+                                                  : Domain<T, D>::POS_VALUE);
+            continue;
+          }
+
+          // static points keep their value
+          T rate = 0.;
+          T dissipation = 0.;
+          if (staticCursor.find(it.getStartIndices()) == nullptr) {
+            pointRates.clear();
+            const bool isVoid =
+                ignoreVoidPoints && (*voidMarkerPointer)[it.getPointId()];
+            calculatePointRates(scheme, iterators, it.getStartIndices(),
+                                it.getPointId(), value, isVoid, pointRates);
+
+            auto itRS = pointRates.cbegin();
+            rate = applyPointRates(value, dt, itRS, checkDiss, dissipation);
+          }
+
+          domainSegment.insertNextDefinedPoint(it.getStartIndices(), value);
+          newDataSourceIds[p].push_back(it.getPointId());
+
+          if (saveVelocities) {
+            velocityVectors[p].push_back(rate);
+            dissipationVectors[p].push_back(dissipation);
+          }
+        }
+      };
+
+      if (chunkScheduler) {
+        chunkScheduler->processChunks(updateSegment);
+      } else {
+        int p = 0;
+#ifdef _OPENMP
+        p = omp_get_thread_num();
+#endif
+        updateSegment(p);
+      }
+    } // end of parallel section
+
+    typename Domain<T, D>::PointDataType newPointData;
+    newPointData.translateFromMultiData(
+        std::as_const(*levelSets.back()).getPointData(), newDataSourceIds);
+
+    newDomain.finalize();
+    // join the chunks into one segment per thread again
+    if (chunkScheduler)
+      newDomain.segment();
+    levelSets.back()->swapBuffer(std::move(newPointData));
+    levelSets.back()->finalize(1);
+
+    // cached velocities refer to the old point ids
+    velocityCache.clear();
+    dissipationCache.clear();
+    materialIndices.clear();
+    chunkScheduler.reset();
+
+    if (saveVelocities) {
+      auto &pointData = levelSets.back()->getPointData();
+
+      typename PointData<T>::ScalarDataType vels;
+      typename PointData<T>::ScalarDataType diss;
+
+      for (unsigned i = 0; i < velocityVectors.size(); ++i) {
+        vels.insert(vels.end(),
+                    std::make_move_iterator(velocityVectors[i].begin()),
+                    std::make_move_iterator(velocityVectors[i].end()));
+        diss.insert(diss.end(),
+                    std::make_move_iterator(dissipationVectors[i].begin()),
+                    std::make_move_iterator(dissipationVectors[i].end()));
+      }
+      pointData.insertReplaceScalarData(std::move(vels), velocityLabel);
+      pointData.insertReplaceScalarData(std::move(diss), dissipationLabel);
+    }
+  }
+
+  /// Prepares the dissipation cache for the current top level set and returns
+  /// it, or returns nullptr if dissipation coefficients should not be cached.
+  lsInternal::DissipationCache<T, D> *prepareDissipationCache() {
+    if (!cacheDissipation) {
+      dissipationCache.clear();
+      return nullptr;
+    }
+    dissipationCache.reset(levelSets.back()->getNumberOfPoints());
+    return &dissipationCache;
+  }
+
+  /// Calls function with an instance of the selected spatial discretization
+  /// scheme for the top level set and returns its result. If the function
+  /// evaluates the scheme in several passes, cacheAllVelocities can be set
+  /// so the velocity field is only queried once.
+  template <class SchemeFunction>
+  double applySpatialScheme(SchemeFunction &&function,
+                            bool cacheAllVelocities = false) {
+    // split the active points into chunks once for all passes of the scheme
+    chunkScheduler.reset();
+    if (workStealing) {
+      chunkScheduler.emplace(std::as_const(*levelSets.back()).getDomain(),
+                             [cutoff = integrationCutoff](const auto &it) {
+                               return it.isDefined() &&
+                                      std::abs(it.getValue()) <= cutoff;
+                             });
+    }
+
+    // find the exposed material of each active point once for all passes
+    findStaticMaterials();
+    materialIndices.build(levelSets, integrationCutoff, wrappingLayerEpsilon,
+                          staticMaterials);
+
+    // the velocities are evaluated once for all passes of the scheme, if
+    // they are cached
+    const auto cachedAlphas = updateVelocityCache(cacheAllVelocities);
+
     if (spatialScheme == SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER) {
-      auto is = lsInternal::EngquistOsher<T, D, 1>(levelSets.back(), velocities,
-                                                   calculateNormalVectors);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      auto is = lsInternal::EngquistOsher<T, D, 1, VelocityType>(
+          levelSets.back(), velocities, calculateNormalVectors);
+      return function(is);
     } else if (spatialScheme == SpatialSchemeEnum::ENGQUIST_OSHER_2ND_ORDER) {
-      auto is = lsInternal::EngquistOsher<T, D, 2>(levelSets.back(), velocities,
-                                                   calculateNormalVectors);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      auto is = lsInternal::EngquistOsher<T, D, 2, VelocityType>(
+          levelSets.back(), velocities, calculateNormalVectors);
+      return function(is);
     } else if (spatialScheme == SpatialSchemeEnum::LAX_FRIEDRICHS_1ST_ORDER) {
-      auto alphas = findGlobalAlphas();
-      auto is = lsInternal::LaxFriedrichs<T, D, 1>(levelSets.back(), velocities,
-                                                   dissipationAlpha, alphas,
-                                                   calculateNormalVectors);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      auto alphas = velocityCache.empty() ? findGlobalAlphas() : cachedAlphas;
+      auto is = lsInternal::LaxFriedrichs<T, D, 1, VelocityType>(
+          levelSets.back(), velocities, dissipationAlpha, alphas,
+          calculateNormalVectors);
+      return function(is);
     } else if (spatialScheme == SpatialSchemeEnum::LAX_FRIEDRICHS_2ND_ORDER) {
-      auto alphas = findGlobalAlphas();
-      auto is = lsInternal::LaxFriedrichs<T, D, 2>(levelSets.back(), velocities,
-                                                   dissipationAlpha, alphas,
-                                                   calculateNormalVectors);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      auto alphas = velocityCache.empty() ? findGlobalAlphas() : cachedAlphas;
+      auto is = lsInternal::LaxFriedrichs<T, D, 2, VelocityType>(
+          levelSets.back(), velocities, dissipationAlpha, alphas,
+          calculateNormalVectors);
+      return function(is);
     } else if (spatialScheme ==
                SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_ANALYTICAL_1ST_ORDER) {
-      auto is = lsInternal::LocalLaxFriedrichsAnalytical<T, D, 1>(
+      auto is = lsInternal::LocalLaxFriedrichsAnalytical<T, D, 1, VelocityType>(
           levelSets.back(), velocities);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      return function(is);
     } else if (spatialScheme ==
                SpatialSchemeEnum::LOCAL_LOCAL_LAX_FRIEDRICHS_1ST_ORDER) {
-      auto is = lsInternal::LocalLocalLaxFriedrichs<T, D, 1>(
+      auto is = lsInternal::LocalLocalLaxFriedrichs<T, D, 1, VelocityType>(
           levelSets.back(), velocities, dissipationAlpha);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      return function(is);
     } else if (spatialScheme ==
                SpatialSchemeEnum::LOCAL_LOCAL_LAX_FRIEDRICHS_2ND_ORDER) {
-      auto is = lsInternal::LocalLocalLaxFriedrichs<T, D, 2>(
+      auto is = lsInternal::LocalLocalLaxFriedrichs<T, D, 2, VelocityType>(
           levelSets.back(), velocities, dissipationAlpha);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      return function(is);
     } else if (spatialScheme ==
                SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_1ST_ORDER) {
-      auto is = lsInternal::LocalLaxFriedrichs<T, D, 1>(
+      auto is = lsInternal::LocalLaxFriedrichs<T, D, 1, VelocityType>(
           levelSets.back(), velocities, dissipationAlpha);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      is.setDissipationCache(prepareDissipationCache());
+      return function(is);
     } else if (spatialScheme ==
                SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_2ND_ORDER) {
-      auto is = lsInternal::LocalLaxFriedrichs<T, D, 2>(
+      auto is = lsInternal::LocalLaxFriedrichs<T, D, 2, VelocityType>(
           levelSets.back(), velocities, dissipationAlpha);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      is.setDissipationCache(prepareDissipationCache());
+      return function(is);
     } else if (spatialScheme ==
                SpatialSchemeEnum::STENCIL_LOCAL_LAX_FRIEDRICHS_1ST_ORDER) {
-      auto is = lsInternal::StencilLocalLaxFriedrichsScalar<T, D, 1>(
+      auto is = lsInternal::StencilLocalLaxFriedrichsScalar<
+          T, D, 1, lsInternal::DifferentiationSchemeEnum::FIRST_ORDER,
+          VelocityType>(
           levelSets.back(), velocities, dissipationAlpha);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      is.setDissipationCache(prepareDissipationCache());
+      return function(is);
     } else if (spatialScheme == SpatialSchemeEnum::WENO_3RD_ORDER) {
       // Instantiate WENO with order 3
-      auto is = lsInternal::WENO<T, D, 3>(levelSets.back(), velocities,
-                                          dissipationAlpha);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      auto is = lsInternal::WENO<T, D, 3, VelocityType>(
+          levelSets.back(), velocities, calculateNormalVectors);
+      return function(is);
     } else if (spatialScheme == SpatialSchemeEnum::WENO_5TH_ORDER) {
       // Instantiate WENO with order 5
-      auto is = lsInternal::WENO<T, D, 5>(levelSets.back(), velocities,
-                                          dissipationAlpha);
-      currentTimeStep = integrateTime(is, maxTimeStep);
+      auto is = lsInternal::WENO<T, D, 5, VelocityType>(
+          levelSets.back(), velocities, calculateNormalVectors);
+      return function(is);
     } else {
       VIENNACORE_LOG_ERROR("Advect: Discretization scheme not found.");
-      currentTimeStep = -1.;
+      return -1.;
     }
   }
 
+  /// This function applies the discretization scheme and calculates the rates
+  /// and the maximum time step, but it does **not** move the surface.
+  void computeRates(double maxTimeStep = std::numeric_limits<double>::max()) {
+    waitForVelocityPreparation();
+    prepareLS();
+    prepareVelocities();
+    currentTimeStep = applySpatialScheme(
+        [&](auto &scheme) { return integrateTime(scheme, maxTimeStep); });
+    velocities->finalize();
+    if (timeStepReduction)
+      currentTimeStep = timeStepReduction(currentTimeStep);
+  }
+
+  /// Same as calling computeRates and updateLevelSet, but the rates are not
+  /// stored. The maximum time step is calculated first and the rates are then
+  /// recalculated point by point and applied directly to the level set. The
+  /// velocities are cached for both passes, so the velocity field is only
+  /// queried once per point.
+  void computeAndApplyRates(
+      double maxTimeStep = std::numeric_limits<double>::max()) {
+    waitForVelocityPreparation();
+    prepareLS();
+    prepareVelocities();
+    currentTimeStep = applySpatialScheme(
+        [&](auto &scheme) {
+          double dt = integrateTime(scheme, maxTimeStep, false);
+          if (timeStepReduction)
+            dt = timeStepReduction(dt);
+          updateLevelSetFused(scheme, dt);
+          return dt;
+        },
+        true);
+    velocities->finalize();
+  }
+
   // Level Sets below are also considered in order to adjust the advection
   // depth accordingly if there would be a material change.
   void updateLevelSet(double dt) {
@@ -690,15 +1575,16 @@ template <class T, int D> class Advect {
           "Advection might fail!");
     }
 
+    // reduce to one layer thickness and apply new values directly to the
+    // domain segments --> DO NOT CHANGE SEGMENTATION HERE (true parameter)
+    Reduce<T, D>(levelSets.back(), 1, true).apply();
+    // the values are changed in place
     auto &topDomain = levelSets.back()->getDomain();
+    auto &grid = levelSets.back()->getGrid();
 
     assert(dt >= 0. && "No time step set!");
     assert(storedRates.size() == topDomain.getNumberOfSegments());
 
-    // reduce to one layer thickness and apply new values directly to the
-    // domain segments --> DO NOT CHANGE SEGMENTATION HERE (true parameter)
-    Reduce<T, D>(levelSets.back(), 1, true).apply();
-
     const bool saveVelocities = saveAdvectionVelocities;
     std::vector<std::vector<double>> dissipationVectors(
         levelSets.back()->getNumberOfSegments());
@@ -722,58 +1608,42 @@ template <class T, int D> class Advect {
         dissipationVectors[p].resize(maxId);
       }
 
-      for (unsigned localId = 0; localId < maxId; ++localId) {
-        T &value = segment.definedValues[localId];
+      viennahrle::Index<D> startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : topDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> endVector =
+          (p != static_cast<int>(topDomain.getNumberOfSegments() - 1))
+              ? topDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      // the defined points of the segment are visited in the order of their
+      // local ids
+      auto staticCursor = materialIndices.getStaticRunCursor(startVector);
+      unsigned localId = 0;
+      for (ConstSparseIterator it(std::as_const(topDomain), startVector);
+           it.getStartIndices() < endVector; it.next()) {
+        if (!it.isDefined())
+          continue;
+
+        const unsigned pointLocalId = localId++;
+        T &value = segment.definedValues[pointLocalId];
 
         // Skip points that were not part of computeRates (outer layers)
         if (std::abs(value) > integrationCutoff)
           continue;
 
-        double time = dt;
-
-        // if there is a change in materials during one time step, deduct
-        // the time taken to advect up to the end of the top material and
-        // set the LS value to the one below
-        auto const [gradient, dissipation] = itRS->first;
-        T velocity = gradient - dissipation;
-        // check if dissipation is too high and would cause a change in
-        // direction of the velocity
-        if (checkDiss && (gradient < 0 && velocity > 0) ||
-            (gradient > 0 && velocity < 0)) {
-          velocity = 0;
-        }
-
-        T rate = time * velocity;
-        while (std::abs(itRS->second - value) < std::abs(rate)) {
-          time -= std::abs((itRS->second - value) / velocity);
-          value = itRS->second;
-          ++itRS; // advance the TempStopRates iterator by one
-
-          // recalculate velocity and rate
-          velocity = itRS->first.first - itRS->first.second;
-          if (checkDiss && (itRS->first.first < 0 && velocity > 0) ||
-              (itRS->first.first > 0 && velocity < 0)) {
-            velocity = 0;
-          }
-          rate = time * velocity;
-        }
+        // static points keep their value and have no rates
+        if (staticCursor.find(it.getStartIndices()) != nullptr)
+          continue;
 
-        // now deduct the velocity times the time step we take
-        value -= rate;
+        T dissipation;
+        T rate = applyPointRates(value, dt, itRS, checkDiss, dissipation);
 
         if (saveVelocities) {
-          velocityVectors[p][localId] = rate;
-          dissipationVectors[p][localId] = itRS->first.second;
+          velocityVectors[p][pointLocalId] = rate;
+          dissipationVectors[p][pointLocalId] = dissipation;
         }
-
-        // this is run when two materials are close but the velocity is too slow
-        // to actually reach the second material, to get rid of the extra
-        // entry in the TempRatesStop
-        while (std::abs(itRS->second) != std::numeric_limits<T>::max())
-          ++itRS;
-
-        // advance the TempStopRates iterator by one
-        ++itRS;
       }
     } // end of parallel section
 
@@ -797,35 +1667,133 @@ template <class T, int D> class Advect {
 
     // clear the stored rates since surface has changed
     storedRates.clear();
+    velocityCache.clear();
+    dissipationCache.clear();
+    materialIndices.clear();
+    chunkScheduler.reset();
+  }
+
+  /// Starts preparing the velocities of the top level set asynchronously,
+  /// so the velocity field works on it while the current time step is
+  /// finished.
+  void startVelocityPreparation() {
+    if (!asyncVelocityPreparation || velocities == nullptr)
+      return;
+
+    // a preparation which was not used must still finish before the next
+    // one is started
+    if (velocityPreparation.valid())
+      velocityPreparation.wait();
+
+    // the velocity field gets its own level set, since the top level set is
+    // expanded and changed by Advect in the meantime. It starts as a
+    // snapshot, whose values are replaced by the expansion without copying
+    // them. Since it is read on another thread, it must not share the
+    // values of the top level set anymore, so they are only copied if the
+    // top level set was wide enough already.
+    auto levelSet = Domain<T, D>::New(levelSets.back()->getGrid());
+    levelSet->deepCopyOnWrite(levelSets.back());
+    prepareLS(levelSet);
+    if (levelSet->isSharingValues())
+      levelSet->deepCopy(levelSets.back());
+    launchVelocityPreparation(levelSet);
+  }
+
+  /// Waits until the velocities of the top level set are prepared. If the
+  /// preparation was not started for the current top level set, e.g. for the
+  /// later stages of a Runge-Kutta scheme, there is nothing to overlap it
+  /// with, so the top level set is prepared and passed directly.
+  void waitForVelocityPreparation() {
+    if (!asyncVelocityPreparation || velocities == nullptr)
+      return;
+
+    if (preparedVersion != levelSets.back()->getVersion() ||
+        preparedVelocities != velocities.get()) {
+      if (velocityPreparation.valid())
+        velocityPreparation.wait();
+      prepareLS();
+      auto levelSet = Domain<T, D>::New(levelSets.back()->getGrid());
+      levelSet->deepCopyOnWrite(levelSets.back());
+      launchVelocityPreparation(levelSet);
+    }
+    // rethrows exceptions thrown during the preparation
+    if (velocityPreparation.valid())
+      velocityPreparation.get();
+    velocityPreparation = std::shared_future<void>();
+    preparedVersion = 0;
+  }
+
+  void launchVelocityPreparation(SmartPointer<Domain<T, D>> levelSet) {
+    if constexpr (D == 2)
+      velocityPreparation = velocities->prepareAsync2D(levelSet).share();
+    else
+      velocityPreparation = velocities->prepareAsync3D(levelSet).share();
+    preparedVersion = levelSets.back()->getVersion();
+    preparedVelocities = velocities.get();
+  }
+
+  /// Lets the velocity field prepare the velocities of the current time step
+  /// or Runge-Kutta stage.
+  void prepareVelocities() {
+    const double time = stepStartTime + stageTimeOffset;
+    if constexpr (D == 2)
+      velocities->prepare2D(levelSets, currentStage, time);
+    else
+      velocities->prepare3D(levelSets, currentStage, time);
   }
 
   void adjustLowerLayers() {
+    // the top level set of this step or stage is final, so the velocities
+    // for the next one can be prepared while the lower level sets are
+    // adjusted
+    startVelocityPreparation();
+
     // Adjust all level sets below the advected one
     if (spatialScheme !=
         viennals::SpatialSchemeEnum::STENCIL_LOCAL_LAX_FRIEDRICHS_1ST_ORDER) {
+      // If the lower level sets were adjusted to the top level set at the
+      // start of this time step, they can only change where the top level
+      // set has changed since then.
+      IndexRegion<D> region;
+      if (restrictLayerAdjustment && lowerLayersAdjustedAtStepStart) {
+        if (changedRegion.empty()) {
+          lowerLayersAdjusted = true;
+          return;
+        }
+        region = changedRegion;
+        region.expand(changedRegionMargin, levelSets.back()->getGrid());
+      }
+
       for (unsigned i = 0; i < levelSets.size() - 1; ++i) {
-        viennals::BooleanOperation<T, D>(
+        viennals::BooleanOperation<T, D> booleanOperation(
             levelSets[i], levelSets.back(),
-            viennals::BooleanOperationEnum::INTERSECT)
-            .apply();
+            viennals::BooleanOperationEnum::INTERSECT);
+        booleanOperation.setRegion(region);
+        booleanOperation.apply();
       }
     }
+    lowerLayersAdjusted = true;
   }
 
   /// internal function used as a wrapper to call specialized integrateTime
   /// with the chosen spatial discretization scheme
   double advect(double maxTimeStep) {
+    // all adjustments during a time step are restricted to the points which
+    // moved since its start
+    lowerLayersAdjustedAtStepStart = lowerLayersAdjusted;
+    lowerLayersAdjusted = false;
+    changedRegion.clear();
+
     switch (temporalScheme) {
     case TemporalSchemeEnum::RUNGE_KUTTA_2ND_ORDER:
-      return lsInternal::AdvectTimeIntegration<T, D>::evolveRungeKutta2(
-          *this, maxTimeStep);
+      return TimeIntegration::evolveRungeKutta2(*this, maxTimeStep);
     case TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER:
-      return lsInternal::AdvectTimeIntegration<T, D>::evolveRungeKutta3(
-          *this, maxTimeStep);
+      return TimeIntegration::evolveRungeKutta3(*this, maxTimeStep);
+    case TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER_ADAPTIVE:
+      return TimeIntegration::evolveRungeKutta3Adaptive(*this, maxTimeStep);
     case TemporalSchemeEnum::FORWARD_EULER:
     default:
-      return lsInternal::AdvectTimeIntegration<T, D>::evolveForwardEuler(
-          *this, maxTimeStep);
+      return TimeIntegration::evolveForwardEuler(*this, maxTimeStep);
     }
   }
 
@@ -840,13 +1808,13 @@ public:
   }
 
   Advect(SmartPointer<Domain<T, D>> passedlsDomain,
-         SmartPointer<VelocityField<T>> passedVelocities) {
+         SmartPointer<VelocityType> passedVelocities) {
     levelSets.push_back(passedlsDomain);
     velocities = passedVelocities;
   }
 
   Advect(std::vector<SmartPointer<Domain<T, D>>> passedlsDomains,
-         SmartPointer<VelocityField<T>> passedVelocities)
+         SmartPointer<VelocityType> passedVelocities)
       : levelSets(passedlsDomains) {
     velocities = passedVelocities;
   }
@@ -861,7 +1829,7 @@ public:
 
   /// Set the velocity field used for advection. This should be a concrete
   /// implementation of lsVelocityField
-  void setVelocityField(SmartPointer<VelocityField<T>> passedVelocities) {
+  void setVelocityField(SmartPointer<VelocityType> passedVelocities) {
     velocities = passedVelocities;
   }
 
@@ -898,6 +1866,14 @@ public:
   /// be advected. All others values are not changed.
   void setIgnoreVoids(bool iV) { ignoreVoids = iV; }
 
+  /// Set whether the void points should only be marked again where the sign
+  /// of the top level set changed since the last time step, see
+  /// MarkVoidPoints::setIncremental. Only used if voids are ignored.
+  /// Defaults to false.
+  void setIncrementalVoidDetection(bool incremental) {
+    incrementalVoidDetection = incremental;
+  }
+
   /// Set whether adaptive time stepping should be used
   /// when approaching material boundaries during etching.
   /// Defaults to false.
@@ -911,6 +1887,126 @@ public:
     adaptiveTimeStepSubdivisions = subdivisions;
   }
 
+  /// Set whether multirate time stepping should be used. The rates of points
+  /// which move so slowly that they could take subcycles time steps of the
+  /// size required by the fastest points are then calculated only once and
+  /// reused for up to subcycles time steps, before the rates of all points
+  /// are calculated again. Only the rates of the fast points are calculated
+  /// in between, which saves most of the evaluations of the velocity field
+  /// and the spatial scheme if only a small part of the surface moves fast.
+  /// Points passing through several materials are never frozen. Only used
+  /// with forward Euler time integration and without fused rate updates.
+  /// Defaults to false.
+  void setMultirateTimeStepping(bool multirate = true,
+                                unsigned subcycles = 4) {
+    multirateTimeStepping = multirate;
+    if (subcycles < 1) {
+      VIENNACORE_LOG_WARNING("Advect: Multirate time stepping subcycles must "
+                             "be at least 1. Setting to 1.");
+      subcycles = 1;
+    }
+    multirateSubcycles = subcycles;
+  }
+
+  /// Set whether the rates should be applied to the level set directly
+  /// after they are calculated, instead of storing them for all points
+  /// first. The maximum time step is then found in a separate pass, which
+  /// evaluates the spatial discretization scheme once more, but the rates of
+  /// all points never have to be kept in memory. The velocities are cached
+  /// for both passes, so the velocity field is only queried once per point.
+  /// Only used if rates were not computed beforehand using computeRates().
+  /// Defaults to false.
+  void setFusedRateUpdate(bool fused) { fusedRateUpdate = fused; }
+
+  /// Set whether the Engquist Osher and WENO schemes should be evaluated for
+  /// batches of points at once. The stencils of the points are gathered
+  /// into contiguous buffers, so the differences of all points in a batch
+  /// are calculated with SIMD instructions. The rates only differ from the
+  /// point by point evaluation by rounding. Other schemes are always
+  /// evaluated point by point, as are the lower materials of points passing
+  /// through several materials. Defaults to false.
+  void setBatchedSchemeEvaluation(bool batched) {
+    batchedSchemeEvaluation = batched;
+  }
+
+  /// Set whether the local Lax Friedrichs schemes should calculate the
+  /// dissipation coefficients of each stencil point only once per time step
+  /// and share them between all stencils containing that point. The
+  /// velocity field is then queried with the point id of the defined
+  /// stencil points instead of the id of the stencil center, see
+  /// VelocityField::getScalarVelocity, so this should only be enabled for
+  /// velocity fields which do not depend on the point id or handle it
+  /// accordingly. Defaults to false.
+  void setCacheDissipation(bool cache) { cacheDissipation = cache; }
+
+  /// Set whether the velocities of all active points should be evaluated
+  /// once per time step in a separate pass and cached for the spatial
+  /// scheme. The global Lax Friedrichs schemes then find their dissipation
+  /// coefficients from the cached velocities, instead of querying the
+  /// velocity field in an additional pass. The normal vectors passed to the
+  /// velocity field are always calculated using central differences.
+  /// Velocities are always cached if the velocity field evaluates batches.
+  /// Defaults to false.
+  void setCacheVelocities(bool cache) { cacheVelocities = cache; }
+
+  /// Set whether the Runge-Kutta schemes should evaluate the velocities only
+  /// in the first stage of each time step and reuse them in the later
+  /// stages. This is only correct if the velocity field depends on the
+  /// surface at the start of the time step only, e.g. for expensive flux
+  /// calculations which are constant during a time step. Active points of
+  /// the later stages which were not active in the first stage take the
+  /// velocities of a neighbor. The velocities are always evaluated again if
+  /// a velocity update callback is set. Defaults to false.
+  void setReuseStageVelocities(bool reuse) { reuseStageVelocities = reuse; }
+
+  /// Set whether the active points should be split into many small chunks
+  /// of similar size, which are distributed between the threads using work
+  /// stealing, when evaluating the spatial scheme. This improves the load
+  /// balance if the cost per point differs strongly between segments. The
+  /// time step limit of the local Lax Friedrichs schemes is then found per
+  /// thread from the chunks it processed, so it can differ slightly between
+  /// runs. Defaults to false.
+  void setWorkStealing(bool ws) { workStealing = ws; }
+
+  /// Set whether the level set values outside the interface should be
+  /// replaced by Euclidean distances after each rebuild and after the
+  /// spatial discretization scheme expanded the level set, instead of
+  /// keeping the Manhattan distances. This gives more accurate normal
+  /// vectors and derivatives in the next step at the cost of a few
+  /// additional sweeps over the narrow band. Defaults to false.
+  void setEuclideanReinitialization(bool euclidean) {
+    euclideanReinitialization = euclidean;
+  }
+
+  /// Set whether the level sets below the advected one should only be
+  /// adjusted in the region of the grid in which the top level set moved
+  /// during a time step. Outside of this region, the lower level sets are
+  /// copied instead of being intersected with the top level set again, which
+  /// saves time if only a small part of the surface moves. The first time
+  /// step of each call to apply() always adjusts the whole level sets. With
+  /// Runge-Kutta time integration, values outside of the region may differ
+  /// in the last bits from a full adjustment. Defaults to false.
+  void setRestrictLayerAdjustment(bool restrictAdjustment) {
+    restrictLayerAdjustment = restrictAdjustment;
+  }
+
+  /// Set whether the velocities should be prepared asynchronously by
+  /// VelocityField::prepareAsync2D or prepareAsync3D. The preparation for the
+  /// next time step or Runge-Kutta stage is started as soon as its top level
+  /// set is known and runs while the lower level sets are adjusted to it.
+  /// Advect only waits for it right before the velocities are requested. The
+  /// preparation started after the last time step is used by the next call
+  /// to apply(), unless the level set or the velocity field changed in
+  /// between. Defaults to false.
+  void setAsyncVelocityPreparation(bool async) {
+    asyncVelocityPreparation = async;
+    if (!async && velocityPreparation.valid()) {
+      velocityPreparation.wait();
+      velocityPreparation = std::shared_future<void>();
+      preparedVersion = 0;
+    }
+  }
+
   /// Set whether the velocities applied to each point should be saved in
   /// the level set for debug purposes.
   void setSaveAdvectionVelocities(bool sAV) { saveAdvectionVelocities = sAV; }
@@ -925,6 +2021,13 @@ public:
   /// Get how many advection steps were performed during the last apply() call.
   unsigned getNumberOfTimeSteps() const { return numberOfTimeSteps; }
 
+  /// Get how many time steps were rejected and repeated with a smaller time
+  /// step during the last apply() call, because their estimated error was
+  /// larger than the error tolerance.
+  unsigned getNumberOfRejectedTimeSteps() const {
+    return numberOfRejectedTimeSteps;
+  }
+
   /// Get the value of the CFL number.
   double getTimeStepRatio() const { return timeStepRatio; }
 
@@ -948,6 +2051,12 @@ public:
   /// Set which time integration scheme should be used.
   void setTemporalScheme(TemporalSchemeEnum scheme) { temporalScheme = scheme; }
 
+  /// Set the largest local error of a time step, in grid units, which is
+  /// accepted by TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER_ADAPTIVE. Time
+  /// steps with a larger estimated error are repeated with a smaller time
+  /// step. Defaults to 0.01.
+  void setErrorTolerance(double tolerance) { errorTolerance = tolerance; }
+
   /// Set the alpha dissipation coefficient.
   /// For lsLaxFriedrichs, this is used as the alpha value.
   /// For all other LaxFriedrichs schemes it is used as a
@@ -968,6 +2077,15 @@ public:
     velocityUpdateCallback = callback;
   }
 
+  /// Set a function which is applied to the largest stable time step of
+  /// every time step and Runge-Kutta stage before it is used. It must not
+  /// return a larger time step. This is used to find the smallest time step
+  /// of several advection kernels, e.g. of all processes of a distributed
+  /// advection, so it is called the same number of times by all of them.
+  void setTimeStepReduction(std::function<double(double)> reduction) {
+    timeStepReduction = reduction;
+  }
+
   // Prepare the levelset for advection, based on the provided spatial
   // discretization scheme.
   void prepareLS() {
@@ -977,41 +2095,50 @@ public:
       return;
     }
 
+    prepareLS(levelSets.back());
+  }
+
+  // Prepare the passed level set for advection in the same way, e.g. a copy
+  // of the top level set.
+  void prepareLS(SmartPointer<Domain<T, D>> levelSet) {
+    const int width = levelSet->getLevelSetWidth();
     if (spatialScheme == SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER) {
-      lsInternal::EngquistOsher<T, D, 1>::prepareLS(levelSets.back());
+      lsInternal::EngquistOsher<T, D, 1>::prepareLS(levelSet);
     } else if (spatialScheme == SpatialSchemeEnum::ENGQUIST_OSHER_2ND_ORDER) {
-      lsInternal::EngquistOsher<T, D, 2>::prepareLS(levelSets.back());
+      lsInternal::EngquistOsher<T, D, 2>::prepareLS(levelSet);
     } else if (spatialScheme == SpatialSchemeEnum::LAX_FRIEDRICHS_1ST_ORDER) {
-      lsInternal::LaxFriedrichs<T, D, 1>::prepareLS(levelSets.back());
+      lsInternal::LaxFriedrichs<T, D, 1>::prepareLS(levelSet);
     } else if (spatialScheme == SpatialSchemeEnum::LAX_FRIEDRICHS_2ND_ORDER) {
-      lsInternal::LaxFriedrichs<T, D, 2>::prepareLS(levelSets.back());
+      lsInternal::LaxFriedrichs<T, D, 2>::prepareLS(levelSet);
     } else if (spatialScheme ==
                SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_ANALYTICAL_1ST_ORDER) {
-      lsInternal::LocalLaxFriedrichsAnalytical<T, D, 1>::prepareLS(
-          levelSets.back());
+      lsInternal::LocalLaxFriedrichsAnalytical<T, D, 1>::prepareLS(levelSet);
     } else if (spatialScheme ==
                SpatialSchemeEnum::LOCAL_LOCAL_LAX_FRIEDRICHS_1ST_ORDER) {
-      lsInternal::LocalLocalLaxFriedrichs<T, D, 1>::prepareLS(levelSets.back());
+      lsInternal::LocalLocalLaxFriedrichs<T, D, 1>::prepareLS(levelSet);
     } else if (spatialScheme ==
                SpatialSchemeEnum::LOCAL_LOCAL_LAX_FRIEDRICHS_2ND_ORDER) {
-      lsInternal::LocalLocalLaxFriedrichs<T, D, 2>::prepareLS(levelSets.back());
+      lsInternal::LocalLocalLaxFriedrichs<T, D, 2>::prepareLS(levelSet);
     } else if (spatialScheme ==
                SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_1ST_ORDER) {
-      lsInternal::LocalLaxFriedrichs<T, D, 1>::prepareLS(levelSets.back());
+      lsInternal::LocalLaxFriedrichs<T, D, 1>::prepareLS(levelSet);
     } else if (spatialScheme ==
                SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_2ND_ORDER) {
-      lsInternal::LocalLaxFriedrichs<T, D, 2>::prepareLS(levelSets.back());
+      lsInternal::LocalLaxFriedrichs<T, D, 2>::prepareLS(levelSet);
     } else if (spatialScheme ==
                SpatialSchemeEnum::STENCIL_LOCAL_LAX_FRIEDRICHS_1ST_ORDER) {
-      lsInternal::StencilLocalLaxFriedrichsScalar<T, D, 1>::prepareLS(
-          levelSets.back());
+      lsInternal::StencilLocalLaxFriedrichsScalar<T, D, 1>::prepareLS(levelSet);
     } else if (spatialScheme == SpatialSchemeEnum::WENO_3RD_ORDER) {
-      lsInternal::WENO<T, D, 3>::prepareLS(levelSets.back());
+      lsInternal::WENO<T, D, 3>::prepareLS(levelSet);
     } else if (spatialScheme == SpatialSchemeEnum::WENO_5TH_ORDER) {
-      lsInternal::WENO<T, D, 5>::prepareLS(levelSets.back());
+      lsInternal::WENO<T, D, 5>::prepareLS(levelSet);
     } else {
       VIENNACORE_LOG_ERROR("Advect: Discretization scheme not found.");
     }
+
+    // the layers added by the scheme hold Manhattan distances again
+    if (euclideanReinitialization && levelSet->getLevelSetWidth() != width)
+      Reinitialize<T, D>(levelSet).apply();
   }
 
   void apply() {
@@ -1026,13 +2153,26 @@ public:
       return;
     }
 
+    // the top level set is rebuilt in every time step, so its previous
+    // values are kept as the buffer for the next one until advection ends
+    const bool keepBuffer = levelSets.back()->getKeepBuffer();
+    levelSets.back()->setKeepBuffer(true);
+
+    // the level sets might have been changed since the last call
+    lowerLayersAdjusted = false;
+    errorControlledTimeStep = std::numeric_limits<double>::max();
+    numberOfRejectedTimeSteps = 0;
+    frozenRates.clear();
+
     if (advectionTime == 0.) {
+      stepStartTime = 0.;
       advectedTime = advect(std::numeric_limits<double>::max());
       numberOfTimeSteps = 1;
     } else {
       double currentTime = 0.0;
       numberOfTimeSteps = 0;
       while (currentTime < advectionTime) {
+        stepStartTime = currentTime;
         currentTime += advect(advectionTime - currentTime);
         ++numberOfTimeSteps;
         if (performOnlySingleStep)
@@ -1040,6 +2180,8 @@ public:
       }
       advectedTime = currentTime;
     }
+
+    levelSets.back()->setKeepBuffer(keepBuffer);
   }
 };
 
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
 #include <lsBooleanOperation.hpp>
 #include <lsDomain.hpp>
 
@@ -31,24 +35,50 @@ using IntegrationSchemeEnum [[deprecated("Use SpatialSchemeEnum instead")]] =
 enum class TemporalSchemeEnum : unsigned {
   FORWARD_EULER = 0,
   RUNGE_KUTTA_2ND_ORDER = 1,
-  RUNGE_KUTTA_3RD_ORDER = 2
+  RUNGE_KUTTA_3RD_ORDER = 2,
+  RUNGE_KUTTA_3RD_ORDER_ADAPTIVE = 3
 };
 
 // Forward declaration
-template <class T, int D> class Advect;
+template <class T, int D, class VelocityType> class Advect;
 } // namespace viennals
 
 namespace lsInternal {
 
-template <class T, int D> struct AdvectTimeIntegration {
-  using AdvectType = viennals::Advect<T, D>;
+template <class T, int D, class VelocityType> struct AdvectTimeIntegration {
+  using AdvectType = viennals::Advect<T, D, VelocityType>;
+
+  /// Cleans up after a time step with several stages. The initial level
+  /// sets are not needed anymore, so snapshots still sharing the values of a
+  /// level set must not copy them when the level set is changed later. The
+  /// velocities kept for the later stages are released.
+  static void finishStep(AdvectType &kernel) {
+    for (auto &ls : kernel.initialLevelSets)
+      ls->discardSnapshot();
+    kernel.endStageVelocityReuse();
+    beginStage(kernel, 0, 0.);
+  }
+
+  /// Sets the Runge-Kutta stage whose rates are computed next and its time
+  /// relative to the start of the time step, which are passed to
+  /// VelocityField::prepare2D or prepare3D.
+  static void beginStage(AdvectType &kernel, unsigned stage,
+                         double timeOffset) {
+    kernel.currentStage = stage;
+    kernel.stageTimeOffset = timeOffset;
+  }
 
   static double evolveForwardEuler(AdvectType &kernel, double maxTimeStep,
                                    bool updateLowerLayers = true) {
-    if (kernel.currentTimeStep < 0. || kernel.storedRates.empty())
-      kernel.computeRates(maxTimeStep);
-
-    kernel.updateLevelSet(kernel.currentTimeStep);
+    if (kernel.fusedRateUpdate && kernel.storedRates.empty()) {
+      // rates are applied as they are calculated, without storing them
+      kernel.computeAndApplyRates(maxTimeStep);
+    } else {
+      if (kernel.currentTimeStep < 0. || kernel.storedRates.empty())
+        kernel.computeRates(maxTimeStep);
+
+      kernel.updateLevelSet(kernel.currentTimeStep);
+    }
 
     kernel.rebuildLS();
 
@@ -60,6 +90,8 @@ template <class T, int D> struct AdvectTimeIntegration {
 
   static double evolveRungeKutta2(AdvectType &kernel, double maxTimeStep) {
     // TVD Runge-Kutta 2nd Order (Heun's Method)
+    kernel.beginStageVelocityReuse();
+    beginStage(kernel, 0, 0.);
 
     // Save initial level sets
     if (kernel.initialLevelSets.size() != kernel.levelSets.size()) {
@@ -67,13 +99,13 @@ template <class T, int D> struct AdvectTimeIntegration {
       for (auto &ls : kernel.initialLevelSets)
         ls = viennals::Domain<T, D>::New(kernel.levelSets[0]->getGrid());
     }
-    kernel.initialLevelSets.back()->deepCopy(kernel.levelSets.back());
+    kernel.initialLevelSets.back()->deepCopyOnWrite(kernel.levelSets.back());
 
     // Save initial lower level sets only if Stage 1 will modify them (via
-    // callback)
+    // callback). The values are only copied once they are modified.
     if (kernel.velocityUpdateCallback) {
       for (size_t i = 0; i < kernel.levelSets.size() - 1; ++i) {
-        kernel.initialLevelSets[i]->deepCopy(kernel.levelSets[i]);
+        kernel.initialLevelSets[i]->deepCopyOnWrite(kernel.levelSets[i]);
       }
     }
 
@@ -82,8 +114,10 @@ template <class T, int D> struct AdvectTimeIntegration {
     double dt1 = evolveForwardEuler(kernel, maxTimeStep,
                                     kernel.velocityUpdateCallback != nullptr);
 
-    if (dt1 <= 0.)
+    if (dt1 <= 0.) {
+      finishStep(kernel);
       return 0.;
+    }
 
     if (kernel.velocityUpdateCallback)
       kernel.velocityUpdateCallback(kernel.levelSets.back());
@@ -91,6 +125,7 @@ template <class T, int D> struct AdvectTimeIntegration {
     // Stage 2: u^(n+1) = 1/2 u^n + 1/2 (u^(1) + dt * L(u^(1)))
     // Current level set is u^(1). Compute L(u^(1)).
     // Update to u* = u^(1) + dt * L(u^(1))
+    beginStage(kernel, 1, dt1);
     double dt2 = evolveForwardEuler(kernel, dt1, false);
 
     // Combine: u^(n+1) = 0.5 * u^n + 0.5 * u*
@@ -103,25 +138,38 @@ template <class T, int D> struct AdvectTimeIntegration {
       }
     }
     kernel.adjustLowerLayers();
+    finishStep(kernel);
 
     return 0.5 * dt1 + 0.5 * dt2;
   }
 
-  static double evolveRungeKutta3(AdvectType &kernel, double maxTimeStep) {
+  /// Performs one step of the TVD Runge-Kutta 3rd order scheme, without
+  /// calling finishStep(). If secondStage is given, it is made a snapshot of
+  /// the second stage u^(2). If firstStageTimeStep is given, it is set to the
+  /// time step of the first stage, which limits the later stages.
+  static double rungeKutta3Step(AdvectType &kernel, double maxTimeStep,
+                                viennals::Domain<T, D> *secondStage = nullptr,
+                                double *firstStageTimeStep = nullptr) {
+    kernel.beginStageVelocityReuse();
+    beginStage(kernel, 0, 0.);
     // Save initial level sets
     if (kernel.initialLevelSets.size() != kernel.levelSets.size()) {
       kernel.initialLevelSets.resize(kernel.levelSets.size());
       for (auto &ls : kernel.initialLevelSets)
         ls = viennals::Domain<T, D>::New(kernel.levelSets[0]->getGrid());
     }
+    // The values of the lower level sets are only copied once they are
+    // modified, they are often restored unchanged
     for (size_t i = 0; i < kernel.levelSets.size(); ++i) {
-      kernel.initialLevelSets[i]->deepCopy(kernel.levelSets[i]);
+      kernel.initialLevelSets[i]->deepCopyOnWrite(kernel.levelSets[i]);
     }
 
     // Stage 1: u^(1) = u^n + dt * L(u^n)
     // This calculates dt based on u^n and advances to u^1.
     double dt1 = evolveForwardEuler(kernel, maxTimeStep,
                                     kernel.velocityUpdateCallback != nullptr);
+    if (firstStageTimeStep != nullptr)
+      *firstStageTimeStep = dt1;
 
     if (dt1 <= 0.)
       return 0.;
@@ -131,10 +179,13 @@ template <class T, int D> struct AdvectTimeIntegration {
 
     // Stage 2: u^(2) = 3/4 u^n + 1/4 (u^(1) + dt * L(u^(1)))
     // u* = u^(1) + dt * L(u^(1))
+    beginStage(kernel, 1, dt1);
     double dt2 = evolveForwardEuler(kernel, dt1, false);
 
     // Combine to get u^(2) = 0.75 * u^n + 0.25 * u*.
     bool etched1 = kernel.combineLevelSets(0.75, 0.25);
+    if (secondStage != nullptr)
+      secondStage->deepCopyOnWrite(kernel.levelSets.back());
 
     // Restore lower level sets if etched
     if (etched1 && kernel.velocityUpdateCallback) {
@@ -150,7 +201,8 @@ template <class T, int D> struct AdvectTimeIntegration {
     }
 
     // Stage 3: u^(n+1) = 1/3 u^n + 2/3 (u^(2) + dt * L(u^(2)))
-    // u** = u^(2) + dt * L(u^(2))
+    // u** = u^(2) + dt * L(u^(2)), where u^(2) is at half the time step
+    beginStage(kernel, 2, 0.5 * dt1);
     double dt3 = evolveForwardEuler(kernel, dt1, false);
 
     // Combine to get u^(n+1) = 1/3 * u^n + 2/3 * u**.
@@ -166,6 +218,129 @@ template <class T, int D> struct AdvectTimeIntegration {
 
     return (dt1 + dt2 + 4.0 * dt3) / 6.0;
   }
+
+  static double evolveRungeKutta3(AdvectType &kernel, double maxTimeStep) {
+    const double dt = rungeKutta3Step(kernel, maxTimeStep);
+    finishStep(kernel);
+    return dt;
+  }
+
+  /// Largest difference between the 3rd order solution u^(n+1) and the
+  /// embedded 2nd order solution of Heun's method at the active points of
+  /// the top level set, in grid units. Heun's method uses the same stages,
+  /// its solution 1/2 u^n + 1/2 u* can be written as 2 u^(2) - u^n.
+  static T estimateLocalError(AdvectType &kernel,
+                              const viennals::Domain<T, D> &secondStage) {
+    using ConstSparseIterator = typename AdvectType::ConstSparseIterator;
+    using AccumulationType = typename AdvectType::AccumulationType;
+    const auto &topDomain = std::as_const(*kernel.levelSets.back()).getDomain();
+    auto &grid = kernel.levelSets.back()->getGrid();
+    const auto &initialDomain =
+        std::as_const(*kernel.initialLevelSets.back()).getDomain();
+    const auto &secondStageDomain = secondStage.getDomain();
+
+    T maxError = 0.;
+
+#pragma omp parallel num_threads(topDomain.getNumberOfSegments())
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+      viennahrle::Index<D> startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : topDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> endVector =
+          (p != static_cast<int>(topDomain.getNumberOfSegments() - 1))
+              ? topDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      ConstSparseIterator initialIt(initialDomain, startVector);
+      ConstSparseIterator secondStageIt(secondStageDomain, startVector);
+      T localMaxError = 0.;
+
+      for (ConstSparseIterator it(topDomain, startVector);
+           it.getStartIndices() < endVector; it.next()) {
+        if (!it.isDefined() || std::abs(it.getValue()) > 0.5)
+          continue;
+
+        initialIt.goToIndicesSequential(it.getStartIndices());
+        secondStageIt.goToIndicesSequential(it.getStartIndices());
+        if (!initialIt.isDefined() || !secondStageIt.isDefined())
+          continue;
+
+        // the difference cancels most digits, so it is not calculated in T
+        const T error = static_cast<T>(
+            std::abs(AccumulationType(it.getValue()) -
+                     2 * AccumulationType(secondStageIt.getValue()) +
+                     initialIt.getValue()));
+        localMaxError = std::max(localMaxError, error);
+      }
+
+#pragma omp critical
+      maxError = std::max(maxError, localMaxError);
+    }
+
+    return maxError;
+  }
+
+  /// TVD Runge-Kutta 3rd order scheme with error control. The local error
+  /// of each step is estimated using the embedded 2nd order solution and the
+  /// step is repeated with a smaller time step if the error is larger than
+  /// the tolerance. The time step of the next step is chosen from the
+  /// estimated error, but never exceeds the CFL condition.
+  static double evolveRungeKutta3Adaptive(AdvectType &kernel,
+                                          double maxTimeStep) {
+    // safety factor and limits of the change of the time step, the error of
+    // the embedded solution is of 3rd order in the time step
+    constexpr double safety = 0.9;
+    constexpr double minFactor = 0.2;
+    constexpr double maxFactor = 5.;
+    constexpr unsigned maxRejections = 10;
+
+    auto secondStage =
+        viennals::Domain<T, D>::New(kernel.levelSets.back()->getGrid());
+
+    for (unsigned rejections = 0;; ++rejections) {
+      const double stepLimit =
+          std::min(maxTimeStep, kernel.errorControlledTimeStep);
+      double dt1 = 0.;
+      const double dt =
+          rungeKutta3Step(kernel, stepLimit, secondStage.get(), &dt1);
+      if (dt <= 0.) {
+        finishStep(kernel);
+        return 0.;
+      }
+
+      const T error = estimateLocalError(kernel, *secondStage);
+      const double factor =
+          (error > 0.)
+              ? std::clamp(safety * std::cbrt(kernel.errorTolerance / error),
+                           minFactor, maxFactor)
+              : maxFactor;
+      // the error was made with the time step of the first stage, the
+      // current time step is the one of the last stage
+      kernel.errorControlledTimeStep = factor * dt1;
+
+      if (error <= kernel.errorTolerance || rejections == maxRejections) {
+        if (error > kernel.errorTolerance) {
+          VIENNACORE_LOG_WARNING("Advect: Accepting time step with an "
+                                 "estimated error above the tolerance.");
+        }
+        finishStep(kernel);
+        return dt;
+      }
+
+      // reject the step and start again from the initial level sets
+      ++kernel.numberOfRejectedTimeSteps;
+      for (size_t i = 0; i < kernel.levelSets.size(); ++i) {
+        kernel.levelSets[i]->deepCopy(kernel.initialLevelSets[i]);
+      }
+      kernel.lowerLayersAdjusted = kernel.lowerLayersAdjustedAtStepStart;
+      kernel.changedRegion.clear();
+    }
+  }
 };
 
 } // namespace lsInternal
@@ -5,6 +5,7 @@
 #include <hrleSparseStarIterator.hpp>
 
 #include <lsDomain.hpp>
+#include <lsIndexRegion.hpp>
 #include <lsPrune.hpp>
 
 #include <vcLogger.hpp>
@@ -55,13 +56,17 @@ private:
   ComparatorType operationComp = nullptr;
   bool updatePointData = true;
   bool pruneResult = true;
+  IndexRegion<D> region;
 
   void booleanOpInternal(ComparatorType comp) {
     auto &grid = levelSetA->getGrid();
-    auto newlsDomain = SmartPointer<Domain<T, D>>::New(grid);
-    typename Domain<T, D>::DomainType &newDomain = newlsDomain->getDomain();
-    typename Domain<T, D>::DomainType &domain = levelSetA->getDomain();
+    // the result is written into the buffer domain of A and swapped in
+    typename Domain<T, D>::DomainType &newDomain = levelSetA->getBufferDomain();
+    const auto &domain = std::as_const(*levelSetA).getDomain();
 
+    // with a region, the result mostly equals A, so the points of A are
+    // already distributed evenly across the new segments
+    const bool restricted = !region.empty();
     newDomain.initialize(domain.getNewSegmentation(), domain.getAllocation());
 
     const bool updateData = updatePointData;
@@ -83,7 +88,7 @@ private:
 
       auto &domainSegment = newDomain.getDomainSegment(p);
 
-      viennahrle::Index<D> currentVector =
+      viennahrle::Index<D> const startVector =
           (p == 0) ? grid.getMinGridPoint()
                    : newDomain.getSegmentation()[p - 1];
 
@@ -92,43 +97,67 @@ private:
               ? newDomain.getSegmentation()[p]
               : grid.incrementIndices(grid.getMaxGridPoint());
 
-      viennahrle::ConstSparseIterator<hrleDomainType> itA(
-          levelSetA->getDomain(), currentVector);
-      viennahrle::ConstSparseIterator<hrleDomainType> itB(
-          levelSetB->getDomain(), currentVector);
-
-      while (currentVector < endVector) {
-        const auto &comparison = comp(itA.getValue(), itB.getValue());
-        const auto &currentValue = comparison.first;
-
-        if (currentValue != Domain<T, D>::NEG_VALUE &&
-            currentValue != Domain<T, D>::POS_VALUE) {
-          domainSegment.insertNextDefinedPoint(currentVector, currentValue);
-          if (updateData) {
-            // if taken from A, set to true
-            const bool originLS = comparison.second;
-            newDataLS[p].push_back(originLS);
-            const auto originPointId =
-                (originLS) ? itA.getPointId() : itB.getPointId();
-            newDataSourceIds[p].push_back(originPointId);
+      // outside of the region, A is copied without looking at B
+      auto copyRange = [&](const viennahrle::Index<D> &rangeStart,
+                           const viennahrle::Index<D> &rangeEnd) {
+        lsInternal::copyDomainRange(domain, domainSegment, rangeStart,
+                                    rangeEnd,
+                                    updateData ? &newDataSourceIds[p]
+                                               : nullptr);
+        if (updateData)
+          newDataLS[p].resize(newDataSourceIds[p].size(), true);
+      };
+
+      auto combineRange = [&](viennahrle::Index<D> currentVector,
+                              const viennahrle::Index<D> &rangeEnd) {
+        viennahrle::ConstSparseIterator<hrleDomainType> itA(
+            std::as_const(*levelSetA).getDomain(), currentVector);
+        viennahrle::ConstSparseIterator<hrleDomainType> itB(
+            std::as_const(*levelSetB).getDomain(), currentVector);
+
+        while (currentVector < rangeEnd) {
+          const auto comparison =
+              (!restricted || region.contains(currentVector))
+                  ? comp(itA.getValue(), itB.getValue())
+                  : std::make_pair(itA.getValue(), true);
+          const auto &currentValue = comparison.first;
+
+          if (currentValue != Domain<T, D>::NEG_VALUE &&
+              currentValue != Domain<T, D>::POS_VALUE) {
+            domainSegment.insertNextDefinedPoint(currentVector, currentValue);
+            if (updateData) {
+              // if taken from A, set to true
+              const bool originLS = comparison.second;
+              newDataLS[p].push_back(originLS);
+              const auto originPointId =
+                  (originLS) ? itA.getPointId() : itB.getPointId();
+              newDataSourceIds[p].push_back(originPointId);
+            }
+          } else {
+            domainSegment.insertNextUndefinedPoint(
+                currentVector, (currentValue < 0) ? Domain<T, D>::NEG_VALUE
+                                                  : Domain<T, D>::POS_VALUE);
           }
-        } else {
-          domainSegment.insertNextUndefinedPoint(
-              currentVector, (currentValue < 0) ? Domain<T, D>::NEG_VALUE
-                                                : Domain<T, D>::POS_VALUE);
-        }
 
-        switch (Compare(itA.getEndIndices(), itB.getEndIndices())) {
-        case -1:
-          itA.next();
-          break;
-        case 0:
-          itA.next();
-        default:
-          itB.next();
+          switch (Compare(itA.getEndIndices(), itB.getEndIndices())) {
+          case -1:
+            itA.next();
+            break;
+          case 0:
+            itA.next();
+          default:
+            itB.next();
+          }
+          currentVector =
+              Max(itA.getStartIndices().get(), itB.getStartIndices().get());
         }
-        currentVector =
-            Max(itA.getStartIndices().get(), itB.getStartIndices().get());
+      };
+
+      if (restricted) {
+        region.splitRange(startVector, endVector, grid, copyRange,
+                          combineRange);
+      } else {
+        combineRange(startVector, endVector);
       }
     }
 
@@ -143,13 +172,13 @@ private:
     }
 
     // transfer data from the old LSs to new LS
+    typename Domain<T, D>::PointDataType newData;
     // Only do so if the same data exists in both LSs
     // If this is not the case, the data is invalid
     // and therefore not needed anyway.
     if (updateData) {
-      const auto &AData = levelSetA->getPointData();
-      const auto &BData = levelSetB->getPointData();
-      auto &newData = newlsDomain->getPointData();
+      const auto &AData = std::as_const(*levelSetA).getPointData();
+      const auto &BData = std::as_const(*levelSetB).getPointData();
 
       // scalars — preserve A's fields even when B doesn't have them.
       // Previously, fields present only on A (e.g. OxVelocity on the oxide
@@ -163,8 +192,8 @@ private:
         auto BPointer =
             BData.getScalarData(scalarDataLabel, true); // may be nullptr
         typename Domain<T, D>::PointDataType::ScalarDataType scalars;
-        scalars.resize(newlsDomain->getNumberOfPoints(), T(0));
-        for (unsigned j = 0; j < newlsDomain->getNumberOfPoints(); ++j) {
+        scalars.resize(newDomain.getNumberOfPoints(), T(0));
+        for (unsigned j = 0; j < newDomain.getNumberOfPoints(); ++j) {
           if (newDataLS[0][j])
             scalars[j] = APointer->at(newDataSourceIds[0][j]);
           else if (BPointer != nullptr)
@@ -183,8 +212,8 @@ private:
         using Vec =
             typename Domain<T, D>::PointDataType::VectorDataType::value_type;
         typename Domain<T, D>::PointDataType::VectorDataType vectors;
-        vectors.resize(newlsDomain->getNumberOfPoints(), Vec{});
-        for (unsigned j = 0; j < newlsDomain->getNumberOfPoints(); ++j) {
+        vectors.resize(newDomain.getNumberOfPoints(), Vec{});
+        for (unsigned j = 0; j < newDomain.getNumberOfPoints(); ++j) {
           if (newDataLS[0][j])
             vectors[j] = APointer->at(newDataSourceIds[0][j]);
           else if (BPointer != nullptr)
@@ -197,22 +226,28 @@ private:
     }
 
     newDomain.finalize();
-    newDomain.segment();
-    newlsDomain->setLevelSetWidth(levelSetA->getLevelSetWidth());
+    if (!restricted)
+      newDomain.segment();
+    levelSetA->swapBuffer(std::move(newData));
 
     if (pruneResult) {
-      auto pruner = Prune<T, D>(newlsDomain);
+      // changed points can only change whether their neighbours are pruned
+      auto pruneRegion = region;
+      pruneRegion.expand(1, grid);
+
+      auto pruner = Prune<T, D>(levelSetA);
       pruner.setRemoveStrayZeros(true);
+      pruner.setRegion(pruneRegion);
       pruner.apply();
 
       // now we need to prune, to remove stray defined points
-      Prune<T, D>(newlsDomain).apply();
+      pruner.setRemoveStrayZeros(false);
+      pruner.apply();
     }
-
-    levelSetA->deepCopy(newlsDomain);
   }
 
   void invert() {
+    // the values are changed in place
     auto &hrleDomain = levelSetA->getDomain();
 #pragma omp parallel num_threads(hrleDomain.getNumberOfSegments())
     {
@@ -323,6 +358,16 @@ public:
   /// Set whether the resulting level set should be pruned. Defaults to true
   void setPruneResult(bool pR) { pruneResult = pR; }
 
+  /// Restrict the operation to a region of the grid. Outside of the region,
+  /// the first level set must already be equal to the result of the
+  /// operation, e.g. because the second level set has only changed inside
+  /// the region since the last operation. The first level set is then copied
+  /// there without evaluating the operation. An empty region, the default,
+  /// applies the operation everywhere.
+  void setRegion(const IndexRegion<D> &passedRegion) {
+    region = passedRegion;
+  }
+
   /// Perform operation.
   void apply() {
     if (levelSetA == nullptr) {
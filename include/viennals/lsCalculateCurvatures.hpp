@@ -1,9 +1,12 @@
 #pragma once
 
+#include <utility>
+
 #include <hrleCartesianPlaneIterator.hpp>
 #include <lsCurvatureFormulas.hpp>
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
+#include <lsStencilSnapshot.hpp>
 
 #include <vcLogger.hpp>
 #include <vcSmartPointer.hpp>
@@ -23,6 +26,7 @@ enum struct CurvatureEnum : unsigned {
 // result is saved in the lsDomain.
 template <class T, int D> class CalculateCurvatures {
   SmartPointer<Domain<T, D>> levelSet = nullptr;
+  SmartPointer<StencilSnapshot<T, D>> stencilSnapshot = nullptr;
   T maxValue = 0.5;
   CurvatureEnum type = CurvatureEnum::MEAN_CURVATURE;
 
@@ -58,6 +62,14 @@ public:
 
   void setMaxValue(const T passedMaxValue) { maxValue = passedMaxValue; }
 
+  /// Read the neighbor values from the stencil snapshot of the level set
+  /// instead of iterating over the level set. The snapshot is built again
+  /// if the level set changed, so it can be shared with other algorithms.
+  /// It must contain box stencils of radius 1.
+  void setStencilSnapshot(SmartPointer<StencilSnapshot<T, D>> snapshot) {
+    stencilSnapshot = snapshot;
+  }
+
   void apply() {
     if (levelSet == nullptr) {
       VIENNACORE_LOG_ERROR("No level set was passed to CalculateCurvatures.");
@@ -89,55 +101,83 @@ public:
         (type == CurvatureEnum::MEAN_AND_GAUSSIAN_CURVATURE);
 
     //! Calculate Curvatures
-#pragma omp parallel num_threads(levelSet->getNumberOfSegments())
-    {
-      int p = 0;
+    if (lsInternal::prepareStencilSnapshot(stencilSnapshot, levelSet,
+                                           StencilShapeEnum::BOX, 1,
+                                           "CalculateCurvatures")) {
+      // the stencils are ordered by point id, so all curvatures are
+      // calculated into the first vectors
+      const std::size_t numberOfPoints = stencilSnapshot->getNumberOfPoints();
+      if (calculateMean)
+        meanCurvaturesVector[0].resize(numberOfPoints, 0.);
+      if (calculateGauss)
+        gaussCurvaturesVector[0].resize(numberOfPoints, 0.);
+
+#pragma omp parallel for schedule(static)
+      for (std::size_t pointId = 0; pointId < numberOfPoints; ++pointId) {
+        auto stencil = stencilSnapshot->getStencil(pointId);
+        if (std::abs(stencil.getCenter().getValue()) > maxValue)
+          continue;
+        if (calculateMean) {
+          meanCurvaturesVector[0][pointId] = lsInternal::meanCurvature(stencil);
+        }
+        if (calculateGauss) {
+          gaussCurvaturesVector[0][pointId] =
+              lsInternal::gaussianCurvature(stencil);
+        }
+      }
+    } else {
+      const auto &domain = std::as_const(*levelSet).getDomain();
+#pragma omp parallel num_threads(domain.getNumberOfSegments())
+      {
+        int p = 0;
 #ifdef _OPENMP
-      p = omp_get_thread_num();
+        p = omp_get_thread_num();
 #endif
 
-      auto &meanCurvatures = meanCurvaturesVector[p];
-      auto &gaussCurvatures = gaussCurvaturesVector[p];
-
-      if (calculateMean) {
-        meanCurvatures.reserve(
-            levelSet->getDomain().getDomainSegment(p).getNumberOfPoints());
-      }
-      if (calculateGauss) {
-        gaussCurvatures.reserve(
-            levelSet->getDomain().getDomainSegment(p).getNumberOfPoints());
-      }
-
-      viennahrle::Index<D> const startVector =
-          (p == 0) ? grid.getMinGridPoint()
-                   : levelSet->getDomain().getSegmentation()[p - 1];
+        auto &meanCurvatures = meanCurvaturesVector[p];
+        auto &gaussCurvatures = gaussCurvaturesVector[p];
 
-      viennahrle::Index<D> const endVector =
-          (p != static_cast<int>(levelSet->getNumberOfSegments() - 1))
-              ? levelSet->getDomain().getSegmentation()[p]
-              : grid.incrementIndices(grid.getMaxGridPoint());
-
-      for (viennahrle::CartesianPlaneIterator<typename Domain<T, D>::DomainType>
-               neighborIt(levelSet->getDomain(), startVector);
-           neighborIt.getIndices() < endVector; neighborIt.next()) {
-
-        auto &center = neighborIt.getCenter();
-        if (!center.isDefined()) {
-          continue;
-        } else if (std::abs(center.getValue()) > maxValue) {
-          if (calculateMean)
-            meanCurvatures.push_back(0.);
-          if (calculateGauss)
-            gaussCurvatures.push_back(0.);
-          continue;
-        }
-
-        // calculate curvatures
         if (calculateMean) {
-          meanCurvatures.push_back(lsInternal::meanCurvature(neighborIt));
+          meanCurvatures.reserve(
+              domain.getDomainSegment(p).getNumberOfPoints());
         }
         if (calculateGauss) {
-          gaussCurvatures.push_back(lsInternal::gaussianCurvature(neighborIt));
+          gaussCurvatures.reserve(
+              domain.getDomainSegment(p).getNumberOfPoints());
+        }
+
+        viennahrle::Index<D> const startVector =
+            (p == 0) ? grid.getMinGridPoint() : domain.getSegmentation()[p - 1];
+
+        viennahrle::Index<D> const endVector =
+            (p != static_cast<int>(domain.getNumberOfSegments() - 1))
+                ? domain.getSegmentation()[p]
+                : grid.incrementIndices(grid.getMaxGridPoint());
+
+        for (viennahrle::CartesianPlaneIterator<
+                 const typename Domain<T, D>::DomainType>
+                 neighborIt(domain, startVector);
+             neighborIt.getIndices() < endVector; neighborIt.next()) {
+
+          auto &center = neighborIt.getCenter();
+          if (!center.isDefined()) {
+            continue;
+          } else if (std::abs(center.getValue()) > maxValue) {
+            if (calculateMean)
+              meanCurvatures.push_back(0.);
+            if (calculateGauss)
+              gaussCurvatures.push_back(0.);
+            continue;
+          }
+
+          // calculate curvatures
+          if (calculateMean) {
+            meanCurvatures.push_back(lsInternal::meanCurvature(neighborIt));
+          }
+          if (calculateGauss) {
+            gaussCurvatures.push_back(
+                lsInternal::gaussianCurvature(neighborIt));
+          }
         }
       }
     }
@@ -3,11 +3,13 @@
 #include <lsPreCompileMacros.hpp>
 
 #include <algorithm>
+#include <utility>
 
 #include <hrleSparseStarIterator.hpp>
 
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
+#include <lsStencilSnapshot.hpp>
 
 #include <vcLogger.hpp>
 #include <vcSmartPointer.hpp>
@@ -39,6 +41,7 @@ enum class NormalCalculationMethodEnum {
 /// vectors.
 template <class T, int D> class CalculateNormalVectors {
   SmartPointer<Domain<T, D>> levelSet = nullptr;
+  SmartPointer<StencilSnapshot<T, D>> stencilSnapshot = nullptr;
   T maxValue = 0.5;
   NormalCalculationMethodEnum method =
       NormalCalculationMethodEnum::CENTRAL_DIFFERENCES;
@@ -80,6 +83,14 @@ public:
     method = passedMethod;
   }
 
+  /// Read the neighbor values from the stencil snapshot of the level set
+  /// instead of iterating over the level set. The snapshot is built again
+  /// if the level set changed, so it can be shared with other algorithms.
+  /// It must contain star stencils of radius 1.
+  void setStencilSnapshot(SmartPointer<StencilSnapshot<T, D>> snapshot) {
+    stencilSnapshot = snapshot;
+  }
+
   SmartPointer<Domain<T, D>> getLevelSet() const { return levelSet; }
 
   T getMaxValue() const { return maxValue; }
@@ -123,10 +134,28 @@ private:
     std::vector<std::vector<Vec3D<T>>> normalVectorsVector(
         levelSet->getNumberOfSegments());
 
+    if (lsInternal::prepareStencilSnapshot(stencilSnapshot, levelSet,
+                                           StencilShapeEnum::STAR, 1,
+                                           "CalculateNormalVectors")) {
+      // the stencils are ordered by point id, so all normals are calculated
+      // into the first vector
+      auto &normalVectors = normalVectorsVector[0];
+      const std::size_t numberOfPoints = stencilSnapshot->getNumberOfPoints();
+      normalVectors.resize(numberOfPoints);
+#pragma omp parallel for schedule(static)
+      for (std::size_t pointId = 0; pointId < numberOfPoints; ++pointId) {
+        normalVectors[pointId] =
+            centralDifferenceNormal(stencilSnapshot->getStencil(pointId));
+      }
+      insertIntoPointData(normalVectorsVector);
+      return;
+    }
+
+    const auto &domain = std::as_const(*levelSet).getDomain();
+
     // Estimate memory requirements per thread to improve cache performance
-    double pointsPerSegment =
-        double(2 * levelSet->getDomain().getNumberOfPoints()) /
-        double(levelSet->getLevelSetWidth());
+    double pointsPerSegment = double(2 * domain.getNumberOfPoints()) /
+                              double(levelSet->getLevelSetWidth());
 
     auto grid = levelSet->getGrid();
 
@@ -142,66 +171,64 @@ private:
       normalVectors.reserve(pointsPerSegment);
 
       viennahrle::Index<D> const startVector =
-          (p == 0) ? grid.getMinGridPoint()
-                   : levelSet->getDomain().getSegmentation()[p - 1];
+          (p == 0) ? grid.getMinGridPoint() : domain.getSegmentation()[p - 1];
 
       viennahrle::Index<D> const endVector =
-          (p != static_cast<int>(levelSet->getNumberOfSegments() - 1))
-              ? levelSet->getDomain().getSegmentation()[p]
+          (p != static_cast<int>(domain.getNumberOfSegments() - 1))
+              ? domain.getSegmentation()[p]
               : grid.incrementIndices(grid.getMaxGridPoint());
 
       for (viennahrle::ConstSparseStarIterator<
                typename Domain<T, D>::DomainType, 1>
-               neighborIt(levelSet->getDomain(), startVector);
+               neighborIt(domain, startVector);
            neighborIt.getIndices() < endVector; neighborIt.next()) {
 
-        auto &center = neighborIt.getCenter();
-        if (!center.isDefined()) {
-          continue;
-        } else if (std::abs(center.getValue()) > maxValue) {
-          // push an empty vector to keep ordering correct
-          Vec3D<T> tmp{};
-          normalVectors.push_back(tmp);
-          continue;
-        }
-
-        Vec3D<T> n{};
-
-        T denominator = 0;
-        for (int i = 0; i < D; i++) {
-          viennahrle::Index<D> posIdx(0);
-          posIdx[i] = 1;
-          viennahrle::Index<D> negIdx(0);
-          negIdx[i] = -1;
-          T pos = neighborIt.getNeighbor(posIdx).getValue() - center.getValue();
-          T neg = center.getValue() - neighborIt.getNeighbor(negIdx).getValue();
-          n[i] = (pos + neg) * FINITE_DIFF_FACTOR;
-          denominator += n[i] * n[i];
-        }
+        if (neighborIt.getCenter().isDefined())
+          normalVectors.push_back(centralDifferenceNormal(neighborIt));
+      }
+    }
+    insertIntoPointData(normalVectorsVector);
+  }
 
-        denominator = std::sqrt(denominator);
-        if (std::abs(denominator) < EPSILON) {
-          VIENNACORE_LOG_WARNING(
-              "CalculateNormalVectors: Vector of length 0 at " +
-              neighborIt.getIndices().to_string());
-          for (unsigned i = 0; i < D; ++i)
-            n[i] = 0.;
-        } else {
-          for (unsigned i = 0; i < D; ++i) {
-            n[i] /= denominator;
-          }
-        }
+  /// Normal vector at the defined center of neighborIt from central
+  /// differences, or an empty vector if the center is not within maxValue.
+  template <class NeighborIterator>
+  Vec3D<T> centralDifferenceNormal(const NeighborIterator &neighborIt) const {
+    auto &center = neighborIt.getCenter();
+    Vec3D<T> n{};
+    if (std::abs(center.getValue()) > maxValue)
+      return n;
+
+    T denominator = 0;
+    for (int i = 0; i < D; i++) {
+      viennahrle::Index<D> posIdx(0);
+      posIdx[i] = 1;
+      viennahrle::Index<D> negIdx(0);
+      negIdx[i] = -1;
+      T pos = neighborIt.getNeighbor(posIdx).getValue() - center.getValue();
+      T neg = center.getValue() - neighborIt.getNeighbor(negIdx).getValue();
+      n[i] = (pos + neg) * FINITE_DIFF_FACTOR;
+      denominator += n[i] * n[i];
+    }
 
-        normalVectors.push_back(n);
+    denominator = std::sqrt(denominator);
+    if (std::abs(denominator) < EPSILON) {
+      VIENNACORE_LOG_WARNING("CalculateNormalVectors: Vector of length 0 at " +
+                             neighborIt.getIndices().to_string());
+      for (unsigned i = 0; i < D; ++i)
+        n[i] = 0.;
+    } else {
+      for (unsigned i = 0; i < D; ++i) {
+        n[i] /= denominator;
       }
     }
-    insertIntoPointData(normalVectorsVector);
+    return n;
   }
 
   void calculateOneSidedMinMod() {
     // This method does not require expansion, since it is robust to missing
     // neighbors.
-    auto &domain = levelSet->getDomain();
+    const auto &domain = std::as_const(*levelSet).getDomain();
     auto &grid = levelSet->getGrid();
 
     // Directly write to a single vector indexed by point ID.
@@ -209,73 +236,37 @@ private:
     // points.
     std::vector<Vec3D<T>> normalVectors(levelSet->getNumberOfPoints());
 
+    if (lsInternal::prepareStencilSnapshot(stencilSnapshot, levelSet,
+                                           StencilShapeEnum::STAR, 1,
+                                           "CalculateNormalVectors")) {
+#pragma omp parallel for schedule(static)
+      for (std::size_t pointId = 0; pointId < normalVectors.size(); ++pointId) {
+        normalVectors[pointId] =
+            oneSidedMinModNormal(stencilSnapshot->getStencil(pointId));
+      }
+    } else {
 #pragma omp parallel num_threads(levelSet->getNumberOfSegments())
-    {
-      int p = 0;
+      {
+        int p = 0;
 #ifdef _OPENMP
-      p = omp_get_thread_num();
+        p = omp_get_thread_num();
 #endif
 
-      viennahrle::Index<D> startVector =
-          (p == 0) ? grid.getMinGridPoint()
-                   : levelSet->getDomain().getSegmentation()[p - 1];
-      viennahrle::Index<D> endVector =
-          (p != static_cast<int>(levelSet->getNumberOfSegments() - 1))
-              ? levelSet->getDomain().getSegmentation()[p]
-              : grid.incrementIndices(grid.getMaxGridPoint());
-
-      viennahrle::SparseStarIterator<typename Domain<T, D>::DomainType, 1>
-          neighborIt(domain, startVector);
-
-      for (; neighborIt.getIndices() < endVector; neighborIt.next()) {
-        if (neighborIt.getCenter().isDefined()) {
-          Vec3D<T> grad{};
-          for (int i = 0; i < D; ++i) {
-            viennahrle::Index<D> posIdx(0);
-            posIdx[i] = 1;
-            viennahrle::Index<D> negIdx(0);
-            negIdx[i] = -1;
-            bool negDefined = neighborIt.getNeighbor(negIdx).isDefined();
-            bool posDefined = neighborIt.getNeighbor(posIdx).isDefined();
-
-            if (negDefined && posDefined) {
-              T valNeg = neighborIt.getNeighbor(negIdx).getValue();
-              T valCenter = neighborIt.getCenter().getValue();
-              T valPos = neighborIt.getNeighbor(posIdx).getValue();
-
-              const bool centerSign = valCenter >= 0;
-              const bool negSign = valNeg > 0;
-              const bool posSign = valPos > 0;
-
-              const T d_neg = valCenter - valNeg;
-              const T d_pos = valPos - valCenter;
-
-              if (centerSign != negSign && centerSign != posSign) {
-                // Center is an extremum, use minmod to be safe
-                grad[i] = 0.;
-                // (std::abs(d_pos) < std::abs(d_neg)) ? d_pos : d_neg;
-              } else if (centerSign != negSign) {
-                // Interface is on the negative side, use backward difference
-                grad[i] = d_neg;
-              } else if (centerSign != posSign) {
-                // Interface is on the positive side, use forward difference
-                grad[i] = d_pos;
-              } else {
-                // No sign change, use minmod to handle sharp features smoothly
-                grad[i] = (std::abs(d_pos) < std::abs(d_neg)) ? d_pos : d_neg;
-              }
-            } else if (negDefined) {
-              grad[i] = (neighborIt.getCenter().getValue() -
-                         neighborIt.getNeighbor(negIdx).getValue());
-            } else if (posDefined) {
-              grad[i] = (neighborIt.getNeighbor(posIdx).getValue() -
-                         neighborIt.getCenter().getValue());
-            } else {
-              grad[i] = 0;
-            }
-          }
-          Normalize(grad);
-          normalVectors[neighborIt.getCenter().getPointId()] = grad;
+        viennahrle::Index<D> startVector =
+            (p == 0) ? grid.getMinGridPoint() : domain.getSegmentation()[p - 1];
+        viennahrle::Index<D> endVector =
+            (p != static_cast<int>(domain.getNumberOfSegments() - 1))
+                ? domain.getSegmentation()[p]
+                : grid.incrementIndices(grid.getMaxGridPoint());
+
+        viennahrle::ConstSparseStarIterator<typename Domain<T, D>::DomainType,
+                                            1>
+            neighborIt(domain, startVector);
+
+        for (; neighborIt.getIndices() < endVector; neighborIt.next()) {
+          if (neighborIt.getCenter().isDefined())
+            normalVectors[neighborIt.getCenter().getPointId()] =
+                oneSidedMinModNormal(neighborIt);
         }
       }
     }
@@ -292,6 +283,60 @@ private:
     }
   }
 
+  /// Normal vector at the defined center of neighborIt from one sided
+  /// differences towards the interface, or min mod differences if the
+  /// interface is not next to the center.
+  template <class NeighborIterator>
+  static Vec3D<T> oneSidedMinModNormal(const NeighborIterator &neighborIt) {
+    Vec3D<T> grad{};
+    for (int i = 0; i < D; ++i) {
+      viennahrle::Index<D> posIdx(0);
+      posIdx[i] = 1;
+      viennahrle::Index<D> negIdx(0);
+      negIdx[i] = -1;
+      bool negDefined = neighborIt.getNeighbor(negIdx).isDefined();
+      bool posDefined = neighborIt.getNeighbor(posIdx).isDefined();
+
+      if (negDefined && posDefined) {
+        T valNeg = neighborIt.getNeighbor(negIdx).getValue();
+        T valCenter = neighborIt.getCenter().getValue();
+        T valPos = neighborIt.getNeighbor(posIdx).getValue();
+
+        const bool centerSign = valCenter >= 0;
+        const bool negSign = valNeg > 0;
+        const bool posSign = valPos > 0;
+
+        const T d_neg = valCenter - valNeg;
+        const T d_pos = valPos - valCenter;
+
+        if (centerSign != negSign && centerSign != posSign) {
+          // Center is an extremum, use minmod to be safe
+          grad[i] = 0.;
+          // (std::abs(d_pos) < std::abs(d_neg)) ? d_pos : d_neg;
+        } else if (centerSign != negSign) {
+          // Interface is on the negative side, use backward difference
+          grad[i] = d_neg;
+        } else if (centerSign != posSign) {
+          // Interface is on the positive side, use forward difference
+          grad[i] = d_pos;
+        } else {
+          // No sign change, use minmod to handle sharp features smoothly
+          grad[i] = (std::abs(d_pos) < std::abs(d_neg)) ? d_pos : d_neg;
+        }
+      } else if (negDefined) {
+        grad[i] = (neighborIt.getCenter().getValue() -
+                   neighborIt.getNeighbor(negIdx).getValue());
+      } else if (posDefined) {
+        grad[i] = (neighborIt.getNeighbor(posIdx).getValue() -
+                   neighborIt.getCenter().getValue());
+      } else {
+        grad[i] = 0;
+      }
+    }
+    Normalize(grad);
+    return grad;
+  }
+
   void
   insertIntoPointData(std::vector<std::vector<Vec3D<T>>> &normalVectorsVector) {
     // copy all normals
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include <hrleSparseIterator.hpp>
 #include <lsDomain.hpp>
 #include <vcVectorType.hpp>
@@ -23,7 +25,7 @@ public:
         visibilitiesLabel(std::move(label)) {}
 
   void apply() {
-    auto &domain = levelSet->getDomain();
+    const auto &domain = std::as_const(*levelSet).getDomain();
     auto &grid = levelSet->getGrid();
 
     // Invert the vector
@@ -49,7 +51,7 @@ public:
         maxDefinedPoint[i] = std::numeric_limits<T>::lowest();
       }
       // Iterate through all defined points in the domain
-      for (viennahrle::SparseIterator<hrleDomainType> it(domain);
+      for (viennahrle::ConstSparseIterator<hrleDomainType> it(domain);
            !it.isFinished(); it.next()) {
         if (!it.isDefined())
           continue; // Skip undefined points
@@ -80,7 +82,8 @@ public:
                 ? domain.getSegmentation()[p]
                 : grid.incrementIndices(grid.getMaxGridPoint());
 
-        for (viennahrle::SparseIterator<hrleDomainType> it(domain, startVector);
+        for (viennahrle::ConstSparseIterator<hrleDomainType> it(domain,
+                                                                startVector);
              it.getStartIndices() < endVector; ++it) {
 
           if (!it.isDefined())
@@ -126,9 +129,9 @@ public:
               break; // Ray is outside the grid
 
             // Access the level set value at the nearest cell
-            T value =
-                viennahrle::SparseIterator<hrleDomainType>(domain, nearestCell)
-                    .getValue();
+            T value = viennahrle::ConstSparseIterator<hrleDomainType>(
+                          domain, nearestCell)
+                          .getValue();
 
             // Update the minimum value encountered
             if (value < minLevelSetValue) {
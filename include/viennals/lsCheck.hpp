@@ -2,6 +2,7 @@
 
 #include <ostream>
 #include <string>
+#include <utility>
 
 #include <hrleSparseStarIterator.hpp>
 
@@ -87,7 +88,7 @@ public:
 
     for (viennahrle::ConstSparseStarIterator<typename Domain<T, D>::DomainType,
                                              1>
-             it(levelSet->getDomain());
+             it(std::as_const(*levelSet).getDomain());
          !it.isFinished(); it.next()) {
 
       if (it.getCenter().isDefined()) {
@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <hrleDomain.hpp>
+#include <hrleSparseIterator.hpp>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace lsInternal {
+
+/// Splits the points of a level set into many more chunks than there are
+/// threads, so that each chunk holds about the same number of points of
+/// interest, e.g. active points. The chunks are then distributed between
+/// the threads of a parallel region using work stealing: each thread starts
+/// with a contiguous range of chunks and, once it has finished its own
+/// range, takes over half of the remaining range of another thread.
+/// Chunks never cross the segment boundaries of the level set, so the
+/// outputs of all chunks of one segment can be stitched together in order.
+template <class T, int D> class ChunkScheduler {
+  using DomainType = viennahrle::Domain<T, D>;
+  using ConstSparseIterator = viennahrle::ConstSparseIterator<DomainType>;
+
+  // a candidate chunk start is recorded every candidateSpacing points
+  static constexpr unsigned candidateSpacing = 64;
+
+  // first grid point of each chunk
+  std::vector<viennahrle::Index<D>> chunkStarts;
+  viennahrle::Index<D> endIndices;
+  // first chunk of each segment of the level set and total number of chunks
+  std::vector<unsigned> segmentChunks;
+  unsigned numberOfThreads = 1;
+  // range of chunks [begin, end) which still has to be processed by each
+  // thread, packed into a single integer so it can be changed atomically
+  std::vector<std::atomic<std::uint64_t>> ranges;
+
+  static std::uint64_t packRange(std::uint32_t begin, std::uint32_t end) {
+    return (static_cast<std::uint64_t>(begin) << 32) | end;
+  }
+
+  static std::uint32_t rangeBegin(std::uint64_t range) {
+    return static_cast<std::uint32_t>(range >> 32);
+  }
+
+  static std::uint32_t rangeEnd(std::uint64_t range) {
+    return static_cast<std::uint32_t>(range);
+  }
+
+  /// Takes the first chunk of the range of thread p. Returns false if the
+  /// range is empty.
+  bool popChunk(unsigned p, unsigned &chunk) {
+    auto range = ranges[p].load(std::memory_order_acquire);
+    while (rangeBegin(range) < rangeEnd(range)) {
+      if (ranges[p].compare_exchange_weak(
+              range, packRange(rangeBegin(range) + 1, rangeEnd(range)),
+              std::memory_order_acq_rel)) {
+        chunk = rangeBegin(range);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Takes the upper half of the range of another thread and makes it the
+  /// range of thread p, apart from the first chunk, which is returned in
+  /// chunk. Returns false if there is no work left to steal.
+  bool stealChunk(unsigned p, unsigned &chunk) {
+    for (unsigned i = 1; i < numberOfThreads; ++i) {
+      const unsigned victim = (p + i) % numberOfThreads;
+      auto range = ranges[victim].load(std::memory_order_acquire);
+      while (rangeBegin(range) < rangeEnd(range)) {
+        const auto begin = rangeBegin(range);
+        const auto end = rangeEnd(range);
+        const auto middle = begin + (end - begin) / 2;
+        if (ranges[victim].compare_exchange_weak(
+                range, packRange(begin, middle), std::memory_order_acq_rel)) {
+          chunk = middle;
+          // no other thread steals from an empty range, so the own range
+          // can be replaced directly
+          ranges[p].store(packRange(middle + 1, end),
+                          std::memory_order_release);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+public:
+  /// Number of chunks created for each thread, if the level set holds
+  /// enough points of interest.
+  static constexpr unsigned chunksPerThread = 16;
+
+  /// Splits domain into chunks holding about the same number of points for
+  /// which isCounted(iterator) returns true.
+  template <class CountFunction>
+  ChunkScheduler(const DomainType &domain, CountFunction isCounted) {
+    const auto &grid = domain.getGrid();
+    const unsigned numberOfSegments = domain.getNumberOfSegments();
+    endIndices = grid.incrementIndices(grid.getMaxGridPoint());
+
+#ifdef _OPENMP
+    numberOfThreads = omp_get_max_threads();
+#endif
+
+    // record every candidateSpacing-th counted point of each segment, so
+    // chunk starts can be picked without iterating again
+    std::vector<std::vector<viennahrle::Index<D>>> candidates(
+        numberOfSegments);
+    std::vector<std::size_t> counts(numberOfSegments, 0);
+
+#pragma omp parallel num_threads(numberOfSegments)
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+      viennahrle::Index<D> startVector =
+          (p == 0) ? grid.getMinGridPoint() : domain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> endVector =
+          (p != static_cast<int>(numberOfSegments - 1))
+              ? domain.getSegmentation()[p]
+              : endIndices;
+
+      std::size_t count = 0;
+      for (ConstSparseIterator it(domain, startVector);
+           it.getStartIndices() < endVector; it.next()) {
+        if (!isCounted(it))
+          continue;
+        if (count % candidateSpacing == 0)
+          candidates[p].push_back(it.getStartIndices());
+        ++count;
+      }
+      counts[p] = count;
+    }
+
+    std::size_t totalCount = 0;
+    for (auto count : counts)
+      totalCount += count;
+
+    // number of candidates between chunk starts
+    const std::size_t stride = std::max<std::size_t>(
+        1, totalCount /
+               (static_cast<std::size_t>(numberOfThreads) * chunksPerThread *
+                candidateSpacing));
+
+    segmentChunks.reserve(numberOfSegments + 1);
+    for (unsigned p = 0; p < numberOfSegments; ++p) {
+      segmentChunks.push_back(chunkStarts.size());
+      chunkStarts.push_back((p == 0) ? grid.getMinGridPoint()
+                                     : domain.getSegmentation()[p - 1]);
+      for (std::size_t i = stride; i < candidates[p].size(); i += stride) {
+        chunkStarts.push_back(candidates[p][i]);
+      }
+    }
+    segmentChunks.push_back(chunkStarts.size());
+
+    numberOfThreads = std::min<unsigned>(numberOfThreads, chunkStarts.size());
+    ranges = std::vector<std::atomic<std::uint64_t>>(numberOfThreads);
+    restart();
+  }
+
+  unsigned getNumberOfChunks() const { return chunkStarts.size(); }
+
+  /// Number of threads the parallel region processing the chunks should
+  /// use. If fewer threads are started, the remaining chunks are stolen by
+  /// the running threads.
+  unsigned getNumberOfThreads() const { return numberOfThreads; }
+
+  const viennahrle::Index<D> &getStartIndices(unsigned chunk) const {
+    return chunkStarts[chunk];
+  }
+
+  const viennahrle::Index<D> &getEndIndices(unsigned chunk) const {
+    return (chunk + 1 < chunkStarts.size()) ? chunkStarts[chunk + 1]
+                                            : endIndices;
+  }
+
+  /// First chunk of the segment of the level set.
+  unsigned getFirstChunk(unsigned segment) const {
+    return segmentChunks[segment];
+  }
+
+  /// One past the last chunk of the segment of the level set.
+  unsigned getLastChunk(unsigned segment) const {
+    return segmentChunks[segment + 1];
+  }
+
+  /// Chunk starts without the first chunk, which can be used as the
+  /// segmentation of a new domain with one segment per chunk.
+  std::vector<viennahrle::Index<D>> getSegmentation() const {
+    return std::vector<viennahrle::Index<D>>(chunkStarts.begin() + 1,
+                                             chunkStarts.end());
+  }
+
+  /// Distributes all chunks between the threads again. Must not be called
+  /// while chunks are processed.
+  void restart() {
+    const std::size_t numberOfChunks = chunkStarts.size();
+    for (unsigned p = 0; p < numberOfThreads; ++p) {
+      ranges[p].store(packRange(numberOfChunks * p / numberOfThreads,
+                                numberOfChunks * (p + 1) / numberOfThreads),
+                      std::memory_order_relaxed);
+    }
+  }
+
+  /// Calls chunkFunction(chunk) for each chunk which has not been processed
+  /// yet. Must be called by every thread of a parallel region, after restart.
+  template <class ChunkFunction> void processChunks(ChunkFunction &&function) {
+    unsigned p = 0;
+#ifdef _OPENMP
+    p = omp_get_thread_num();
+#endif
+    unsigned chunk;
+    while (popChunk(p, chunk) || stealChunk(p, chunk)) {
+      function(chunk);
+    }
+  }
+};
+
+} // namespace lsInternal
@@ -7,6 +7,7 @@
 #include <lsPreCompileMacros.hpp>
 
 #include <unordered_map>
+#include <utility>
 
 namespace viennals {
 
@@ -63,8 +64,8 @@ template <class T, int D = 2> class CompareNarrowBand {
     }
 
     // Check if the x extents of both level sets are equal
-    const auto &domainTarget = levelSetTarget->getDomain();
-    const auto &domainSample = levelSetSample->getDomain();
+    const auto &domainTarget = std::as_const(*levelSetTarget).getDomain();
+    const auto &domainSample = std::as_const(*levelSetSample).getDomain();
 
     // hrleIndexType targetMinX = gridTarget.isNegBoundaryInfinite(0)
     //                                ? domainTarget.getMinRunBreak(0)
@@ -223,9 +224,9 @@ public:
 
     // Set up iterators for both level sets
     viennahrle::ConstDenseCellIterator<typename Domain<T, D>::DomainType>
-        itSample(levelSetSample->getDomain(), minIndex);
+        itSample(std::as_const(*levelSetSample).getDomain(), minIndex);
     viennahrle::ConstDenseCellIterator<typename Domain<T, D>::DomainType>
-        itTarget(levelSetTarget->getDomain(), minIndex);
+        itTarget(std::as_const(*levelSetTarget).getDomain(), minIndex);
 
     sumSquaredDifferences = 0.0;
     numPoints = 0;
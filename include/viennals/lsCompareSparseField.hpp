@@ -9,6 +9,7 @@
 
 #include <cmath>
 #include <limits>
+#include <utility>
 
 namespace viennals {
 
@@ -271,9 +272,9 @@ public:
 
     // Create sparse iterators for the level sets
     viennahrle::ConstSparseIterator<typename Domain<T, D>::DomainType>
-        itIterated(levelSetIterated->getDomain());
+        itIterated(std::as_const(*levelSetIterated).getDomain());
     viennahrle::ConstSparseIterator<typename Domain<T, D>::DomainType>
-        itExpanded(levelSetExpanded->getDomain());
+        itExpanded(std::as_const(*levelSetExpanded).getDomain());
 
     // Iterate over all defined points in the iterated level set
     while (!itIterated.isFinished()) {
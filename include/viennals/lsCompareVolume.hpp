@@ -3,6 +3,7 @@
 #include <cmath>
 #include <limits>
 #include <unordered_map>
+#include <utility>
 
 #include <hrleDenseCellIterator.hpp>
 #include <lsDomain.hpp>
@@ -89,8 +90,8 @@ template <class T, int D = 3> class CompareVolume {
     }
 
     // Get the boundaries of the two level sets
-    auto &domainTarget = levelSetTarget->getDomain();
-    auto &domainSample = levelSetSample->getDomain();
+    const auto &domainTarget = std::as_const(*levelSetTarget).getDomain();
+    const auto &domainSample = std::as_const(*levelSetSample).getDomain();
 
     // Calculate actual bounds
     for (unsigned i = 0; i < D; ++i) {
@@ -238,9 +239,9 @@ public:
 
     // Set up dense cell iterators for both level sets
     viennahrle::ConstDenseCellIterator<hrleDomainType> itTarget(
-        workingTarget->getDomain(), minIndex);
+        std::as_const(*workingTarget).getDomain(), minIndex);
     viennahrle::ConstDenseCellIterator<hrleDomainType> itSample(
-        workingSample->getDomain(), minIndex);
+        std::as_const(*workingSample).getDomain(), minIndex);
 
     differentCellsCount = 0;
     customDifferentCellCount = 0;
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <utility>
+
 #include <hrleCartesianPlaneIterator.hpp>
 #include <hrleSparseBoxIterator.hpp>
 #include <lsCalculateNormalVectors.hpp>
 #include <lsCurvatureFormulas.hpp>
 #include <lsDomain.hpp>
+#include <lsStencilSnapshot.hpp>
 
 #include <vcSmartPointer.hpp>
 #include <vcVectorType.hpp>
@@ -26,6 +29,7 @@ enum struct FeatureDetectionEnum : unsigned {
 template <class T, int D> class DetectFeatures {
   typedef typename Domain<T, D>::DomainType hrleDomainType;
   SmartPointer<Domain<T, D>> levelSet = nullptr;
+  SmartPointer<StencilSnapshot<T, D>> stencilSnapshot = nullptr;
   FeatureDetectionEnum method = FeatureDetectionEnum::CURVATURE;
   T flatLimit = 1.;
   T flatLimit2 = 1.;
@@ -60,6 +64,15 @@ public:
     method = passedMethod;
   }
 
+  /// Read the neighbor values from the stencil snapshot of the level set
+  /// instead of iterating over the level set. The snapshot is built again
+  /// if the level set changed, so it can be shared with other algorithms,
+  /// e.g. with the calculation of the normal vectors. It must contain box
+  /// stencils of radius 1.
+  void setStencilSnapshot(SmartPointer<StencilSnapshot<T, D>> snapshot) {
+    stencilSnapshot = snapshot;
+  }
+
   /// Execute the algorithm.
   void apply() {
     if (method == FeatureDetectionEnum::CURVATURE) {
@@ -90,8 +103,20 @@ private:
   void FeatureDetectionCurvature() {
     flaggedCells.clear();
 
+    if (lsInternal::prepareStencilSnapshot(stencilSnapshot, levelSet,
+                                           StencilShapeEnum::BOX, 1,
+                                           "DetectFeatures")) {
+      flaggedCells.resize(stencilSnapshot->getNumberOfPoints());
+#pragma omp parallel for schedule(static)
+      for (std::size_t pointId = 0; pointId < flaggedCells.size(); ++pointId) {
+        auto stencil = stencilSnapshot->getStencil(pointId);
+        flaggedCells[pointId] = curvatureFeatureFlag(stencil);
+      }
+      return;
+    }
+
     auto grid = levelSet->getGrid();
-    typename Domain<T, D>::DomainType &domain = levelSet->getDomain();
+    const auto &domain = std::as_const(*levelSet).getDomain();
     std::vector<std::vector<T>> flagsReserve(levelSet->getNumberOfSegments());
 
 #pragma omp parallel num_threads((levelSet)->getNumberOfSegments())
@@ -102,8 +127,7 @@ private:
 #endif
 
       auto &flagsSegment = flagsReserve[p];
-      flagsSegment.reserve(
-          levelSet->getDomain().getDomainSegment(p).getNumberOfPoints());
+      flagsSegment.reserve(domain.getDomainSegment(p).getNumberOfPoints());
 
       viennahrle::Index<D> const startVector =
           (p == 0) ? grid.getMinGridPoint() : domain.getSegmentation()[p - 1];
@@ -113,33 +137,13 @@ private:
               ? domain.getSegmentation()[p]
               : grid.incrementIndices(grid.getMaxGridPoint());
 
-      for (viennahrle::CartesianPlaneIterator<typename Domain<T, D>::DomainType,
-                                              1>
-               neighborIt(levelSet->getDomain(), startVector);
+      for (viennahrle::CartesianPlaneIterator<
+               const typename Domain<T, D>::DomainType, 1>
+               neighborIt(domain, startVector);
            neighborIt.getIndices() < endVector; neighborIt.next()) {
 
-        auto &center = neighborIt.getCenter();
-        if (!center.isDefined()) {
-          continue;
-        } else if (std::abs(center.getValue()) > 0.5) {
-          flagsSegment.push_back(0);
-          continue;
-        }
-
-        T curve = lsInternal::meanCurvature(neighborIt);
-        if (std::abs(curve) > flatLimit) {
-          flagsSegment.push_back(1);
-        } else {
-          if constexpr (D == 2) {
-            flagsSegment.push_back(0);
-          } else {
-            curve = lsInternal::gaussianCurvature(neighborIt);
-            if (std::abs(curve) > flatLimit2)
-              flagsSegment.push_back(1);
-            else
-              flagsSegment.push_back(0);
-          }
-        }
+        if (neighborIt.getCenter().isDefined())
+          flagsSegment.push_back(curvatureFeatureFlag(neighborIt));
       }
     }
 
@@ -149,6 +153,23 @@ private:
                           flagsReserve[i].end());
   }
 
+  /// Feature marker of the defined center of neighborIt from its curvatures.
+  template <class NeighborIterator>
+  T curvatureFeatureFlag(NeighborIterator &neighborIt) const {
+    if (std::abs(neighborIt.getCenter().getValue()) > 0.5)
+      return 0;
+
+    T curve = lsInternal::meanCurvature(neighborIt);
+    if (std::abs(curve) > flatLimit)
+      return 1;
+    if constexpr (D == 2) {
+      return 0;
+    } else {
+      curve = lsInternal::gaussianCurvature(neighborIt);
+      return (std::abs(curve) > flatLimit2) ? 1 : 0;
+    }
+  }
+
   // Detects Features of the level set by comparing the angle of each normal
   // vector on the surface to its adjacent normal vectors. The minimal angle
   // that should be considered a feature is passed to the class constructor.
@@ -157,15 +178,30 @@ private:
     flaggedCells.clear();
 
     auto &grid = levelSet->getGrid();
-    auto &domain = levelSet->getDomain();
     T cosAngleTreshold = std::cos(flatLimit);
 
     // CALCULATE NORMALS
     Expand<T, D>(levelSet, 3).apply();
-    CalculateNormalVectors<T, D>(levelSet).apply();
+    CalculateNormalVectors<T, D> normalCalculation(levelSet);
+    normalCalculation.setStencilSnapshot(stencilSnapshot);
+    normalCalculation.apply();
     const auto &normals = *(levelSet->getPointData().getVectorData(
         CalculateNormalVectors<T, D>::normalVectorsLabel));
 
+    if (lsInternal::prepareStencilSnapshot(stencilSnapshot, levelSet,
+                                           StencilShapeEnum::BOX, 1,
+                                           "DetectFeatures")) {
+      flaggedCells.resize(stencilSnapshot->getNumberOfPoints());
+#pragma omp parallel for schedule(static)
+      for (std::size_t pointId = 0; pointId < flaggedCells.size(); ++pointId) {
+        flaggedCells[pointId] =
+            normalsFeatureFlag(stencilSnapshot->getStencil(pointId), normals,
+                               cosAngleTreshold);
+      }
+      return;
+    }
+
+    const auto &domain = std::as_const(*levelSet).getDomain();
     std::vector<std::vector<T>> flagsReserve(levelSet->getNumberOfSegments());
 
     // Compare angles between normal vectors
@@ -176,11 +212,8 @@ private:
       p = omp_get_thread_num();
 #endif
 
-      Vec3D<T> zeroVector{};
-
       std::vector<T> &flagsSegment = flagsReserve[p];
-      flagsSegment.reserve(
-          levelSet->getDomain().getDomainSegment(p).getNumberOfPoints());
+      flagsSegment.reserve(domain.getDomainSegment(p).getNumberOfPoints());
 
       viennahrle::Index<D> const startVector =
           (p == 0) ? grid.getMinGridPoint() : domain.getSegmentation()[p - 1];
@@ -190,46 +223,13 @@ private:
               ? domain.getSegmentation()[p]
               : grid.incrementIndices(grid.getMaxGridPoint());
 
-      for (viennahrle::SparseBoxIterator<typename Domain<T, D>::DomainType, 1>
-               neighborIt(levelSet->getDomain(), startVector);
+      for (viennahrle::ConstSparseBoxIterator<typename Domain<T, D>::DomainType,
+                                              1>
+               neighborIt(domain, startVector);
            neighborIt.getIndices() < endVector; neighborIt.next()) {
-        if (!neighborIt.getCenter().isDefined()) {
-          continue;
-        } else if (std::abs(neighborIt.getCenter().getValue()) >= 0.5) {
-          flagsSegment.push_back(0);
-          continue;
-        }
-
-        Vec3D<T> centerNormal = normals[neighborIt.getCenter().getPointId()];
-
-        bool flag = false;
-
-        constexpr unsigned numNeighbors = (D == 3) ? 27 : 9;
-        for (unsigned dir = 0; dir < numNeighbors; dir++) {
-          auto neighbor = neighborIt.getNeighbor(dir);
-          if (!neighbor.isDefined())
-            continue;
-          Vec3D<T> currentNormal = normals[neighbor.getPointId()];
-
-          if (currentNormal != zeroVector) {
-            T skp = 0.;
-            // Calculate scalar product
-            for (int j = 0; j < D; j++) {
-              skp += currentNormal[j] * centerNormal[j];
-            }
-            // Vectors are normlized so skp = cos(alpha)
-            if ((cosAngleTreshold - skp) >= 0.) {
-              flag = true;
-              break;
-            }
-          }
-        }
-
-        if (flag) {
-          flagsSegment.push_back(1);
-        } else {
-          flagsSegment.push_back(0);
-        }
+        if (neighborIt.getCenter().isDefined())
+          flagsSegment.push_back(
+              normalsFeatureFlag(neighborIt, normals, cosAngleTreshold));
       }
     }
 
@@ -237,6 +237,39 @@ private:
       flaggedCells.insert(flaggedCells.end(), flagsReserve[i].begin(),
                           flagsReserve[i].end());
   }
+
+  /// Feature marker of the defined center of neighborIt from the angles
+  /// between its normal vector and the normal vectors of its neighbors.
+  template <class NeighborIterator>
+  static T normalsFeatureFlag(const NeighborIterator &neighborIt,
+                              const std::vector<Vec3D<T>> &normals,
+                              T cosAngleTreshold) {
+    if (std::abs(neighborIt.getCenter().getValue()) >= 0.5)
+      return 0;
+
+    Vec3D<T> zeroVector{};
+    Vec3D<T> centerNormal = normals[neighborIt.getCenter().getPointId()];
+
+    constexpr unsigned numNeighbors = (D == 3) ? 27 : 9;
+    for (unsigned dir = 0; dir < numNeighbors; dir++) {
+      auto neighbor = neighborIt.getNeighbor(dir);
+      if (!neighbor.isDefined())
+        continue;
+      Vec3D<T> currentNormal = normals[neighbor.getPointId()];
+
+      if (currentNormal != zeroVector) {
+        T skp = 0.;
+        // Calculate scalar product
+        for (int j = 0; j < D; j++) {
+          skp += currentNormal[j] * centerNormal[j];
+        }
+        // Vectors are normlized so skp = cos(alpha)
+        if ((cosAngleTreshold - skp) >= 0.)
+          return 1;
+      }
+    }
+    return 0;
+  }
 };
 
 } // namespace viennals
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <vcVectorType.hpp>
+
+namespace lsInternal {
+
+using namespace viennacore;
+
+/// Dissipation coefficients of the points of a level set for one advection
+/// step, indexed by the point id. Local Lax Friedrichs type schemes evaluate
+/// the velocity field at every point of their stencil to find the
+/// coefficients, so neighbouring active points would otherwise evaluate the
+/// same stencil points over and over again. The cache can be filled and read
+/// concurrently: the first thread to calculate the coefficients of a point
+/// stores them, all others only read them.
+template <class T, int D> class DissipationCache {
+  // 0: empty, -1: currently being written, material + 1: stored
+  std::vector<std::atomic<int>> states;
+  std::vector<VectorType<T, D>> alphas;
+
+public:
+  DissipationCache() = default;
+
+  /// Remove all stored coefficients and prepare the cache to hold
+  /// numberOfPoints points.
+  void reset(std::size_t numberOfPoints) {
+    states = std::vector<std::atomic<int>>(numberOfPoints);
+    alphas.resize(numberOfPoints);
+  }
+
+  void clear() {
+    states.clear();
+    alphas.clear();
+  }
+
+  bool empty() const { return states.empty(); }
+
+  std::size_t size() const { return states.size(); }
+
+  /// Returns the coefficients of the point stored for the given material. If
+  /// they have not been stored yet, they are calculated by calling
+  /// calculateAlphas and stored in the cache.
+  template <class AlphaFunction>
+  VectorType<T, D> get(std::size_t pointId, int material,
+                       AlphaFunction &&calculateAlphas) {
+    if (pointId >= states.size())
+      return calculateAlphas();
+
+    auto &state = states[pointId];
+    int stored = state.load(std::memory_order_acquire);
+    if (stored == material + 1)
+      return alphas[pointId];
+
+    const VectorType<T, D> result = calculateAlphas();
+
+    // only store if no other thread has claimed this entry
+    if (stored == 0 && state.compare_exchange_strong(
+                           stored, -1, std::memory_order_acq_rel)) {
+      alphas[pointId] = result;
+      state.store(material + 1, std::memory_order_release);
+    }
+    return result;
+  }
+};
+
+} // namespace lsInternal
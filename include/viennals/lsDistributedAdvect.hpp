@@ -0,0 +1,465 @@
+#pragma once
+
+#ifdef VIENNALS_USE_MPI // this class needs MPI support
+
+#include <mpi.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hrleSparseIterator.hpp>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsPreCompileMacros.hpp>
+
+#include <vcLogger.hpp>
+#include <vcSmartPointer.hpp>
+
+namespace viennals {
+
+using namespace viennacore;
+
+/// Advects level sets, which are distributed among the processes of an MPI
+/// communicator. The grid is split into slabs along the last dimension, which
+/// is the dimension the HRLE domains are segmented along, and every process
+/// advects the points of its slab with its own Advect kernel, which also
+/// expands and rebuilds its level sets. Before every time step, the
+/// processes exchange ghost layers of the neighbouring slabs and the largest
+/// stable time step is reduced over all processes, so all of them perform
+/// the same time steps. The ghost layers are wide enough for the stencil of
+/// the spatial scheme and the expansion of the level sets in all stages of
+/// the temporal scheme, see getGhostWidth(). The slabs are chosen on the
+/// first call to apply(), so that they hold a similar number of points of
+/// the advected level set. The first and the last slab are open, so the
+/// level sets may grow beyond their initial extent.
+/// Every process has to pass level sets on the same grid, which contain at
+/// least the points of its slab, e.g. the full level sets. After apply(),
+/// each process holds the points of its slab and its ghost layers. The full
+/// level sets can be collected on one process using gatherLevelSet(). Point
+/// data is not transferred between the processes and is cleared, and the
+/// point ids passed to the velocity field are local to each process.
+template <class T, int D, class VelocityType = VelocityField<T>>
+class DistributedAdvect {
+  using PointValueVectorType = typename Domain<T, D>::PointValueVectorType;
+  using ConstSparseIterator =
+      viennahrle::ConstSparseIterator<typename Domain<T, D>::DomainType>;
+
+  std::vector<SmartPointer<Domain<T, D>>> levelSets;
+  SmartPointer<VelocityType> velocities = nullptr;
+  MPI_Comm communicator = MPI_COMM_WORLD;
+  SpatialSchemeEnum spatialScheme = SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER;
+  TemporalSchemeEnum temporalScheme = TemporalSchemeEnum::FORWARD_EULER;
+  double timeStepRatio = 0.4999;
+  bool calculateNormalVectors = true;
+  double advectionTime = 0.;
+  bool performOnlySingleStep = false;
+  double advectedTime = 0.;
+  unsigned numberOfTimeSteps = 0;
+  int rank = 0;
+  int numberOfProcesses = 1;
+  // the slab of this process is [slabMin, slabMax) along the last dimension
+  bool slabsInitialized = false;
+  viennahrle::IndexType slabMin =
+      std::numeric_limits<viennahrle::IndexType>::min();
+  viennahrle::IndexType slabMax =
+      std::numeric_limits<viennahrle::IndexType>::max();
+
+  int getStencilRadius() const {
+    switch (spatialScheme) {
+    case SpatialSchemeEnum::ENGQUIST_OSHER_2ND_ORDER:
+    case SpatialSchemeEnum::LAX_FRIEDRICHS_2ND_ORDER:
+    case SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_2ND_ORDER:
+    case SpatialSchemeEnum::LOCAL_LOCAL_LAX_FRIEDRICHS_2ND_ORDER:
+    case SpatialSchemeEnum::WENO_3RD_ORDER:
+      return 2;
+    case SpatialSchemeEnum::WENO_5TH_ORDER:
+      return 3;
+    default:
+      return 1;
+    }
+  }
+
+  // number of layers added by the prepareLS() function of the scheme
+  int getExpansionWidth() const {
+    const int radius = getStencilRadius();
+    switch (spatialScheme) {
+    case SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_1ST_ORDER:
+    case SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_2ND_ORDER:
+    case SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_ANALYTICAL_1ST_ORDER:
+      return 2 * (radius + 2) + 1;
+    case SpatialSchemeEnum::STENCIL_LOCAL_LAX_FRIEDRICHS_1ST_ORDER:
+      return 8;
+    default:
+      return 2 * radius + 1;
+    }
+  }
+
+  unsigned getNumberOfStages() const {
+    switch (temporalScheme) {
+    case TemporalSchemeEnum::RUNGE_KUTTA_2ND_ORDER:
+      return 2;
+    case TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER:
+    case TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER_ADAPTIVE:
+      return 3;
+    default:
+      return 1;
+    }
+  }
+
+  bool isOwned(viennahrle::IndexType index) const {
+    return index >= slabMin && index < slabMax;
+  }
+
+  PointValueVectorType getOwnedPoints(const Domain<T, D> &levelSet) const {
+    PointValueVectorType points;
+    for (ConstSparseIterator it(levelSet.getDomain()); !it.isFinished();
+         it.next()) {
+      if (it.isDefined() && isOwned(it.getStartIndices(D - 1)))
+        points.emplace_back(it.getStartIndices(), it.getValue());
+    }
+    return points;
+  }
+
+  MPI_Datatype createPointType() const {
+    MPI_Datatype pointType;
+    MPI_Type_contiguous(
+        static_cast<int>(sizeof(typename PointValueVectorType::value_type)),
+        MPI_BYTE, &pointType);
+    MPI_Type_commit(&pointType);
+    return pointType;
+  }
+
+  /// Chooses the slabs, so that all of them hold a similar number of points
+  /// of the advected level set. All slabs, apart from the first and the last
+  /// one, are at least as thick as the ghost layers, so the ghost layers
+  /// are always sent by the neighbouring processes.
+  bool computeSlabs() {
+    const auto &domain = std::as_const(*levelSets.back()).getDomain();
+    const auto ghostWidth = getGhostWidth();
+
+    // extent of all level sets along the last dimension, the lower bound is
+    // negated, so both bounds are reduced using the maximum
+    long long bounds[2] = {std::numeric_limits<long long>::lowest(),
+                           std::numeric_limits<long long>::lowest()};
+    for (ConstSparseIterator it(domain); !it.isFinished(); it.next()) {
+      if (!it.isDefined())
+        continue;
+      const long long index = it.getStartIndices(D - 1);
+      bounds[0] = std::max(bounds[0], -index);
+      bounds[1] = std::max(bounds[1], index);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, bounds, 2, MPI_LONG_LONG, MPI_MAX,
+                  communicator);
+    const long long minIndex = -bounds[0];
+    const long long maxIndex = bounds[1];
+    if (maxIndex < minIndex) {
+      VIENNACORE_LOG_ERROR(
+          "DistributedAdvect: No points in level sets. Not advecting.");
+      return false;
+    }
+
+    std::vector<unsigned long long> histogram(maxIndex - minIndex + 1, 0);
+    for (ConstSparseIterator it(domain); !it.isFinished(); it.next()) {
+      if (it.isDefined())
+        ++histogram[it.getStartIndices(D - 1) - minIndex];
+    }
+    MPI_Allreduce(MPI_IN_PLACE, histogram.data(),
+                  static_cast<int>(histogram.size()), MPI_UNSIGNED_LONG_LONG,
+                  MPI_SUM, communicator);
+
+    unsigned long long numberOfPoints = 0;
+    for (auto count : histogram)
+      numberOfPoints += count;
+
+    // cuts[p] is the first index of the slab of process p
+    std::vector<long long> cuts(numberOfProcesses + 1);
+    cuts[0] = std::numeric_limits<viennahrle::IndexType>::min();
+    cuts[numberOfProcesses] = std::numeric_limits<viennahrle::IndexType>::max();
+    long long index = minIndex;
+    unsigned long long pointsBelow = 0;
+    for (int p = 1; p < numberOfProcesses; ++p) {
+      const unsigned long long target = numberOfPoints * p / numberOfProcesses;
+      while (index <= maxIndex && pointsBelow < target) {
+        pointsBelow += histogram[index - minIndex];
+        ++index;
+      }
+      cuts[p] = (p > 1) ? std::max(index, cuts[p - 1] + ghostWidth) : index;
+      // skip the points of slabs which were made thicker
+      while (index < cuts[p]) {
+        if (index <= maxIndex)
+          pointsBelow += histogram[index - minIndex];
+        ++index;
+      }
+    }
+
+    slabMin = static_cast<viennahrle::IndexType>(cuts[rank]);
+    slabMax = static_cast<viennahrle::IndexType>(cuts[rank + 1]);
+    slabsInitialized = true;
+    return true;
+  }
+
+  /// Sends the points to the process destination and receives the points of
+  /// the process source. Either may be MPI_PROC_NULL.
+  PointValueVectorType sendReceive(const PointValueVectorType &points,
+                                   int destination, int source,
+                                   MPI_Datatype pointType) const {
+    unsigned long long sendCount = points.size();
+    unsigned long long receiveCount = 0;
+    MPI_Sendrecv(&sendCount, 1, MPI_UNSIGNED_LONG_LONG, destination, 0,
+                 &receiveCount, 1, MPI_UNSIGNED_LONG_LONG, source, 0,
+                 communicator, MPI_STATUS_IGNORE);
+
+    PointValueVectorType received(receiveCount);
+    MPI_Sendrecv(points.data(), static_cast<int>(sendCount), pointType,
+                 destination, 1, received.data(),
+                 static_cast<int>(receiveCount), pointType, source, 1,
+                 communicator, MPI_STATUS_IGNORE);
+    return received;
+  }
+
+  /// Replaces the ghost layers of all level sets by the points of the
+  /// neighbouring processes.
+  void exchangeGhostLayers() {
+    const auto ghostWidth = getGhostWidth();
+    const int lowerProcess = (rank > 0) ? rank - 1 : MPI_PROC_NULL;
+    const int upperProcess =
+        (rank < numberOfProcesses - 1) ? rank + 1 : MPI_PROC_NULL;
+    auto pointType = createPointType();
+
+    for (auto &levelSet : levelSets) {
+      auto ownedPoints = getOwnedPoints(*levelSet);
+
+      // the points are sorted with the last dimension being the most
+      // significant, so the points of each ghost layer are contiguous
+      PointValueVectorType lowerPoints, upperPoints;
+      for (const auto &point : ownedPoints) {
+        const auto index = point.first[D - 1];
+        if (lowerProcess != MPI_PROC_NULL && index < slabMin + ghostWidth)
+          lowerPoints.push_back(point);
+        if (upperProcess != MPI_PROC_NULL && index >= slabMax - ghostWidth)
+          upperPoints.push_back(point);
+      }
+
+      auto upperGhosts =
+          sendReceive(lowerPoints, lowerProcess, upperProcess, pointType);
+      auto lowerGhosts =
+          sendReceive(upperPoints, upperProcess, lowerProcess, pointType);
+
+      // the ghost layers lie below and above the slab, so the points stay
+      // sorted and do not have to be sorted again
+      PointValueVectorType points = std::move(lowerGhosts);
+      points.insert(points.end(), ownedPoints.begin(), ownedPoints.end());
+      points.insert(points.end(), upperGhosts.begin(), upperGhosts.end());
+
+      levelSet->clearMetaData();
+      levelSet->insertPoints(std::move(points), false);
+      levelSet->getDomain().segment();
+    }
+
+    MPI_Type_free(&pointType);
+  }
+
+public:
+  DistributedAdvect() = default;
+
+  DistributedAdvect(SmartPointer<Domain<T, D>> passedlsDomain,
+                    SmartPointer<VelocityType> passedVelocities,
+                    MPI_Comm passedCommunicator = MPI_COMM_WORLD)
+      : velocities(passedVelocities), communicator(passedCommunicator) {
+    levelSets.push_back(passedlsDomain);
+  }
+
+  DistributedAdvect(std::vector<SmartPointer<Domain<T, D>>> passedlsDomains,
+                    SmartPointer<VelocityType> passedVelocities,
+                    MPI_Comm passedCommunicator = MPI_COMM_WORLD)
+      : levelSets(passedlsDomains), velocities(passedVelocities),
+        communicator(passedCommunicator) {}
+
+  /// Pushes the passed level set to the back of the list of level sets
+  /// used for advection.
+  void insertNextLevelSet(SmartPointer<Domain<T, D>> passedlsDomain) {
+    levelSets.push_back(passedlsDomain);
+  }
+
+  void setVelocityField(SmartPointer<VelocityType> passedVelocities) {
+    velocities = passedVelocities;
+  }
+
+  /// Set the communicator of the processes the level sets are distributed
+  /// among. Defaults to MPI_COMM_WORLD. This chooses new slabs.
+  void setCommunicator(MPI_Comm passedCommunicator) {
+    communicator = passedCommunicator;
+    slabsInitialized = false;
+  }
+
+  /// Set the time until when the level sets should be advected, see
+  /// Advect::setAdvectionTime.
+  void setAdvectionTime(double time) { advectionTime = time; }
+
+  /// If set to true, only a single advection step will be performed.
+  void setSingleStep(bool singleStep) { performOnlySingleStep = singleStep; }
+
+  /// Set the CFL condition to use during advection, see
+  /// Advect::setTimeStepRatio.
+  void setTimeStepRatio(const double &cfl) { timeStepRatio = cfl; }
+
+  void setCalculateNormalVectors(bool cnv) { calculateNormalVectors = cnv; }
+
+  /// Set the spatial discretization scheme. Should be called before the
+  /// first call to apply(), since it changes the width of the ghost layers.
+  void setSpatialScheme(SpatialSchemeEnum scheme) { spatialScheme = scheme; }
+
+  /// Set the temporal scheme. The error estimate of the adaptive third
+  /// order Runge-Kutta scheme is local to each process, so it is replaced by
+  /// the third order Runge-Kutta scheme. Should be called before the first
+  /// call to apply(), since it changes the width of the ghost layers.
+  void setTemporalScheme(TemporalSchemeEnum scheme) {
+    if (scheme == TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER_ADAPTIVE) {
+      VIENNACORE_LOG_WARNING(
+          "DistributedAdvect: Adaptive time stepping is not supported. Using "
+          "RUNGE_KUTTA_3RD_ORDER instead.");
+      scheme = TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER;
+    }
+    temporalScheme = scheme;
+  }
+
+  /// Returns the width of the ghost layers in grid points. The values of
+  /// the points near the boundary of the ghost layers are wrong, since
+  /// their neighbours are missing. In each stage of the temporal scheme,
+  /// the error spreads by the expansion of the level sets and by the stencil
+  /// of the spatial scheme, and rebuilding the level sets spreads it by one
+  /// more grid point.
+  viennahrle::IndexType getGhostWidth() const {
+    return getNumberOfStages() * (getStencilRadius() + getExpansionWidth()) +
+           1;
+  }
+
+  /// Returns the first index and the index past the end of the slab of this
+  /// process along the last dimension. The slabs are chosen on the first
+  /// call to apply().
+  std::pair<viennahrle::IndexType, viennahrle::IndexType>
+  getSlabBounds() const {
+    return {slabMin, slabMax};
+  }
+
+  /// Get by how much the level sets were advected on the last apply() call.
+  /// It is the same on all processes.
+  double getAdvectedTime() const { return advectedTime; }
+
+  unsigned getNumberOfTimeSteps() const { return numberOfTimeSteps; }
+
+  /// Collects the points of the level set with the passed index from the
+  /// slabs of all processes on the process root. Has to be called on all
+  /// processes. Returns the full level set on the process root and nullptr
+  /// on all other processes.
+  SmartPointer<Domain<T, D>> gatherLevelSet(unsigned levelSetIndex,
+                                            int root = 0) {
+    if (levelSetIndex >= levelSets.size()) {
+      VIENNACORE_LOG_ERROR("DistributedAdvect: No level set with index " +
+                           std::to_string(levelSetIndex) + ".");
+      return nullptr;
+    }
+    if (!slabsInitialized) {
+      VIENNACORE_LOG_ERROR("DistributedAdvect: Level sets have not been "
+                           "distributed yet. Call apply() first.");
+      return nullptr;
+    }
+
+    const auto &levelSet = levelSets[levelSetIndex];
+    auto points = getOwnedPoints(*levelSet);
+    int numberOfPoints = static_cast<int>(points.size());
+    std::vector<int> counts(numberOfProcesses, 0);
+    MPI_Gather(&numberOfPoints, 1, MPI_INT, counts.data(), 1, MPI_INT, root,
+               communicator);
+
+    // the slabs are ordered by rank, so the gathered points stay sorted
+    std::vector<int> displacements(numberOfProcesses, 0);
+    PointValueVectorType gatheredPoints;
+    if (rank == root) {
+      for (int p = 1; p < numberOfProcesses; ++p)
+        displacements[p] = displacements[p - 1] + counts[p - 1];
+      gatheredPoints.resize(displacements.back() + counts.back());
+    }
+
+    auto pointType = createPointType();
+    MPI_Gatherv(points.data(), numberOfPoints, pointType,
+                gatheredPoints.data(), counts.data(), displacements.data(),
+                pointType, root, communicator);
+    MPI_Type_free(&pointType);
+
+    if (rank != root)
+      return nullptr;
+
+    auto gatheredLevelSet = Domain<T, D>::New(levelSet->getGrid());
+    gatheredLevelSet->insertPoints(std::move(gatheredPoints), false);
+    gatheredLevelSet->getDomain().segment();
+    gatheredLevelSet->finalize(levelSet->getLevelSetWidth());
+    return gatheredLevelSet;
+  }
+
+  /// Advects the level sets. Has to be called on all processes.
+  void apply() {
+    if (levelSets.empty()) {
+      VIENNACORE_LOG_ERROR(
+          "No level sets passed to DistributedAdvect. Not advecting.");
+      return;
+    }
+    if (velocities == nullptr) {
+      VIENNACORE_LOG_ERROR(
+          "No velocity field passed to DistributedAdvect. Not advecting.");
+      return;
+    }
+
+    MPI_Comm_rank(communicator, &rank);
+    MPI_Comm_size(communicator, &numberOfProcesses);
+
+    if (numberOfProcesses > 1 &&
+        levelSets.back()->getGrid().isBoundaryPeriodic(D - 1)) {
+      VIENNACORE_LOG_ERROR("DistributedAdvect: Periodic boundary conditions "
+                           "are not supported along the last dimension. Not "
+                           "advecting.");
+      return;
+    }
+
+    if (!slabsInitialized && !computeSlabs())
+      return;
+
+    Advect<T, D, VelocityType> advectionKernel(levelSets, velocities);
+    advectionKernel.setSpatialScheme(spatialScheme);
+    advectionKernel.setTemporalScheme(temporalScheme);
+    advectionKernel.setTimeStepRatio(timeStepRatio);
+    advectionKernel.setCalculateNormalVectors(calculateNormalVectors);
+    advectionKernel.setSingleStep(true);
+    // all processes use the smallest stable time step
+    advectionKernel.setTimeStepReduction([this](double timeStep) {
+      MPI_Allreduce(MPI_IN_PLACE, &timeStep, 1, MPI_DOUBLE, MPI_MIN,
+                    communicator);
+      return timeStep;
+    });
+
+    advectedTime = 0.;
+    numberOfTimeSteps = 0;
+    do {
+      exchangeGhostLayers();
+      advectionKernel.setAdvectionTime(
+          (advectionTime == 0.) ? 0. : advectionTime - advectedTime);
+      advectionKernel.apply();
+      advectedTime += advectionKernel.getAdvectedTime();
+      ++numberOfTimeSteps;
+    } while (!performOnlySingleStep && advectedTime < advectionTime);
+
+    // the ghost layers are only valid at the start of a time step
+    exchangeGhostLayers();
+  }
+};
+
+// add all template specialisations for this class
+PRECOMPILE_PRECISION_DIMENSION(DistributedAdvect)
+
+} // namespace viennals
+
+#endif // VIENNALS_USE_MPI
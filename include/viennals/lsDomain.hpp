@@ -2,8 +2,14 @@
 
 #include <lsPreCompileMacros.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <limits>
+#include <list>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <hrleDomain.hpp>
 #include <hrleFillDomainWithSignedDistance.hpp>
@@ -28,6 +34,11 @@ template <class T, int D> class Domain {
 public:
   // TYPEDEFS
   typedef T ValueType;
+  /// Type in which algorithms accumulate changes of the values. Values
+  /// stored in single precision are updated in double precision, so only
+  /// the result is rounded, which halves the memory of the values without
+  /// losing accuracy over many time steps.
+  typedef std::common_type_t<T, double> AccumulationType;
   typedef viennahrle::Grid<D> GridType;
   typedef viennahrle::Domain<T, D> DomainType;
   typedef BoundaryConditionEnum BoundaryType;
@@ -42,6 +53,158 @@ private:
   int levelSetWidth = 1;
   PointDataType pointData;
   VoidPointMarkersType voidPointMarkers;
+  // scratch domain on the same grid, which algorithms fill with their result
+  DomainType buffer;
+  bool bufferInitialized = false;
+  bool keepBuffer = false;
+  // copy on write snapshots, see deepCopyOnWrite(): the level set whose
+  // values this level set still shares and the level sets sharing the values
+  // of this level set
+  Domain *snapshotSource = nullptr;
+  std::vector<Domain *> snapshots;
+  // values replaced by swapBuffer() while snapshots still shared them, which
+  // are kept until no snapshot shares them anymore, instead of copying them
+  // into the snapshots
+  struct RetainedValues {
+    DomainType domain;
+    PointDataType pointData;
+    std::vector<Domain *> snapshots;
+  };
+  std::list<RetainedValues> retainedValues;
+  // the retained values of snapshotSource this snapshot shares, nullptr if
+  // it shares the current values of snapshotSource
+  RetainedValues *sharedRetainedValues = nullptr;
+  // identifies the current values, see getVersion()
+  std::size_t version = newVersion();
+
+  static std::size_t newVersion() {
+    static std::atomic<std::size_t> lastVersion{0};
+    return ++lastVersion;
+  }
+
+  /// Copy the values of this level set into all snapshots sharing them.
+  void copyIntoSnapshots() {
+    while (!snapshots.empty())
+      snapshots.back()->resolveSnapshot();
+  }
+
+  /// Copy the retained values into all snapshots sharing them, which frees
+  /// them. Must be called before the grid is changed, since the retained
+  /// values are defined on it.
+  void releaseRetainedValues() {
+    // the retained values are removed once their last snapshot is resolved
+    while (!retainedValues.empty())
+      retainedValues.front().snapshots.back()->resolveSnapshot();
+  }
+
+  /// The level set whose grid the values of this level set are defined on.
+  const Domain &valueOwner() const {
+    return (snapshotSource != nullptr) ? *snapshotSource : *this;
+  }
+
+  /// The values of this level set, which are shared with the source if this
+  /// level set is a snapshot.
+  const DomainType &sharedDomain() const {
+    if (sharedRetainedValues != nullptr)
+      return sharedRetainedValues->domain;
+    return valueOwner().domain;
+  }
+
+  const PointDataType &sharedPointData() const {
+    if (sharedRetainedValues != nullptr)
+      return sharedRetainedValues->pointData;
+    return valueOwner().pointData;
+  }
+
+  /// Copy the values of source, which may be a snapshot, into this level
+  /// set.
+  void copyFrom(const Domain &source) {
+    grid = source.valueOwner().grid;
+    domain.deepCopy(grid, source.sharedDomain());
+    levelSetWidth = source.levelSetWidth;
+    pointData = source.sharedPointData();
+    // the grid might have changed, so the buffer is set up again when needed
+    bufferInitialized = false;
+  }
+
+  /// Stop sharing the values of the source level set without copying them.
+  void detachFromSource() {
+    if (snapshotSource == nullptr)
+      return;
+    auto &sourceSnapshots = (sharedRetainedValues != nullptr)
+                                ? sharedRetainedValues->snapshots
+                                : snapshotSource->snapshots;
+    sourceSnapshots.erase(
+        std::find(sourceSnapshots.begin(), sourceSnapshots.end(), this));
+    // retained values are only kept while they are shared
+    if (sharedRetainedValues != nullptr && sourceSnapshots.empty()) {
+      snapshotSource->retainedValues.remove_if(
+          [this](const RetainedValues &values) {
+            return &values == sharedRetainedValues;
+          });
+    }
+    snapshotSource = nullptr;
+    sharedRetainedValues = nullptr;
+  }
+
+  /// Start sharing the values of source, which are retained if retained is
+  /// not nullptr.
+  void attachToSource(Domain *source, RetainedValues *retained) {
+    snapshotSource = source;
+    sharedRetainedValues = retained;
+    if (retained != nullptr)
+      retained->snapshots.push_back(this);
+    else
+      source->snapshots.push_back(this);
+  }
+
+  /// Copy the values of passedDomain into this level set, taking care of the
+  /// snapshots of both level sets.
+  void assignFrom(const Domain &passedDomain) {
+    if (&passedDomain == this)
+      return;
+
+    if (passedDomain.snapshotSource == this) {
+      // restoring a snapshot which still shares the values of this level
+      // set, i.e. this level set has not changed since the snapshot was
+      // taken
+      if (passedDomain.sharedRetainedValues == nullptr)
+        return;
+      // restoring a snapshot of values replaced since then, which are
+      // installed again without copying them
+      restoreRetainedValues(*passedDomain.sharedRetainedValues);
+      levelSetWidth = passedDomain.levelSetWidth;
+      return;
+    }
+
+    releaseSnapshots();
+    releaseRetainedValues();
+    detachFromSource();
+    copyFrom(passedDomain);
+  }
+
+  /// Installs the retained values as the current values of this level set.
+  /// The snapshots sharing them then share the current values.
+  void restoreRetainedValues(RetainedValues &retained) {
+    releaseSnapshots();
+    domain = std::move(retained.domain);
+    pointData = std::move(retained.pointData);
+    snapshots = std::move(retained.snapshots);
+    for (auto *snapshot : snapshots)
+      snapshot->sharedRetainedValues = nullptr;
+    retainedValues.remove_if([&retained](const RetainedValues &values) {
+      return &values == &retained;
+    });
+  }
+
+  /// If this level set is a snapshot which still shares the values of its
+  /// source, copy them now.
+  void resolveSnapshot() {
+    if (snapshotSource == nullptr)
+      return;
+    copyFrom(*this);
+    detachFromSource();
+  }
 
 public:
   // STATIC CONSTANTS
@@ -107,6 +270,21 @@ public:
 
   Domain(SmartPointer<Domain> passedDomain) { deepCopy(passedDomain); }
 
+  /// Copies are never snapshots, they hold their own values.
+  Domain(const Domain &passedDomain) { copyFrom(passedDomain); }
+
+  Domain &operator=(const Domain &passedDomain) {
+    assignFrom(passedDomain);
+    return *this;
+  }
+
+  ~Domain() {
+    // snapshots cannot share the values of this level set anymore
+    releaseSnapshots();
+    releaseRetainedValues();
+    detachFromSource();
+  }
+
   // Convenience function to create a new domain.
   template <class... Args> static auto New(Args &&...args) {
     return SmartPointer<Domain>::New(std::forward<Args>(args)...);
@@ -122,10 +300,126 @@ public:
 
   /// copy all values of "passedDomain" to this Domain
   void deepCopy(const SmartPointer<Domain<T, D>> passedDomain) {
-    grid = passedDomain->grid;
-    domain.deepCopy(grid, passedDomain->domain);
+    assignFrom(*passedDomain);
+  }
+
+  /// Makes this level set a copy of passedDomain in constant time. Both
+  /// share the same values until passedDomain is modified in place, which
+  /// copies them into this level set first. If the values of passedDomain
+  /// are replaced using swapBuffer(), the previous values are kept for this
+  /// level set instead of copying them, and restoring passedDomain from this
+  /// level set installs them again without copying. Modifying the values of
+  /// this level set or accessing them through a non const member function
+  /// copies them as well. This is useful for snapshots which are often
+  /// restored without any changes, e.g. of level sets which might be changed
+  /// during a time step of advection. Not thread safe.
+  void deepCopyOnWrite(const SmartPointer<Domain<T, D>> passedDomain) {
+    if (passedDomain.get() == this)
+      return;
+    Domain *source = (passedDomain->snapshotSource != nullptr)
+                         ? passedDomain->snapshotSource
+                         : passedDomain.get();
+    if (source == this) {
+      // passedDomain is a snapshot of this level set
+      assignFrom(*passedDomain);
+      return;
+    }
+    if (source == snapshotSource &&
+        passedDomain->sharedRetainedValues == sharedRetainedValues)
+      return;
+
+    releaseSnapshots();
+    releaseRetainedValues();
+    detachFromSource();
+    grid = source->grid;
     levelSetWidth = passedDomain->levelSetWidth;
-    pointData = passedDomain->pointData;
+    bufferInitialized = false;
+    attachToSource(source, passedDomain->sharedRetainedValues);
+  }
+
+  /// Whether this level set is a snapshot which still shares the values of
+  /// another level set.
+  bool isSharingValues() const { return snapshotSource != nullptr; }
+
+  /// Copies the values of this level set into all snapshots which still
+  /// share them and marks the values as changed, see getVersion(). This is
+  /// done automatically by all member functions which might change the
+  /// values, including the non const getDomain().
+  void releaseSnapshots() {
+    copyIntoSnapshots();
+    version = newVersion();
+  }
+
+  /// Number identifying the current values of the level set, which is
+  /// unique among all level sets of this type. It changes whenever the
+  /// values are changed by a member function or releaseSnapshots() is
+  /// called, so data derived from the values, e.g. a StencilSnapshot, can
+  /// check whether it is still up to date.
+  std::size_t getVersion() const { return version; }
+
+  /// Stops sharing the values of the level set this level set is a snapshot
+  /// of, without copying them. Afterwards, the values of this level set are
+  /// undefined until they are set again.
+  void discardSnapshot() { detachFromSource(); }
+
+  /// Returns an hrleDomain on the grid of this level set, which is not part
+  /// of the level set. Algorithms can write their result into it and install
+  /// it using swapBuffer(), instead of creating a new level set and copying
+  /// it into this one. A snapshot keeps sharing its values while the buffer
+  /// is filled, so they should be read through the const accessors.
+  DomainType &getBufferDomain() {
+    if (!bufferInitialized) {
+      buffer.deepCopy(grid, DomainType(grid, T(POS_VALUE)));
+      bufferInitialized = true;
+    }
+    return buffer;
+  }
+
+  /// Installs the buffer domain as the values of this level set and
+  /// newPointData as its point data without copying them. If snapshots
+  /// share the previous values, they are retained for them. Otherwise, they
+  /// are freed, unless the buffer is kept, see setKeepBuffer().
+  void swapBuffer(PointDataType newPointData = PointDataType()) {
+    auto &newDomain = getBufferDomain();
+    // the shared values of a snapshot are replaced, so they are not copied
+    detachFromSource();
+    if (snapshots.empty()) {
+      std::swap(domain, newDomain);
+      if (!keepBuffer)
+        clearBuffer();
+    } else {
+      auto &retained = retainedValues.emplace_back();
+      retained.domain = std::move(domain);
+      retained.pointData = std::move(pointData);
+      retained.snapshots = std::move(snapshots);
+      snapshots.clear();
+      for (auto *snapshot : retained.snapshots)
+        snapshot->sharedRetainedValues = &retained;
+      domain = std::move(newDomain);
+      bufferInitialized = false;
+    }
+    pointData = std::move(newPointData);
+    version = newVersion();
+  }
+
+  /// Set whether swapBuffer() should keep the previous values as the buffer
+  /// domain, so the two domains are used in turn by subsequent algorithms
+  /// without allocating new memory. This is useful while algorithms are
+  /// applied to the level set repeatedly, e.g. during advection, but the
+  /// buffer holds a second copy of the values, so it is freed when this is
+  /// disabled. Defaults to false.
+  void setKeepBuffer(bool keep) {
+    keepBuffer = keep;
+    if (!keepBuffer)
+      clearBuffer();
+  }
+
+  bool getKeepBuffer() const { return keepBuffer; }
+
+  /// Frees the memory held by the buffer domain.
+  void clearBuffer() {
+    buffer = DomainType();
+    bufferInitialized = false;
   }
 
   /// re-initalise Domain with the point/value pairs in pointData
@@ -133,6 +427,9 @@ public:
   /// contains (INDEX, Value) pairs, while lsFromMesh expects coordinates
   /// rather than indices
   void insertPoints(PointValueVectorType pointData, bool sort = true) {
+    releaseSnapshots();
+    // the values are replaced, so shared values are not copied
+    detachFromSource();
     viennahrle::FillDomainWithSignedDistance(domain, pointData, T(NEG_VALUE),
                                              T(POS_VALUE), sort);
   }
@@ -143,29 +440,45 @@ public:
   /// get mutable reference to the grid on which the level set is defined
   GridType &getGrid() { return grid; }
 
-  /// get const reference to the underlying hrleDomain data structure
-  DomainType &getDomain() { return domain; }
+  /// get reference to the underlying hrleDomain data structure, which might
+  /// be changed through it. The values are copied into the snapshots sharing
+  /// them and marked as changed, see getVersion(), so the const version
+  /// should be used to only read them.
+  DomainType &getDomain() {
+    resolveSnapshot();
+    releaseSnapshots();
+    return domain;
+  }
 
-  const DomainType &getDomain() const { return domain; }
+  /// get const reference to the underlying hrleDomain data structure. The
+  /// values of a snapshot are read from the level set it shares them with.
+  const DomainType &getDomain() const { return sharedDomain(); }
 
   /// returns the number of segments, the levelset is split into.
   /// This is useful for algorithm parallelisation
-  unsigned getNumberOfSegments() const { return domain.getNumberOfSegments(); }
+  unsigned getNumberOfSegments() const {
+    return getDomain().getNumberOfSegments();
+  }
 
   /// returns the number of defined points
-  unsigned getNumberOfPoints() const { return domain.getNumberOfPoints(); }
+  unsigned getNumberOfPoints() const { return getDomain().getNumberOfPoints(); }
 
   int getLevelSetWidth() const { return levelSetWidth; }
 
   void setLevelSetWidth(int width) { levelSetWidth = width; }
 
   // clear all additional data
-  void clearMetaData() { pointData.clear(); }
+  void clearMetaData() { getPointData().clear(); }
 
   /// get reference to point data saved in the level set
-  PointDataType &getPointData() { return pointData; }
+  PointDataType &getPointData() {
+    // the point data might be changed through the reference
+    copyIntoSnapshots();
+    resolveSnapshot();
+    return pointData;
+  }
 
-  const PointDataType &getPointData() const { return pointData; }
+  const PointDataType &getPointData() const { return sharedPointData(); }
 
   /// get reference to the voidPoints markers for all points
   VoidPointMarkersType &getVoidPointMarkers() { return voidPointMarkers; }
@@ -176,6 +489,7 @@ public:
 
   /// prints basic information and all memebers of the levelset structure
   void print(std::ostream &out = std::cout) {
+    resolveSnapshot();
     out << "Grid pointer: " << &grid << std::endl;
     out << "lsDomain: " << &domain << std::endl;
     out << "DomainSegments: " << std::endl;
@@ -187,6 +501,8 @@ public:
 
   /// Serializes the Domain into a binary stream
   std::ostream &serialize(std::ostream &stream) {
+    resolveSnapshot();
+
     // Save header to identify Domain
     stream << "lsDomain";
 
@@ -218,6 +534,10 @@ public:
 
   /// Deserialize Domain from binary stream
   std::istream &deserialize(std::istream &stream) {
+    releaseSnapshots();
+    releaseRetainedValues();
+    detachFromSource();
+
     // Check identifier
     char identifier[8];
     stream.read(identifier, 8);
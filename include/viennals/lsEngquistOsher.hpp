@@ -4,6 +4,8 @@
 
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
+#include <lsStencilBatch.hpp>
+#include <lsVelocityCache.hpp>
 #include <lsVelocityField.hpp>
 
 #include <vcVectorType.hpp>
@@ -15,11 +17,15 @@ using namespace viennacore;
 /// Engquist-Osher spatial discretization scheme based on the
 /// upwind spatial discretization scheme. Offers high performance
 /// but lower accuracy for complex velocity fields.
-template <class T, int D, int order> class EngquistOsher {
+template <class T, int D, int order,
+          class VelocityType = viennals::VelocityField<T>>
+class EngquistOsher {
   SmartPointer<viennals::Domain<T, D>> levelSet;
-  SmartPointer<viennals::VelocityField<T>> velocities;
+  SmartPointer<VelocityType> velocities;
+  const VelocityCache<T> *velocityCache = nullptr;
   viennahrle::ConstSparseStarIterator<viennahrle::Domain<T, D>, order>
       neighborIterator;
+  StencilBatch<T, D, order> stencils;
   const bool calculateNormalVectors;
   const double gridDelta;
 
@@ -32,13 +38,19 @@ public:
   }
 
   EngquistOsher(SmartPointer<viennals::Domain<T, D>> passedlsDomain,
-                SmartPointer<viennals::VelocityField<T>> vel,
-                bool calcNormal = true)
+                SmartPointer<VelocityType> vel, bool calcNormal = true)
       : levelSet(passedlsDomain), velocities(vel),
-        neighborIterator(levelSet->getDomain()),
+        neighborIterator(std::as_const(*levelSet).getDomain()),
+        stencils(std::as_const(*levelSet).getDomain()),
         calculateNormalVectors(calcNormal),
         gridDelta(levelSet->getGrid().getGridDelta()) {}
 
+  /// Use the velocities stored in cache for the center point instead of
+  /// querying the velocity field, where available.
+  void setVelocityCache(const VelocityCache<T> *cache) {
+    velocityCache = cache;
+  }
+
   std::pair<T, T> operator()(const viennahrle::Index<D> &indices,
                              int material) {
 
@@ -137,12 +149,12 @@ public:
       }
     }
 
-    T scalarVelocity = velocities->getScalarVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
-    Vec3D<T> vectorVelocity = velocities->getVectorVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
+    T scalarVelocity;
+    Vec3D<T> vectorVelocity;
+    VelocityCache<T>::getVelocities(velocityCache, *velocities, coordinate,
+                                    material, normalVector,
+                                    neighborIterator.getCenter().getPointId(),
+                                    scalarVelocity, vectorVelocity);
 
     if (scalarVelocity > 0) {
       vel_grad += std::sqrt(gradPosTotal) * scalarVelocity;
@@ -161,6 +173,147 @@ public:
     return {vel_grad, 0.};
   }
 
+  /// Evaluates the scheme for count <= stencilBatchSize grid points at once
+  /// and writes their rates to rates. The stencils of all points are
+  /// gathered first, so the differences can be calculated with SIMD
+  /// instructions. The arithmetic is the same as in operator(). The indices
+  /// must increase, also between successive calls.
+  void evaluateBatch(const viennahrle::Index<D> *indices, const int *materials,
+                     unsigned count, std::pair<T, T> *rates) {
+    constexpr unsigned size = StencilBatch<T, D, order>::size;
+    assert(count <= size);
+
+    stencils.clear();
+    for (unsigned p = 0; p < count; ++p)
+      stencils.gather(indices[p]);
+
+    alignas(64) T gradPos[D][size];
+    alignas(64) T gradNeg[D][size];
+    alignas(64) T normals[D][size];
+    alignas(64) T gradPosTotal[size] = {};
+    alignas(64) T gradNegTotal[size] = {};
+
+    const T deltaPos = gridDelta;
+    const T deltaNeg = -gridDelta;
+    const T deltaPosPos = 2 * gridDelta;
+    const T deltaNegNeg = -2 * gridDelta;
+
+    for (int i = 0; i < D; ++i) {
+      const auto &phi = stencils.values[i];
+#pragma omp simd
+      for (unsigned p = 0; p < count; ++p) {
+        const T phi0 = phi[order][p];
+        const T phiPos = phi[order + 1][p];
+        const T phiNeg = phi[order - 1][p];
+
+        T diffPos = (phiPos - phi0) / deltaPos;
+        T diffNeg = (phiNeg - phi0) / deltaNeg;
+
+        if constexpr (order == 2) {
+          const T phiPosPos = phi[order + 2][p];
+          const T phiNegNeg = phi[order - 2][p];
+
+          const T diff00 = (((deltaNeg * phiPos - deltaPos * phiNeg) /
+                                 (deltaPos - deltaNeg) +
+                             phi0)) /
+                           (deltaPos * deltaNeg);
+          const T diffNegNeg = (((deltaNeg * phiNegNeg - deltaNegNeg * phiNeg) /
+                                     (deltaNegNeg - deltaNeg) +
+                                 phi0)) /
+                               (deltaNegNeg * deltaNeg);
+          const T diffPosPos = (((deltaPos * phiPosPos - deltaPosPos * phiPos) /
+                                     (deltaPosPos - deltaPos) +
+                                 phi0)) /
+                               (deltaPosPos * deltaPos);
+
+          if (std::signbit(diff00) == std::signbit(diffPosPos)) {
+            if (std::abs(diffPosPos * deltaPos) < std::abs(diff00 * deltaNeg)) {
+              diffPos -= deltaPos * diffPosPos;
+            } else {
+              diffPos += deltaNeg * diff00;
+            }
+          }
+
+          if (std::signbit(diff00) == std::signbit(diffNegNeg)) {
+            if (std::abs(diffNegNeg * deltaNeg) < std::abs(diff00 * deltaPos)) {
+              diffNeg -= deltaNeg * diffNegNeg;
+            } else {
+              diffNeg += deltaPos * diff00;
+            }
+          }
+        }
+
+        gradPos[i][p] = diffNeg;
+        gradNeg[i][p] = diffPos;
+
+        gradPosTotal[p] +=
+            pow2(std::max(diffNeg, T(0))) + pow2(std::min(diffPos, T(0)));
+        gradNegTotal[p] +=
+            pow2(std::min(diffNeg, T(0))) + pow2(std::max(diffPos, T(0)));
+
+        // central differences for the normal vector
+        const T pos = phiPos - phi0;
+        const T neg = phi0 - phiNeg;
+        normals[i][p] = (pos + neg) * 0.5;
+      }
+    }
+
+    if (calculateNormalVectors) {
+#pragma omp simd
+      for (unsigned p = 0; p < count; ++p) {
+        T denominator = 0;
+        for (int i = 0; i < D; ++i)
+          denominator += normals[i][p] * normals[i][p];
+        denominator = 1. / std::sqrt(denominator);
+        for (int i = 0; i < D; ++i)
+          normals[i][p] *= denominator;
+      }
+    }
+
+    // the velocity field is queried point by point
+    alignas(64) T scalarVelocities[size];
+    alignas(64) T vectorVelocities[D][size];
+    for (unsigned p = 0; p < count; ++p) {
+      VectorType<T, 3> coordinate{0., 0., 0.};
+      Vec3D<T> normalVector{};
+      for (unsigned i = 0; i < D; ++i) {
+        coordinate[i] = indices[p][i] * gridDelta;
+        if (calculateNormalVectors)
+          normalVector[i] = normals[i][p];
+      }
+
+      Vec3D<T> vectorVelocity;
+      VelocityCache<T>::getVelocities(
+          velocityCache, *velocities, coordinate, materials[p], normalVector,
+          stencils.pointIds[p], scalarVelocities[p], vectorVelocity);
+      for (int w = 0; w < D; ++w)
+        vectorVelocities[w][p] = vectorVelocity[w];
+    }
+
+    alignas(64) T velGrad[size];
+#pragma omp simd
+    for (unsigned p = 0; p < count; ++p) {
+      T vel_grad = 0.;
+      if (scalarVelocities[p] > 0) {
+        vel_grad += std::sqrt(gradPosTotal[p]) * scalarVelocities[p];
+      } else {
+        vel_grad += std::sqrt(gradNegTotal[p]) * scalarVelocities[p];
+      }
+
+      for (int w = 0; w < D; ++w) {
+        if (vectorVelocities[w][p] > 0.) {
+          vel_grad += vectorVelocities[w][p] * gradPos[w][p];
+        } else {
+          vel_grad += vectorVelocities[w][p] * gradNeg[w][p];
+        }
+      }
+      velGrad[p] = vel_grad;
+    }
+
+    for (unsigned p = 0; p < count; ++p)
+      rates[p] = {velGrad[p], 0.};
+  }
+
   void reduceTimeStepHamiltonJacobi(double &MaxTimeStep,
                                     double gridDelta) const {}
 };
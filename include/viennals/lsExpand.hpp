@@ -2,6 +2,13 @@
 
 #include <lsPreCompileMacros.hpp>
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+#include <hrleSparseIterator.hpp>
 #include <hrleSparseStarIterator.hpp>
 #include <lsDomain.hpp>
 
@@ -19,6 +26,201 @@ template <class T, int D> class Expand {
   int width = 0;
   bool updatePointData = true;
 
+  /// A point which is not kept by the expansion, with the smallest distance
+  /// it can take from its neighbors found so far.
+  struct Candidate {
+    viennahrle::Index<D> index;
+    T value = 0;
+    // direction of the neighbor the value is taken from, -1 if there is none
+    int neighbor = -1;
+    // id of the point in the old level set whose point data is used
+    unsigned sourceId = 0;
+    // bit i is set if neighbor i is a point which is kept
+    unsigned keptNeighbors = 0;
+    bool isPositive = true;
+    bool isAccepted = false;
+
+    /// Takes newValue from neighbor i if it is closer to the surface than
+    /// the current value. Ties are resolved by the lower neighbor direction,
+    /// like in a sweep over all neighbors.
+    void update(T newValue, int i, unsigned newSourceId) {
+      const bool closer = isPositive ? newValue < value : newValue > value;
+      if (neighbor < 0 || closer || (newValue == value && i < neighbor)) {
+        value = newValue;
+        neighbor = i;
+        sourceId = newSourceId;
+      }
+    }
+
+    bool isWithin(T limit) const {
+      return neighbor >= 0 && (isPositive ? value <= limit : value >= -limit);
+    }
+  };
+
+  struct IndexHash {
+    std::size_t operator()(const viennahrle::Index<D> &index) const {
+      std::size_t seed = 0;
+      for (unsigned i = 0; i < D; ++i) {
+        seed ^= std::hash<viennahrle::IndexType>{}(index[i]) +
+                std::size_t(0x9e3779b97f4a7c15ULL) + (seed << 6) +
+                (seed >> 2);
+      }
+      return seed;
+    }
+  };
+
+  static viennahrle::Index<D> neighborOffset(int i) {
+    viennahrle::Index<D> offset(0);
+    offset[i % D] = (i < D) ? 1 : -1;
+    return offset;
+  }
+
+  /// Finds all points which are not kept, but are next to a kept point, and
+  /// all defined points which are not kept, in one sweep over the level set.
+  std::vector<Candidate> findCandidates(T totalLimit) {
+    auto &grid = levelSet->getGrid();
+    const auto &domain = std::as_const(*levelSet).getDomain();
+    auto isKept = [totalLimit](const auto &it) {
+      return it.isDefined() && std::abs(it.getValue()) <= totalLimit;
+    };
+
+    std::vector<std::vector<Candidate>> segmentCandidates(
+        domain.getNumberOfSegments());
+
+#pragma omp parallel num_threads(domain.getNumberOfSegments())
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+
+      auto &candidates = segmentCandidates[p];
+
+      viennahrle::Index<D> const startVector =
+          (p == 0) ? grid.getMinGridPoint() : domain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> const endVector =
+          (p != static_cast<int>(domain.getNumberOfSegments() - 1))
+              ? domain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      for (viennahrle::ConstSparseStarIterator<
+               typename Domain<T, D>::DomainType, 1>
+               neighborIt(domain, startVector);
+           neighborIt.getIndices() < endVector; neighborIt.next()) {
+        auto &centerIt = neighborIt.getCenter();
+        if (isKept(centerIt))
+          continue;
+
+        Candidate candidate;
+        candidate.index = neighborIt.getIndices();
+        candidate.isPositive =
+            centerIt.getValue() > -std::numeric_limits<T>::epsilon();
+        for (int i = 0; i < 2 * D; ++i) {
+          auto &neighbor = neighborIt.getNeighbor(i);
+          if (!isKept(neighbor))
+            continue;
+          candidate.keptNeighbors |= 1u << i;
+          candidate.update(candidate.isPositive ? neighbor.getValue() + T(1)
+                                                : neighbor.getValue() - T(1),
+                           i, neighbor.getPointId());
+        }
+        if (candidate.keptNeighbors != 0 || centerIt.isDefined())
+          candidates.push_back(candidate);
+      }
+    }
+
+    std::vector<Candidate> candidates;
+    for (auto &segment : segmentCandidates)
+      candidates.insert(candidates.end(), segment.begin(), segment.end());
+    return candidates;
+  }
+
+  /// Accepts the candidates layer by layer. Each cycle accepts all
+  /// candidates within its limit, which then pass their value on to their
+  /// neighbors, adding them as candidates if they are new.
+  void propagateCandidates(std::vector<Candidate> &candidates, int startWidth,
+                           int numberOfCycles) {
+    const auto &grid = levelSet->getGrid();
+
+    std::unordered_map<viennahrle::Index<D>, std::size_t, IndexHash>
+        candidateIds;
+    candidateIds.reserve(candidates.size());
+    for (std::size_t id = 0; id < candidates.size(); ++id)
+      candidateIds.emplace(candidates[id].index, id);
+
+    auto isInGrid = [&grid](const viennahrle::Index<D> &index) {
+      for (unsigned i = 0; i < D; ++i) {
+        if (index[i] < grid.getMinGridPoint(i) ||
+            index[i] > grid.getMaxGridPoint(i))
+          return false;
+      }
+      return true;
+    };
+
+    std::vector<std::size_t> pendingIds(candidates.size());
+    std::iota(pendingIds.begin(), pendingIds.end(), 0);
+    std::vector<std::size_t> remainingIds;
+    std::vector<std::size_t> acceptedIds;
+
+    for (int cycle = 0; cycle < numberOfCycles; ++cycle) {
+      const T limit = (startWidth + cycle + 1) * T(0.5);
+
+      remainingIds.clear();
+      acceptedIds.clear();
+      for (auto id : pendingIds) {
+        auto &candidate = candidates[id];
+        if (candidate.isWithin(limit)) {
+          candidate.isAccepted = true;
+          acceptedIds.push_back(id);
+        } else {
+          remainingIds.push_back(id);
+        }
+      }
+      std::swap(pendingIds, remainingIds);
+
+      // the last layer does not pass its values on
+      if (cycle == numberOfCycles - 1)
+        break;
+
+      for (auto id : acceptedIds) {
+        // copy, since adding candidates invalidates references
+        const Candidate accepted = candidates[id];
+        for (int j = 0; j < 2 * D; ++j) {
+          if (accepted.keptNeighbors & (1u << j))
+            continue;
+          const auto index = grid.globalIndices2LocalIndices(
+              accepted.index + neighborOffset(j));
+          if (!isInGrid(index))
+            continue;
+
+          auto [candidateIt, isNew] =
+              candidateIds.emplace(index, candidates.size());
+          if (isNew) {
+            Candidate candidate;
+            candidate.index = index;
+            candidate.isPositive = accepted.isPositive;
+            candidates.push_back(candidate);
+            pendingIds.push_back(candidateIt->second);
+          }
+          auto &candidate = candidates[candidateIt->second];
+          if (candidate.isAccepted)
+            continue;
+
+          // the accepted point might be several neighbors of the candidate
+          // due to the boundary conditions
+          const T value = candidate.isPositive ? accepted.value + T(1)
+                                               : accepted.value - T(1);
+          for (int i = 0; i < 2 * D; ++i) {
+            if (grid.globalIndices2LocalIndices(index + neighborOffset(i)) ==
+                accepted.index)
+              candidate.update(value, i, accepted.sourceId);
+          }
+        }
+      }
+    }
+  }
+
 public:
   Expand() = default;
 
@@ -59,115 +261,114 @@ public:
     const int startWidth = levelSet->getLevelSetWidth();
     const int numberOfRequiredCycles = width - startWidth;
 
-    for (int currentCycle = 0; currentCycle < numberOfRequiredCycles;
-         ++currentCycle) {
+    auto &grid = levelSet->getGrid();
+    const auto &domain = std::as_const(*levelSet).getDomain();
 
-      const int allocationFactor =
-          1 + 1.0 / static_cast<double>(startWidth + currentCycle);
-      const T limit = (startWidth + currentCycle + 1) * T(0.5);
+    // Points are expanded in cycles, each adding one layer. In every cycle, a
+    // point which is not kept takes the smallest distance of its neighbors
+    // increased by one, if this is within the limit of the cycle. Instead of
+    // sweeping the whole level set once per cycle, all points next to the
+    // kept points are found in one sweep and the layers are grown from them
+    // by visiting only the points of the new layers.
+    auto candidates = findCandidates(totalLimit);
+    propagateCandidates(candidates, startWidth, numberOfRequiredCycles);
 
-      auto &grid = levelSet->getGrid();
-      auto newlsDomain = SmartPointer<Domain<T, D>>::New(grid);
-      auto &newDomain = newlsDomain->getDomain();
-      auto &domain = levelSet->getDomain();
+    // accepted points, sorted in the order they are inserted into the domain
+    std::vector<const Candidate *> acceptedPoints;
+    for (const auto &candidate : candidates) {
+      if (candidate.isAccepted)
+        acceptedPoints.push_back(&candidate);
+    }
+    std::sort(acceptedPoints.begin(), acceptedPoints.end(),
+              [](const Candidate *a, const Candidate *b) {
+                return a->index < b->index;
+              });
 
-      newDomain.initialize(domain.getNewSegmentation(),
-                           domain.getAllocation() * allocationFactor);
+    const int allocationFactor =
+        (width + startWidth - 1) / std::max(startWidth, 1);
+    auto &newDomain = levelSet->getBufferDomain();
+    newDomain.initialize(domain.getNewSegmentation(),
+                         domain.getAllocation() * allocationFactor);
 
-      const bool updateData = updatePointData;
-      // save how data should be transferred to new level set
-      // list of indices into the old pointData vector
-      std::vector<std::vector<unsigned>> newDataSourceIds;
-      if (updateData)
-        newDataSourceIds.resize(newDomain.getNumberOfSegments());
+    const bool updateData = updatePointData;
+    // save how data should be transferred to new level set
+    // list of indices into the old pointData vector
+    std::vector<std::vector<unsigned>> newDataSourceIds;
+    if (updateData)
+      newDataSourceIds.resize(newDomain.getNumberOfSegments());
 
 #pragma omp parallel num_threads(newDomain.getNumberOfSegments())
-      {
-        int p = 0;
+    {
+      int p = 0;
 #ifdef _OPENMP
-        p = omp_get_thread_num();
+      p = omp_get_thread_num();
 #endif
 
-        auto &domainSegment = newDomain.getDomainSegment(p);
-
-        viennahrle::Index<D> const startVector =
-            (p == 0) ? grid.getMinGridPoint()
-                     : newDomain.getSegmentation()[p - 1];
-
-        viennahrle::Index<D> const endVector =
-            (p != static_cast<int>(newDomain.getNumberOfSegments() - 1))
-                ? newDomain.getSegmentation()[p]
-                : grid.incrementIndices(grid.getMaxGridPoint());
-
-        for (viennahrle::ConstSparseStarIterator<
-                 typename Domain<T, D>::DomainType, 1>
-                 neighborIt(domain, startVector);
-             neighborIt.getIndices() < endVector; neighborIt.next()) {
-
-          auto &centerIt = neighborIt.getCenter();
-          if (std::abs(centerIt.getValue()) <= totalLimit) {
-            domainSegment.insertNextDefinedPoint(neighborIt.getIndices(),
-                                                 centerIt.getValue());
-            if (updateData)
-              newDataSourceIds[p].push_back(centerIt.getPointId());
-          } else {
-            if (centerIt.getValue() > -std::numeric_limits<T>::epsilon()) {
-              T distance = Domain<T, D>::POS_VALUE;
-              int neighbor = -1;
-              for (int i = 0; i < 2 * D; i++) {
-                T newValue = neighborIt.getNeighbor(i).getValue() + T(1);
-                if (distance > newValue) {
-                  distance = newValue;
-                  neighbor = i;
-                }
-              }
-              if (distance <= limit) {
-                domainSegment.insertNextDefinedPoint(neighborIt.getIndices(),
-                                                     distance);
-                if (updateData)
-                  newDataSourceIds[p].push_back(
-                      neighborIt.getNeighbor(neighbor).getPointId());
-              } else {
-                // TODO: use insertNextUndefinedRunType
-                domainSegment.insertNextUndefinedPoint(neighborIt.getIndices(),
-                                                       Domain<T, D>::POS_VALUE);
-              }
-            } else {
-              T distance = Domain<T, D>::NEG_VALUE;
-              int neighbor = -1;
-              for (int i = 0; i < 2 * D; i++) {
-                T newValue = neighborIt.getNeighbor(i).getValue() - T(1);
-                if (distance < newValue) {
-                  distance = newValue;
-                  neighbor = i;
-                }
-              }
-              if (distance >= -limit) {
-                domainSegment.insertNextDefinedPoint(neighborIt.getIndices(),
-                                                     distance);
-                if (updateData)
-                  newDataSourceIds[p].push_back(
-                      neighborIt.getNeighbor(neighbor).getPointId());
-              } else {
-                // TODO: use insertNextUndefinedRunType
-                domainSegment.insertNextUndefinedPoint(neighborIt.getIndices(),
-                                                       Domain<T, D>::NEG_VALUE);
-              }
-            }
-          }
+      auto &domainSegment = newDomain.getDomainSegment(p);
+
+      viennahrle::Index<D> const startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : newDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> const endVector =
+          (p != static_cast<int>(newDomain.getNumberOfSegments() - 1))
+              ? newDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      auto acceptedIt = std::lower_bound(
+          acceptedPoints.begin(), acceptedPoints.end(), startVector,
+          [](const Candidate *candidate, const viennahrle::Index<D> &index) {
+            return candidate->index < index;
+          });
+
+      for (viennahrle::ConstSparseIterator<typename Domain<T, D>::DomainType>
+               it(domain, startVector);
+           it.getStartIndices() < endVector; ++it) {
+        const T value = it.getValue();
+        if (it.isDefined() && std::abs(value) <= totalLimit) {
+          domainSegment.insertNextDefinedPoint(it.getStartIndices(), value);
+          if (updateData)
+            newDataSourceIds[p].push_back(it.getPointId());
+          continue;
         }
-      }
 
-      // now copy old data into new level set
-      if (updateData) {
-        newlsDomain->getPointData().translateFromMultiData(
-            levelSet->getPointData(), newDataSourceIds);
+        // all other points are undefined, except for the accepted ones
+        const T undefinedValue =
+            (value > -std::numeric_limits<T>::epsilon())
+                ? Domain<T, D>::POS_VALUE
+                : Domain<T, D>::NEG_VALUE;
+        viennahrle::Index<D> position = it.getStartIndices();
+        for (; acceptedIt != acceptedPoints.end() &&
+               !(it.getEndIndices() < (*acceptedIt)->index) &&
+               (*acceptedIt)->index < endVector;
+             ++acceptedIt) {
+          const auto &accepted = **acceptedIt;
+          if (position < accepted.index) {
+            // TODO: use insertNextUndefinedRunType
+            domainSegment.insertNextUndefinedPoint(position, undefinedValue);
+          }
+          domainSegment.insertNextDefinedPoint(accepted.index,
+                                               accepted.value);
+          if (updateData)
+            newDataSourceIds[p].push_back(accepted.sourceId);
+          position = grid.incrementIndices(accepted.index);
+        }
+        if (!(it.getEndIndices() < position) && position < endVector) {
+          domainSegment.insertNextUndefinedPoint(position, undefinedValue);
+        }
       }
+    }
 
-      newDomain.finalize();
-      levelSet->deepCopy(newlsDomain);
+    // now copy old data into new level set
+    typename Domain<T, D>::PointDataType newPointData;
+    if (updateData) {
+      newPointData.translateFromMultiData(
+          std::as_const(*levelSet).getPointData(), newDataSourceIds);
     }
-    levelSet->getDomain().segment();
+
+    newDomain.finalize();
+    newDomain.segment();
+    levelSet->swapBuffer(std::move(newPointData));
     levelSet->finalize(width);
   }
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include <lsDomain.hpp>
 #include <lsFromSurfaceMesh.hpp>
 #include <lsToSurfaceMesh.hpp>
@@ -90,7 +92,7 @@ public:
 
     std::vector<std::pair<viennahrle::Index<3>, T>> points3D;
 
-    auto &domain2D = inputLevelSet->getDomain();
+    const auto &domain2D = std::as_const(*inputLevelSet).getDomain();
     auto &grid2D = inputLevelSet->getGrid();
     const T gridDelta = grid2D.getGridDelta();
     auto minBounds = grid2D.getMinBounds();
@@ -134,7 +136,7 @@ public:
     const hrleIndexType extStart = std::floor(extent[0] / gridDelta);
     const hrleIndexType extEnd = std::ceil(extent[1] / gridDelta);
 
-    for (viennahrle::SparseIterator<typename Domain<T, 2>::DomainType> it(
+    for (viennahrle::ConstSparseIterator<typename Domain<T, 2>::DomainType> it(
              domain2D);
          !it.isFinished(); ++it) {
       if (!it.isDefined())
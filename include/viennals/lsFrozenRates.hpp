@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <hrleTypes.hpp>
+
+namespace lsInternal {
+
+/// Rates of slowly moving points of the top level set, which are reused for
+/// several time steps instead of evaluating the spatial discretization scheme
+/// again. Since the point ids change whenever the narrow band is rebuilt, the
+/// rates are stored sorted by the grid indices of the points and looked up
+/// with a cursor, which is moved along with a sparse iterator. A point is
+/// only frozen if its rate cannot move it by more than the CFL condition
+/// allows until the rates are released, so the frozen rates are valid for a
+/// limited time and number of time steps.
+template <class T, int D> class FrozenRates {
+public:
+  /// Rate as stored by Advect: gradient and dissipation of the point and the
+  /// value at which the rate stops being valid.
+  using RateType = std::pair<std::pair<T, T>, T>;
+  using EntryType = std::pair<viennahrle::Index<D>, RateType>;
+
+private:
+  std::vector<EntryType> entries;
+  double remainingTime = 0.;
+  unsigned remainingSteps = 0;
+
+public:
+  /// Looks up the frozen rates of grid points visited in increasing order.
+  class Cursor {
+    typename std::vector<EntryType>::const_iterator current;
+    typename std::vector<EntryType>::const_iterator end;
+
+  public:
+    Cursor(typename std::vector<EntryType>::const_iterator begin,
+           typename std::vector<EntryType>::const_iterator passedEnd)
+        : current(begin), end(passedEnd) {}
+
+    /// Returns the frozen rate of the grid point, or nullptr if the point
+    /// is not frozen. The indices passed to successive calls must not
+    /// decrease.
+    const RateType *find(const viennahrle::Index<D> &indices) {
+      while (current != end && current->first < indices)
+        ++current;
+      if (current != end && current->first == indices)
+        return &current->second;
+      return nullptr;
+    }
+  };
+
+  FrozenRates() = default;
+
+  /// Freezes the rates of the given points for at most time and steps
+  /// further time steps. The entries do not have to be sorted.
+  void freeze(std::vector<EntryType> &&passedEntries, double time,
+              unsigned steps) {
+    entries = std::move(passedEntries);
+    std::sort(entries.begin(), entries.end(),
+              [](const EntryType &a, const EntryType &b) {
+                return a.first < b.first;
+              });
+    remainingTime = time;
+    remainingSteps = steps;
+    if (remainingSteps == 0 || remainingTime <= 0.)
+      clear();
+  }
+
+  /// Counts a time step of size dt which used the frozen rates. The rates
+  /// are released once their time or number of steps is used up.
+  void advance(double dt) {
+    if (entries.empty())
+      return;
+    remainingTime -= dt;
+    if (--remainingSteps == 0 || remainingTime <= 0.)
+      clear();
+  }
+
+  void clear() {
+    entries.clear();
+    remainingTime = 0.;
+    remainingSteps = 0;
+  }
+
+  bool empty() const { return entries.empty(); }
+
+  std::size_t size() const { return entries.size(); }
+
+  /// Largest time step which may still be taken with the frozen rates.
+  double getRemainingTime() const { return remainingTime; }
+
+  /// Cursor starting at the first frozen point not before startIndices.
+  Cursor getCursor(const viennahrle::Index<D> &startIndices) const {
+    auto begin = std::lower_bound(entries.begin(), entries.end(), startIndices,
+                                  [](const EntryType &entry,
+                                     const viennahrle::Index<D> &indices) {
+                                    return entry.first < indices;
+                                  });
+    return Cursor(begin, entries.end());
+  }
+};
+
+} // namespace lsInternal
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include <hrleSparseIterator.hpp>
 
 #include <lsBooleanOperation.hpp>
@@ -119,7 +121,7 @@ public:
 
     typedef typename Domain<T, D>::DomainType DomainType;
 
-    auto &domain = levelSet->getDomain();
+    const auto &domain = std::as_const(*levelSet).getDomain();
 
     auto &grid = levelSet->getGrid();
     const auto gridDelta = grid.getGridDelta();
@@ -201,7 +203,7 @@ public:
     // lie on (or inside) the mask
     if (maskLevelSet != nullptr) {
       // Go over all contribute points and see if they are on the mask surface
-      auto &maskDomain = maskLevelSet->getDomain();
+      const auto &maskDomain = std::as_const(*maskLevelSet).getDomain();
       auto values = surfaceMesh->cellData.getScalarData("LSValues");
       auto valueIt = values->begin();
 
@@ -317,15 +319,14 @@ public:
               ? segmentation[p]
               : grid.incrementIndices(max);
 
-      viennahrle::ConstSparseIterator<DomainType> checkIt(levelSet->getDomain(),
-                                                          startVector);
+      viennahrle::ConstSparseIterator<DomainType> checkIt(domain, startVector);
 
       // Mask iterator for checking whether inside mask or not
       std::unique_ptr<viennahrle::ConstSparseIterator<DomainType>> maskIt =
           nullptr;
       if (maskLevelSet != nullptr) {
         maskIt = std::make_unique<viennahrle::ConstSparseIterator<DomainType>>(
-            maskLevelSet->getDomain(), startVector);
+            std::as_const(*maskLevelSet).getDomain(), startVector);
       }
 
       // Iterate through the bounds of new lsDomain lexicographically
@@ -1,100 +1,64 @@
 #pragma once
 
-#include <unordered_map>
-#include <unordered_set>
+#include <atomic>
+#include <utility>
 #include <vector>
 
-#include <vcLogger.hpp>
-
 namespace lsInternal {
 
-using namespace viennacore;
-
-class Graph {
+/// Undirected graph with a fixed number of vertices, whose edges can be
+/// inserted by several threads at the same time. The components are merged
+/// by a lock-free union-find: every vertex only ever points to vertices
+/// with smaller indices, so the root of each component is its vertex with
+/// the smallest index and concurrent insertions cannot create cycles.
+class ConcurrentGraph {
   // type for indexing components
   using IndexType = std::size_t;
-  // edges must be unique
-  typedef std::unordered_set<IndexType> edgeListType;
-  // points must be unique and addressable
-  typedef std::unordered_map<IndexType, edgeListType> adjacencyListType;
-
-  adjacencyListType adjacencyList;
-  std::vector<IndexType> componentIds;
-
-  void depthFirstComponentSearch(const std::size_t &currentVertex,
-                                 int &currentComponent) {
-    // set component for this vertex
-    componentIds[currentVertex] = currentComponent;
 
-    // cycle through all connected vertices and set their component
-    auto vertexListIt = adjacencyList.find(currentVertex);
-    if (vertexListIt == adjacencyList.end()) {
-      Logger::getInstance().addError(
-          "Graph: Vertex " + std::to_string(currentVertex) +
-          " could not be found although it should exist!");
-    }
-
-    for (unsigned long it : vertexListIt->second) {
-      // vertex has not been visited
-      if (componentIds[it] == -1) {
-        depthFirstComponentSearch(it, currentComponent);
-      }
-    }
-  }
+  // the parents only ever decrease, so no ordering between the accesses
+  // of different vertices is required
+  std::vector<std::atomic<IndexType>> parents;
 
 public:
-  /// add new vertex
-  std::size_t insertNextVertex() {
-    adjacencyList.insert(std::make_pair(adjacencyList.size(), edgeListType()));
-    // return new key
-    return adjacencyList.size() - 1;
-  }
-
-  /// add connection of vertex1 to vertex2
-  void insertNextEdge(std::size_t vertex1, std::size_t vertex2) {
-    // try to insert element into vertex list
-    // if it already exists, add vertex2 to vertex1 edges
-    auto it =
-        adjacencyList.insert(std::make_pair(vertex1, edgeListType())).first;
-    it->second.insert(vertex2);
+  ConcurrentGraph() = default;
 
-    // do the same for vertex2
-    it = adjacencyList.insert(std::make_pair(vertex2, edgeListType())).first;
-    it->second.insert(vertex1);
+  ConcurrentGraph(std::size_t numberOfVertices) : parents(numberOfVertices) {
+    for (IndexType vertex = 0; vertex < numberOfVertices; ++vertex)
+      parents[vertex].store(vertex, std::memory_order_relaxed);
   }
 
-  // returns a std::vector, where the value at each
-  // index denotes the component, the vertex belongs to
-  std::vector<IndexType> getConnectedComponents() {
-    // traverse all vertices and stop at unvisited ones
-    // to build connectivity.
-    componentIds.resize(adjacencyList.size(), -1);
-    int currentComponent = 0;
-    std::size_t currentVertex = 0;
-
-    for (auto it = adjacencyList.begin(); it != adjacencyList.end(); ++it) {
-      // this vertex has not been visited, so it
-      // must be part of a new component
-      if (componentIds[currentVertex] == -1) {
-        depthFirstComponentSearch(currentVertex, currentComponent);
-
-        ++currentComponent;
-      }
-      ++currentVertex;
+  std::size_t getNumberOfVertices() const { return parents.size(); }
+
+  /// returns the vertex with the smallest index of the component
+  std::size_t findRoot(std::size_t vertex) {
+    while (true) {
+      auto parent = parents[vertex].load(std::memory_order_relaxed);
+      if (parent == vertex)
+        return vertex;
+      const auto grandParent = parents[parent].load(std::memory_order_relaxed);
+      // path halving, which may fail if another thread shortened the path
+      if (grandParent != parent)
+        parents[vertex].compare_exchange_weak(parent, grandParent,
+                                              std::memory_order_relaxed);
+      vertex = grandParent;
     }
-
-    return componentIds;
   }
 
-  void print() {
-    std::cout << "Graph structure: " << std::endl;
-    for (auto &[fst, snd] : adjacencyList) {
-      auto &edges = snd;
-      std::cout << "Vertex: " << fst << std::endl;
-      for (const unsigned long edge : edges) {
-        std::cout << edge << ", ";
-      }
-      std::cout << std::endl;
+  /// add connection of vertex1 to vertex2, may be called concurrently
+  void insertNextEdge(std::size_t vertex1, std::size_t vertex2) {
+    while (true) {
+      vertex1 = findRoot(vertex1);
+      vertex2 = findRoot(vertex2);
+      if (vertex1 == vertex2)
+        return;
+      if (vertex1 < vertex2)
+        std::swap(vertex1, vertex2);
+      // link the larger root to the smaller one, unless another thread
+      // linked it in the meantime
+      auto expected = vertex1;
+      if (parents[vertex1].compare_exchange_strong(
+              expected, vertex2, std::memory_order_relaxed))
+        return;
     }
   }
 };
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <hrleGrid.hpp>
+#include <hrleSparseIterator.hpp>
+#include <hrleTypes.hpp>
+
+namespace viennals {
+
+/// Axis aligned box of grid indices, e.g. the part of a level set which was
+/// changed by an algorithm. Both corners are part of the region. A default
+/// constructed region is empty.
+template <int D> class IndexRegion {
+  viennahrle::Index<D> minIndices;
+  viennahrle::Index<D> maxIndices;
+  bool isEmpty = true;
+
+public:
+  IndexRegion() = default;
+
+  IndexRegion(const viennahrle::Index<D> &passedMinIndices,
+              const viennahrle::Index<D> &passedMaxIndices)
+      : minIndices(passedMinIndices), maxIndices(passedMaxIndices),
+        isEmpty(false) {}
+
+  bool empty() const { return isEmpty; }
+
+  void clear() { isEmpty = true; }
+
+  const viennahrle::Index<D> &getMinIndices() const { return minIndices; }
+
+  const viennahrle::Index<D> &getMaxIndices() const { return maxIndices; }
+
+  /// Grow the region so it contains the grid point.
+  void insert(const viennahrle::Index<D> &indices) {
+    if (isEmpty) {
+      minIndices = indices;
+      maxIndices = indices;
+      isEmpty = false;
+      return;
+    }
+    for (int i = 0; i < D; ++i) {
+      minIndices[i] = std::min(minIndices[i], indices[i]);
+      maxIndices[i] = std::max(maxIndices[i], indices[i]);
+    }
+  }
+
+  /// Grow the region so it contains the other region.
+  void insert(const IndexRegion &other) {
+    if (other.isEmpty)
+      return;
+    insert(other.minIndices);
+    insert(other.maxIndices);
+  }
+
+  /// Grow the region by margin grid points in each direction, without
+  /// leaving the grid. If it reaches over a periodic boundary of the grid, it
+  /// covers the whole grid in that direction, since the other side of the
+  /// grid is also affected.
+  void expand(viennahrle::IndexType margin, const viennahrle::Grid<D> &grid) {
+    if (isEmpty)
+      return;
+    for (int i = 0; i < D; ++i) {
+      const bool periodic = grid.getBoundaryConditions(i) ==
+                            viennahrle::BoundaryType::PERIODIC_BOUNDARY;
+      minIndices[i] -= margin;
+      maxIndices[i] += margin;
+      if (periodic && (minIndices[i] < grid.getMinGridPoint(i) ||
+                       maxIndices[i] > grid.getMaxGridPoint(i))) {
+        minIndices[i] = grid.getMinGridPoint(i);
+        maxIndices[i] = grid.getMaxGridPoint(i);
+      }
+      minIndices[i] = std::max(minIndices[i], grid.getMinGridPoint(i));
+      maxIndices[i] = std::min(maxIndices[i], grid.getMaxGridPoint(i));
+    }
+  }
+
+  bool contains(const viennahrle::Index<D> &indices) const {
+    if (isEmpty)
+      return false;
+    for (int i = 0; i < D; ++i) {
+      if (indices[i] < minIndices[i] || indices[i] > maxIndices[i])
+        return false;
+    }
+    return true;
+  }
+
+  /// Splits the range of grid points [start, end) into the parts before,
+  /// within and after the region, in the order in which the grid points are
+  /// stored. copyRange(begin, end) is called for the parts which cannot
+  /// contain any point of the region and processRange(begin, end) for the
+  /// rest. The range passed to processRange also contains points outside of
+  /// the region, which can be identified using contains().
+  template <class CopyFunction, class ProcessFunction>
+  void splitRange(const viennahrle::Index<D> &start,
+                  const viennahrle::Index<D> &end,
+                  const viennahrle::Grid<D> &grid, CopyFunction copyRange,
+                  ProcessFunction processRange) const {
+    if (isEmpty) {
+      copyRange(start, end);
+      return;
+    }
+
+    const auto regionEnd = grid.incrementIndices(maxIndices);
+    const auto processStart = (start < minIndices) ? minIndices : start;
+    const auto processEnd = (regionEnd < end) ? regionEnd : end;
+
+    if (!(processStart < processEnd)) {
+      copyRange(start, end);
+      return;
+    }
+
+    if (start < processStart)
+      copyRange(start, processStart);
+    processRange(processStart, processEnd);
+    if (processEnd < end)
+      copyRange(processEnd, end);
+  }
+};
+
+} // namespace viennals
+
+namespace lsInternal {
+
+/// Inserts the points of domain in the range [start, end) into segment
+/// unchanged. The ids of the copied defined points are appended to
+/// sourceIds, if it is given.
+template <class DomainType, class SegmentType, int D>
+void copyDomainRange(const DomainType &domain, SegmentType &segment,
+                     const viennahrle::Index<D> &start,
+                     const viennahrle::Index<D> &end,
+                     std::vector<unsigned> *sourceIds = nullptr) {
+  for (viennahrle::ConstSparseIterator<DomainType> it(domain, start);
+       it.getStartIndices() < end; it.next()) {
+    if (it.isDefined()) {
+      segment.insertNextDefinedPoint(it.getStartIndices(), it.getValue());
+      if (sourceIds != nullptr)
+        sourceIds->push_back(it.getPointId());
+    } else {
+      segment.insertNextUndefinedPoint(it.getStartIndices(), it.getValue());
+    }
+  }
+}
+
+} // namespace lsInternal
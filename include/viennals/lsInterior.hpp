@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include <lsPreCompileMacros.hpp>
 
 #include <hrleSparseIterator.hpp>
@@ -62,7 +64,7 @@ public:
       auto &grid = levelSet->getGrid();
       auto newlsDomain = SmartPointer<Domain<T, D>>::New(grid);
       auto &newDomain = newlsDomain->getDomain();
-      auto &domain = levelSet->getDomain();
+      const auto &domain = std::as_const(*levelSet).getDomain();
 
       newDomain.initialize(domain.getNewSegmentation(), domain.getAllocation());
 
@@ -97,7 +99,8 @@ public:
             viennahrle::ConstSparseIterator<typename Domain<T, D>::DomainType>;
         std::unique_ptr<GuideIt> guideIt;
         if (guide != nullptr)
-          guideIt = std::make_unique<GuideIt>(guide->getDomain(), startVector);
+          guideIt = std::make_unique<GuideIt>(
+              std::as_const(*guide).getDomain(), startVector);
 
         for (viennahrle::ConstSparseStarIterator<
                  typename Domain<T, D>::DomainType, 1>
@@ -5,6 +5,7 @@
 
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
+#include <lsVelocityCache.hpp>
 
 #include <vcVectorType.hpp>
 
@@ -16,9 +17,12 @@ using namespace viennacore;
 /// value for dissipation. This alpha value should be fitted
 /// based on the results of the advection and passed to the
 /// advection Kernel.
-template <class T, int D, int order> class LaxFriedrichs {
+template <class T, int D, int order,
+          class VelocityType = viennals::VelocityField<T>>
+class LaxFriedrichs {
   SmartPointer<viennals::Domain<T, D>> levelSet;
-  SmartPointer<viennals::VelocityField<T>> velocities;
+  SmartPointer<VelocityType> velocities;
+  const VelocityCache<T> *velocityCache = nullptr;
   viennahrle::ConstSparseStarIterator<viennahrle::Domain<T, D>, order>
       neighborIterator;
   const double alphaFactor = 1.0;
@@ -36,13 +40,20 @@ public:
   }
 
   LaxFriedrichs(SmartPointer<viennals::Domain<T, D>> passedlsDomain,
-                SmartPointer<viennals::VelocityField<T>> vel, double alpha,
+                SmartPointer<VelocityType> vel, double alpha,
                 VectorType<T, D> &alphas, bool calcNormal)
       : levelSet(passedlsDomain), velocities(vel),
-        neighborIterator(levelSet->getDomain()), alphaFactor(alpha),
+        neighborIterator(std::as_const(*levelSet).getDomain()),
+        alphaFactor(alpha),
         gridDelta(levelSet->getGrid().getGridDelta()), finalAlphas(alphas),
         calculateNormalVectors(calcNormal) {}
 
+  /// Use the velocities stored in cache for the center point instead of
+  /// querying the velocity field, where available.
+  void setVelocityCache(const VelocityCache<T> *cache) {
+    velocityCache = cache;
+  }
+
   std::pair<T, T> operator()(const viennahrle::Index<D> &indices,
                              int material) {
 
@@ -134,12 +145,12 @@ public:
       }
     }
 
-    T scalarVelocity = velocities->getScalarVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
-    Vec3D<T> vectorVelocity = velocities->getVectorVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
+    T scalarVelocity;
+    Vec3D<T> vectorVelocity;
+    VelocityCache<T>::getVelocities(velocityCache, *velocities, coordinate,
+                                    material, normalVector,
+                                    neighborIterator.getCenter().getPointId(),
+                                    scalarVelocity, vectorVelocity);
 
     T totalGrad = 0.;
     if (scalarVelocity != 0.) {
@@ -2,8 +2,10 @@
 
 #include <hrleSparseBoxIterator.hpp>
 
+#include <lsDissipationCache.hpp>
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
+#include <lsVelocityCache.hpp>
 #include <lsVelocityField.hpp>
 
 #include <vcVectorType.hpp>
@@ -17,9 +19,13 @@ using namespace viennacore;
 /// The largest alpha value is then chosen for dissipation.
 /// Slower than lsLocalLocalLaxFriedrichs or lsEngquistOsher
 /// but more reliable for complex velocity fields.
-template <class T, int D, int order> class LocalLaxFriedrichs {
+template <class T, int D, int order,
+          class VelocityType = viennals::VelocityField<T>>
+class LocalLaxFriedrichs {
   SmartPointer<viennals::Domain<T, D>> levelSet;
-  SmartPointer<viennals::VelocityField<T>> velocities;
+  SmartPointer<VelocityType> velocities;
+  const VelocityCache<T> *velocityCache = nullptr;
+  DissipationCache<T, D> *dissipationCache = nullptr;
   // neighbor iterator always needs order 2 for alpha calculation
   viennahrle::ConstSparseBoxIterator<viennahrle::Domain<T, D>, 2>
       neighborIterator;
@@ -35,6 +41,39 @@ template <class T, int D, int order> class LocalLaxFriedrichs {
     return (diffPos + diffNeg) * 0.5;
   }
 
+  /// Calculate the dissipation coefficients at the neighbor offset by
+  /// neighborIndex from the stencil center, which lies at coords.
+  VectorType<T, D>
+  calculateLocalAlpha(const viennahrle::Index<D> &neighborIndex,
+                      const Vec3D<T> &coords, int material,
+                      unsigned long pointId) {
+    Vec3D<T> normal;
+    T normalModulus = 0.;
+    auto center = neighborIterator.getNeighbor(neighborIndex).getValue();
+    for (unsigned dir = 0; dir < D; ++dir) {
+      viennahrle::Index<D> unity(0);
+      unity[dir] = 1;
+      auto neg = neighborIterator.getNeighbor(neighborIndex - unity).getValue();
+      auto pos = neighborIterator.getNeighbor(neighborIndex + unity).getValue();
+      normal[dir] = calculateNormalComponent(neg, center, pos, gridDelta);
+      normalModulus += normal[dir] * normal[dir];
+    }
+    // normalize normal vector
+    normalModulus = 1. / std::sqrt(normalModulus);
+    for (unsigned dir = 0; dir < D; ++dir)
+      normal[dir] *= normalModulus;
+
+    T scaVel = velocities->getScalarVelocity(coords, material, normal, pointId);
+    auto vecVel =
+        velocities->getVectorVelocity(coords, material, normal, pointId);
+
+    VectorType<T, D> alpha;
+    for (unsigned dir = 0; dir < D; ++dir) {
+      alpha[dir] = std::abs((scaVel + vecVel[dir]) * normal[dir]);
+    }
+    return alpha;
+  }
+
   static void incrementIndices(viennahrle::Index<D> &index,
                                viennahrle::IndexType minIndex,
                                viennahrle::IndexType maxIndex) {
@@ -56,12 +95,23 @@ public:
   }
 
   LocalLaxFriedrichs(SmartPointer<viennals::Domain<T, D>> passedlsDomain,
-                     SmartPointer<viennals::VelocityField<T>> vel,
-                     double a = 1.0)
+                     SmartPointer<VelocityType> vel, double a = 1.0)
       : levelSet(passedlsDomain), velocities(vel),
-        neighborIterator(levelSet->getDomain()), alphaFactor(a),
+        neighborIterator(std::as_const(*levelSet).getDomain()), alphaFactor(a),
         gridDelta(levelSet->getGrid().getGridDelta()) {}
 
+  /// Use the velocities stored in cache for the center point instead of
+  /// querying the velocity field, where available.
+  void setVelocityCache(const VelocityCache<T> *cache) {
+    velocityCache = cache;
+  }
+
+  /// Share the dissipation coefficients of neighbors between all stencils
+  /// containing them using cache.
+  void setDissipationCache(DissipationCache<T, D> *cache) {
+    dissipationCache = cache;
+  }
+
   std::pair<T, T> operator()(const viennahrle::Index<D> &indices,
                              int material) {
 
@@ -155,12 +205,12 @@ public:
     }
 
     // Get velocities
-    T scalarVelocity = velocities->getScalarVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
-    Vec3D<T> vectorVelocity = velocities->getVectorVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
+    T scalarVelocity;
+    Vec3D<T> vectorVelocity;
+    VelocityCache<T>::getVelocities(velocityCache, *velocities, coordinate,
+                                    material, normalVector,
+                                    neighborIterator.getCenter().getPointId(),
+                                    scalarVelocity, vectorVelocity);
 
     // calculate hamiltonian
     T totalGrad = 0.;
@@ -191,39 +241,33 @@ public:
 
       viennahrle::Index<D> neighborIndex(minIndex);
       for (unsigned i = 0; i < numNeighbors; ++i) {
+        const auto &neighbor = neighborIterator.getNeighbor(neighborIndex);
+        VectorType<T, D> localAlpha;
         Vec3D<T> coords{};
-        for (unsigned dir = 0; dir < D; ++dir) {
-          coords[dir] = coordinate[dir] + neighborIndex[dir] * gridDelta;
-        }
-        Vec3D<T> normal;
-        T normalModulus = 0.;
-        auto center = neighborIterator.getNeighbor(neighborIndex).getValue();
-        for (unsigned dir = 0; dir < D; ++dir) {
-          viennahrle::Index<D> unity(0);
-          unity[dir] = 1;
-          auto neg =
-              neighborIterator.getNeighbor(neighborIndex - unity).getValue();
-          auto pos =
-              neighborIterator.getNeighbor(neighborIndex + unity).getValue();
-          normal[dir] = calculateNormalComponent(neg, center, pos, gridDelta);
-          normalModulus += normal[dir] * normal[dir];
+        if (dissipationCache != nullptr && neighbor.isDefined()) {
+          // alphas of a neighbor only depend on the neighbor itself, so
+          // they are shared by all stencils containing it and must not
+          // depend on the stencil center they are calculated from
+          for (unsigned dir = 0; dir < D; ++dir) {
+            coords[dir] = (indices[dir] + neighborIndex[dir]) * gridDelta;
+          }
+          const auto neighborId = neighbor.getPointId();
+          localAlpha = dissipationCache->get(neighborId, material, [&]() {
+            return calculateLocalAlpha(neighborIndex, coords, material,
+                                       neighborId);
+          });
+        } else {
+          for (unsigned dir = 0; dir < D; ++dir) {
+            coords[dir] = coordinate[dir] + neighborIndex[dir] * gridDelta;
+          }
+          localAlpha = calculateLocalAlpha(
+              neighborIndex, coords, material,
+              neighborIterator.getCenter().getPointId());
         }
-        // normalize normal vector
-        normalModulus = 1. / std::sqrt(normalModulus);
-        for (unsigned dir = 0; dir < D; ++dir)
-          normal[dir] *= normalModulus;
-
-        T scaVel = velocities->getScalarVelocity(
-            coords, material, normal,
-            neighborIterator.getCenter().getPointId());
-        auto vecVel = velocities->getVectorVelocity(
-            coords, material, normal,
-            neighborIterator.getCenter().getPointId());
 
         for (unsigned dir = 0; dir < D; ++dir) {
-          T tempAlpha = std::abs((scaVel + vecVel[dir]) * normal[dir]);
-          alpha[dir] = std::max(alpha[dir], tempAlpha);
-          finalAlphas[dir] = std::max(finalAlphas[dir], tempAlpha);
+          alpha[dir] = std::max(alpha[dir], localAlpha[dir]);
+          finalAlphas[dir] = std::max(finalAlphas[dir], localAlpha[dir]);
         }
 
         // advance to next index
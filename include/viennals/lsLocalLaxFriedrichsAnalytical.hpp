@@ -4,6 +4,7 @@
 
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
+#include <lsVelocityCache.hpp>
 #include <lsVelocityField.hpp>
 
 #include <vcVectorType.hpp>
@@ -17,9 +18,12 @@ using namespace viennacore;
 /// If it is possible to derive analytical solutions for the velocityField
 /// and the alpha values, this spatial discretization scheme should be used and
 /// never otherwise.
-template <class T, int D, int order> class LocalLaxFriedrichsAnalytical {
+template <class T, int D, int order,
+          class VelocityType = viennals::VelocityField<T>>
+class LocalLaxFriedrichsAnalytical {
   SmartPointer<viennals::Domain<T, D>> levelSet;
-  SmartPointer<viennals::VelocityField<T>> velocities;
+  SmartPointer<VelocityType> velocities;
+  const VelocityCache<T> *velocityCache = nullptr;
   // neighbor iterator always needs order 2 for alpha calculation
   viennahrle::ConstSparseBoxIterator<viennahrle::Domain<T, D>, 2>
       neighborIterator;
@@ -55,14 +59,20 @@ public:
 
   LocalLaxFriedrichsAnalytical(
       SmartPointer<viennals::Domain<T, D>> passedlsDomain,
-      SmartPointer<viennals::VelocityField<T>> vel)
+      SmartPointer<VelocityType> vel)
       : levelSet(passedlsDomain), velocities(vel),
-        neighborIterator(levelSet->getDomain()) {
+        neighborIterator(std::as_const(*levelSet).getDomain()) {
     for (int i = 0; i < 3; ++i) {
       finalAlphas[i] = 0;
     }
   }
 
+  /// Use the velocities stored in cache for the center point instead of
+  /// querying the velocity field, where available.
+  void setVelocityCache(const VelocityCache<T> *cache) {
+    velocityCache = cache;
+  }
+
   std::pair<T, T> operator()(const viennahrle::Index<D> &indices,
                              int material) {
 
@@ -159,12 +169,12 @@ public:
     }
 
     // Get velocities
-    T scalarVelocity = velocities->getScalarVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
-    Vec3D<T> vectorVelocity = velocities->getVectorVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
+    T scalarVelocity;
+    Vec3D<T> vectorVelocity;
+    VelocityCache<T>::getVelocities(velocityCache, *velocities, coordinate,
+                                    material, normalVector,
+                                    neighborIterator.getCenter().getPointId(),
+                                    scalarVelocity, vectorVelocity);
 
     // calculate hamiltonian
     T totalGrad = 0.;
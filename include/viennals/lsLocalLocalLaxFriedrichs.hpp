@@ -4,6 +4,7 @@
 
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
+#include <lsVelocityCache.hpp>
 #include <lsVelocityField.hpp>
 
 #include <vcVectorType.hpp>
@@ -15,9 +16,12 @@ using namespace viennacore;
 /// Lax Friedrichs spatial discretization scheme, which considers only the
 /// current point for alpha calculation. Faster than lsLocalLaxFriedrichs but
 /// not as accurate.
-template <class T, int D, int order> class LocalLocalLaxFriedrichs {
+template <class T, int D, int order,
+          class VelocityType = viennals::VelocityField<T>>
+class LocalLocalLaxFriedrichs {
   SmartPointer<viennals::Domain<T, D>> levelSet;
-  SmartPointer<viennals::VelocityField<T>> velocities;
+  SmartPointer<VelocityType> velocities;
+  const VelocityCache<T> *velocityCache = nullptr;
   viennahrle::ConstSparseStarIterator<viennahrle::Domain<T, D>, order>
       neighborIterator;
   const double alphaFactor;
@@ -33,12 +37,17 @@ public:
   }
 
   LocalLocalLaxFriedrichs(SmartPointer<viennals::Domain<T, D>> passedlsDomain,
-                          SmartPointer<viennals::VelocityField<T>> vel,
-                          double a = 1.0)
+                          SmartPointer<VelocityType> vel, double a = 1.0)
       : levelSet(passedlsDomain), velocities(vel),
-        neighborIterator(levelSet->getDomain()), alphaFactor(a),
+        neighborIterator(std::as_const(*levelSet).getDomain()), alphaFactor(a),
         gridDelta(levelSet->getGrid().getGridDelta()) {}
 
+  /// Use the velocities stored in cache for the center point instead of
+  /// querying the velocity field, where available.
+  void setVelocityCache(const VelocityCache<T> *cache) {
+    velocityCache = cache;
+  }
+
   std::pair<T, T> operator()(const viennahrle::Index<D> &indices,
                              int material) {
 
@@ -127,12 +136,12 @@ public:
     }
 
     // Get velocities
-    T scalarVelocity = velocities->getScalarVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
-    Vec3D<T> vectorVelocity = velocities->getVectorVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
+    T scalarVelocity;
+    Vec3D<T> vectorVelocity;
+    VelocityCache<T>::getVelocities(velocityCache, *velocities, coordinate,
+                                    material, normalVector,
+                                    neighborIterator.getCenter().getPointId(),
+                                    scalarVelocity, vectorVelocity);
 
     // calculate hamiltonian
     T totalGrad = 0.;
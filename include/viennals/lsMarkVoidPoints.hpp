@@ -1,5 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <hrleSparseIterator.hpp>
 #include <hrleSparseStarIterator.hpp>
 
 #include <lsDomain.hpp>
@@ -27,44 +34,42 @@ enum struct VoidTopSurfaceEnum : unsigned {
 /// which are enclosed in a void.
 template <class T, int D> class MarkVoidPoints {
   using IndexType = std::size_t;
+  using DomainType = typename Domain<T, D>::DomainType;
+  // component of each run, indexed by segment, level and run type position
+  using ComponentListType = std::vector<std::vector<std::vector<IndexType>>>;
+
+  static constexpr IndexType undefinedComponent =
+      std::numeric_limits<IndexType>::max();
+  // number of grid points in the box around a point, including the point
+  static constexpr int boxSize = hrleUtil::pow(3, D);
+  static constexpr int boxCenter = (boxSize - 1) / 2;
+  // the level set is labelled incrementally only if at most one in this many
+  // points changed its sign
+  static constexpr std::size_t maxChangedPointsRatio = 16;
 
   SmartPointer<Domain<T, D>> domain = nullptr;
   bool reverseVoidDetection = false;
   bool saveComponents = false;
   bool detectLargestSurface = false;
+  bool incremental = false;
   std::size_t numComponents = 0;
 
+  // result of the last labelling, which is updated by incremental labelling
+  SmartPointer<Domain<T, D>> labelledLevelSet = nullptr;
+  SmartPointer<Domain<T, D>> labelledValues = nullptr;
+  std::size_t labelledVersion = 0;
+  ComponentListType labelledComponents;
+  IndexType labelledTopComponent = 0;
+  std::vector<T> labelledVoidMarkers;
+  std::vector<T> labelledComponentMarkers;
+
   // two points are connected if they have the same sign
   static bool areConnected(const T &value1, const T &value2) {
     return (value1 >= 0) == (value2 >= 0);
   }
 
-  std::vector<IndexType> static mergeComponentCounts(
-      const std::vector<IndexType> &components,
-      const std::vector<IndexType> &pointsPerComponent) {
-    // find number of connected components after merge
-    // TODO: the last element in the components vector is very likely
-    // the highest index, so could just set it instead of checking all values
-    unsigned highestIndex = 0;
-    for (auto it : components) {
-      if (highestIndex < it) {
-        highestIndex = it;
-      }
-    }
-
-    // merge pointsPerComponent according to the connected components
-    std::vector<IndexType> pointsPerConnected;
-    pointsPerConnected.resize(highestIndex + 1, 0);
-    for (unsigned i = 0; i < components.size(); ++i) {
-      pointsPerConnected[components[i]] += pointsPerComponent[i];
-    }
-
-    return pointsPerConnected;
-  }
-
   IndexType
-  calculateTopID(const std::vector<IndexType> &components,
-                 const std::vector<IndexType> &pointsPerConnected) const {
+  calculateTopID(const std::vector<IndexType> &pointsPerConnected) const {
     // check which component has the most points
     IndexType topId = 0;
     // use first component, which contains more than 0 points
@@ -82,6 +87,682 @@ template <class T, int D> class MarkVoidPoints {
     return topId;
   }
 
+  static ComponentListType makeComponentList(const DomainType &hrleDomain) {
+    ComponentListType componentList(hrleDomain.getNumberOfSegments());
+    for (unsigned segmentId = 0; segmentId < hrleDomain.getNumberOfSegments();
+         ++segmentId) {
+      componentList[segmentId].resize(D + 1);
+      for (int dim = -1; dim < D; ++dim) {
+        componentList[segmentId][dim + 1].resize(
+            hrleDomain.getNumberOfRuns(segmentId, dim), undefinedComponent);
+      }
+    }
+    return componentList;
+  }
+
+  template <class IteratorType>
+  static IndexType &componentOf(ComponentListType &componentList,
+                                const IteratorType &it) {
+    return componentList[it.getSegmentId()][it.getLevel()]
+                        [it.getRunTypePosition()];
+  }
+
+  // indices of the grid point with the passed position in the box around
+  // center, the positions are numbered with the first dimension running
+  // fastest
+  static viennahrle::Index<D> boxIndices(viennahrle::Index<D> center,
+                                         int position) {
+    for (int i = 0; i < D; ++i) {
+      center[i] += position % 3 - 1;
+      position /= 3;
+    }
+    return center;
+  }
+
+  /// Returns whether all neighbours along the axes of the center of the box
+  /// with the passed sign are connected by grid points of the box with the
+  /// same sign, excluding the center. Then, changing the sign of the center
+  /// neither separates the component of this sign nor connects components
+  /// of the opposite sign. Returns false if there are no such neighbours,
+  /// since changing the sign of the center then removes or creates a
+  /// component.
+  static bool areNeighborsConnected(const std::array<bool, boxSize> &signs,
+                                    const std::array<bool, boxSize> &excluded,
+                                    bool sign) {
+    std::array<bool, boxSize> visited{};
+    std::array<int, boxSize> stack;
+    int stackSize = 0;
+    int numberOfNeighbors = 0;
+    for (int i = 0, step = 1; i < D; ++i, step *= 3) {
+      for (int neighbor : {boxCenter - step, boxCenter + step}) {
+        if (excluded[neighbor] || signs[neighbor] != sign)
+          continue;
+        ++numberOfNeighbors;
+        if (stackSize == 0) {
+          visited[neighbor] = true;
+          stack[stackSize++] = neighbor;
+        }
+      }
+    }
+    if (numberOfNeighbors == 0)
+      return false;
+
+    // flood fill from the first neighbour
+    while (stackSize > 0) {
+      const int position = stack[--stackSize];
+      for (int i = 0, step = 1; i < D; ++i, step *= 3) {
+        const int coordinate = (position / step) % 3;
+        for (int direction : {-1, 1}) {
+          if (coordinate + direction < 0 || coordinate + direction > 2)
+            continue;
+          const int next = position + direction * step;
+          if (next == boxCenter || excluded[next] || visited[next] ||
+              signs[next] != sign)
+            continue;
+          visited[next] = true;
+          stack[stackSize++] = next;
+        }
+      }
+    }
+
+    for (int i = 0, step = 1; i < D; ++i, step *= 3) {
+      for (int neighbor : {boxCenter - step, boxCenter + step}) {
+        if (!excluded[neighbor] && signs[neighbor] == sign)
+          numberOfNeighbors -= visited[neighbor];
+      }
+    }
+    return numberOfNeighbors == 0;
+  }
+
+  void insertMarkers(std::vector<T> voidPointMarkers,
+                     std::vector<T> componentMarkers) {
+    auto &pointData = domain->getPointData();
+    auto voidMarkersPointer = pointData.getScalarData(voidPointLabel, true);
+    // if vector data does not exist
+    if (voidMarkersPointer == nullptr) {
+      pointData.insertNextScalarData(std::move(voidPointMarkers),
+                                     voidPointLabel);
+    } else {
+      *voidMarkersPointer = std::move(voidPointMarkers);
+    }
+
+    if (saveComponents) {
+      auto maxComponent =
+          *std::max_element(componentMarkers.begin(), componentMarkers.end());
+      assert(maxComponent >= 0);
+      numComponents = maxComponent + 1;
+
+      auto componentMarkersPointer =
+          pointData.getScalarData("ConnectedComponentId", true);
+      // if vector data does not exist
+      if (componentMarkersPointer == nullptr) {
+        pointData.insertNextScalarData(std::move(componentMarkers),
+                                       "ConnectedComponentId");
+      } else {
+        *componentMarkersPointer = std::move(componentMarkers);
+      }
+    }
+  }
+
+  /// Stores the result of labelling the level set, so the next call to
+  /// apply() only has to label the points again, which changed since. The
+  /// labelled values are kept as a snapshot, so they are only copied if the
+  /// level set is changed in place.
+  void storeLabelling(ComponentListType &&componentList,
+                      IndexType topComponent,
+                      const std::vector<T> &voidPointMarkers,
+                      const std::vector<T> &componentMarkers) {
+    if (labelledValues == nullptr)
+      labelledValues = Domain<T, D>::New(domain->getGrid());
+    labelledValues->deepCopyOnWrite(domain);
+    labelledLevelSet = domain;
+    labelledVersion = domain->getVersion();
+    labelledComponents = std::move(componentList);
+    labelledTopComponent = topComponent;
+    labelledVoidMarkers = voidPointMarkers;
+    labelledComponentMarkers = componentMarkers;
+  }
+
+  void clearLabelling() {
+    labelledLevelSet = nullptr;
+    labelledValues = nullptr;
+    labelledComponents.clear();
+    labelledVoidMarkers.clear();
+    labelledComponentMarkers.clear();
+  }
+
+  /// Labels the components of the whole level set. Each run is a vertex,
+  /// which is numbered in the order the runs are iterated, so the runs of
+  /// each segment are numbered consecutively. Every segment then connects
+  /// its runs to their neighbours with the same sign in parallel. Since the
+  /// root of each component is its first run, the components are numbered
+  /// in the order of their first runs.
+  void labelComponents() {
+    const auto &grid = domain->getGrid();
+    const auto &hrleDomain = std::as_const(*domain).getDomain();
+    const unsigned numberOfSegments = hrleDomain.getNumberOfSegments();
+
+    // holds the vertex of each run relative to the first vertex of its
+    // segment until the components are known
+    auto componentList = makeComponentList(hrleDomain);
+    std::vector<IndexType> vertexOffsets(numberOfSegments + 1, 0);
+
+#pragma omp parallel num_threads(numberOfSegments)
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+
+      viennahrle::Index<D> const startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : hrleDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> const endVector =
+          (p != static_cast<int>(numberOfSegments - 1))
+              ? hrleDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      IndexType numberOfRuns = 0;
+      for (viennahrle::ConstSparseIterator<DomainType> it(hrleDomain,
+                                                          startVector);
+           it.getStartIndices() < endVector; it.next()) {
+        componentOf(componentList, it) = numberOfRuns++;
+      }
+      vertexOffsets[p + 1] = numberOfRuns;
+    }
+
+    for (unsigned i = 0; i < numberOfSegments; ++i)
+      vertexOffsets[i + 1] += vertexOffsets[i];
+
+    auto vertexOf = [&](const auto &run) {
+      return vertexOffsets[run.getSegmentId()] +
+             componentOf(componentList, run);
+    };
+
+    lsInternal::ConcurrentGraph graph(vertexOffsets.back());
+
+    // connect the runs, runs of different segments are connected
+    // concurrently by the threads of both segments
+#pragma omp parallel num_threads(numberOfSegments)
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+
+      viennahrle::Index<D> const startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : hrleDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> const endVector =
+          (p != static_cast<int>(numberOfSegments - 1))
+              ? hrleDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      for (viennahrle::ConstSparseStarIterator<DomainType, 1> neighborIt(
+               hrleDomain, startVector);
+           neighborIt.getIndices() < endVector; neighborIt.next()) {
+        auto &center = neighborIt.getCenter();
+        const auto centerVertex = vertexOf(center);
+
+        for (int k = 0; k < 2 * D; ++k) {
+          auto &neighbor = neighborIt.getNeighbor(k);
+          if (areConnected(center.getValue(), neighbor.getValue()))
+            graph.insertNextEdge(centerVertex, vertexOf(neighbor));
+        }
+      }
+    }
+
+    // number the roots of each segment
+    std::vector<IndexType> rootNumbers(graph.getNumberOfVertices());
+    std::vector<IndexType> componentOffsets(numberOfSegments + 1, 0);
+
+#pragma omp parallel num_threads(numberOfSegments)
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+
+      IndexType numberOfRoots = 0;
+      for (IndexType vertex = vertexOffsets[p]; vertex < vertexOffsets[p + 1];
+           ++vertex) {
+        if (graph.findRoot(vertex) == vertex)
+          rootNumbers[vertex] = numberOfRoots++;
+      }
+      componentOffsets[p + 1] = numberOfRoots;
+    }
+
+    for (unsigned i = 0; i < numberOfSegments; ++i)
+      componentOffsets[i + 1] += componentOffsets[i];
+    const IndexType numberOfComponents = componentOffsets.back();
+
+    auto componentOfVertex = [&](IndexType vertex) {
+      const auto root = graph.findRoot(vertex);
+      const auto segmentId = std::upper_bound(vertexOffsets.begin(),
+                                              vertexOffsets.end(), root) -
+                             vertexOffsets.begin() - 1;
+      return componentOffsets[segmentId] + rootNumbers[root];
+    };
+
+    // store the connected component of each run instead of its vertex and
+    // count the runs with positive values in each component
+    std::vector<std::vector<IndexType>> pointsPerSegment(numberOfSegments);
+
+#pragma omp parallel num_threads(numberOfSegments)
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+
+      viennahrle::Index<D> const startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : hrleDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> const endVector =
+          (p != static_cast<int>(numberOfSegments - 1))
+              ? hrleDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      auto &pointsPerComponent = pointsPerSegment[p];
+      pointsPerComponent.resize(numberOfComponents, 0);
+
+      for (viennahrle::ConstSparseIterator<DomainType> it(hrleDomain,
+                                                          startVector);
+           it.getStartIndices() < endVector; it.next()) {
+        const auto component = componentOfVertex(vertexOf(it));
+        componentOf(componentList, it) = component;
+        if (it.getValue() >= 0.)
+          ++pointsPerComponent[component];
+      }
+    }
+
+    std::vector<IndexType> pointsPerConnected(numberOfComponents, 0);
+    for (const auto &pointsPerComponent : pointsPerSegment)
+      for (IndexType i = 0; i < numberOfComponents; ++i)
+        pointsPerConnected[i] += pointsPerComponent[i];
+
+    // the component of the lexicographically first or last run
+    int topComponent =
+        (reverseVoidDetection)
+            ? 0
+            : static_cast<int>(componentOfVertex(vertexOffsets.back() - 1));
+
+    // identify which layer to keep
+    // find largest connected surface
+    if (detectLargestSurface) {
+      topComponent = calculateTopID(pointsPerConnected);
+    } else { // if component does not contain points, take the next one
+      while (topComponent >= 0 && pointsPerConnected[topComponent] == 0) {
+        if (reverseVoidDetection)
+          ++topComponent;
+        else
+          --topComponent;
+      }
+    }
+
+    std::vector<T> voidPointMarkers;
+    voidPointMarkers.resize(domain->getNumberOfPoints());
+
+    std::vector<T> componentMarkers;
+    if (saveComponents || incremental)
+      componentMarkers.resize(domain->getNumberOfPoints());
+
+    // cycle through again to set correct voidPointMarkers
+#pragma omp parallel num_threads(domain->getNumberOfSegments())
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+
+      viennahrle::Index<D> const startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : hrleDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> const endVector =
+          (p != static_cast<int>(domain->getNumberOfSegments() - 1))
+              ? hrleDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      for (viennahrle::ConstSparseStarIterator<DomainType, 1> neighborIt(
+               hrleDomain, startVector);
+           neighborIt.getIndices() < endVector; neighborIt.next()) {
+        auto &center = neighborIt.getCenter();
+
+        if (!center.isDefined())
+          continue;
+
+        const auto component = componentOf(componentList, center);
+
+        // if it is positive, just check if it is part of the top component
+        if (center.getValue() >= 0) {
+          voidPointMarkers[center.getPointId()] =
+              (static_cast<int>(component) != topComponent);
+        } else {
+          // if it is negative, check all neighbours (with different sign),
+          // because they are part of of a positive component, which might
+          // be the top
+          unsigned k;
+          for (k = 0; k < 2 * D; ++k) {
+            auto &neighbor = neighborIt.getNeighbor(k);
+            if (std::signbit(neighbor.getValue()) ==
+                std::signbit(center.getValue()))
+              continue;
+            if (static_cast<int>(componentOf(componentList, neighbor)) ==
+                topComponent) {
+              break;
+            }
+          }
+          voidPointMarkers[center.getPointId()] = (k == 2 * D);
+        }
+
+        if (!componentMarkers.empty())
+          componentMarkers[center.getPointId()] = component;
+      }
+    }
+
+    if (incremental && !detectLargestSurface) {
+      storeLabelling(std::move(componentList), topComponent, voidPointMarkers,
+                     componentMarkers);
+    } else {
+      clearLabelling();
+    }
+
+    insertMarkers(std::move(voidPointMarkers), std::move(componentMarkers));
+  }
+
+  /// Labels the level set using the last labelling, if the signs of its
+  /// values have only changed at grid points, which neither separate nor
+  /// connect components. The grid points, whose sign changed, are found by
+  /// comparing the level set to the labelled one. Their signs are changed
+  /// one by one and each change is checked using only the grid points
+  /// around the changed one. Returns false if the level set has to be
+  /// labelled again. This is always the case if the largest surface is
+  /// detected, since any change might make another component the largest,
+  /// and if so many signs changed that labelling it again is quicker.
+  bool labelIncrementally() {
+    if (detectLargestSurface || labelledLevelSet != domain ||
+        labelledValues == nullptr ||
+        labelledValues->getGrid() != domain->getGrid())
+      return false;
+
+    // nothing has changed, but the point data might have
+    if (labelledVersion == domain->getVersion()) {
+      insertMarkers(labelledVoidMarkers, labelledComponentMarkers);
+      return true;
+    }
+
+    const auto &grid = domain->getGrid();
+    const auto &newDomain = std::as_const(*domain).getDomain();
+    const auto &oldDomain = std::as_const(*labelledValues).getDomain();
+    const auto numberOfSegments = newDomain.getNumberOfSegments();
+    using ConstSparseIterator = viennahrle::ConstSparseIterator<DomainType>;
+    using ChangedPointType = std::pair<viennahrle::Index<D>, bool>;
+
+    // grid points whose sign changed and their new sign, sorted by index.
+    // A sign can only change at defined points, unless a whole undefined
+    // run changed its sign.
+    std::vector<std::vector<ChangedPointType>> changedPerSegment(
+        numberOfSegments);
+    bool undefinedRunChanged = false;
+#pragma omp parallel num_threads(numberOfSegments)                             \
+    reduction(|| : undefinedRunChanged)
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+
+      viennahrle::Index<D> const startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : newDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> const endVector =
+          (p != static_cast<int>(numberOfSegments - 1))
+              ? newDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      auto &changedPoints = changedPerSegment[p];
+      ConstSparseIterator newIt(newDomain, startVector);
+      ConstSparseIterator oldIt(oldDomain, startVector);
+      viennahrle::Index<D> position = startVector;
+      while (position < endVector) {
+        newIt.goToIndicesSequential(position);
+        oldIt.goToIndicesSequential(position);
+        const bool newSign = newIt.getValue() >= 0;
+        if (newSign != (oldIt.getValue() >= 0)) {
+          if (!newIt.isDefined() && !oldIt.isDefined()) {
+            undefinedRunChanged = true;
+            break;
+          }
+          changedPoints.emplace_back(position, newSign);
+          position = grid.incrementIndices(position);
+        } else {
+          // continue after the run which ends first
+          const auto &newEnd = newIt.getEndIndices();
+          const auto &oldEnd = oldIt.getEndIndices();
+          position = grid.incrementIndices((newEnd < oldEnd) ? newEnd : oldEnd);
+        }
+      }
+    }
+    if (undefinedRunChanged)
+      return false;
+
+    std::vector<ChangedPointType> changedPoints;
+    for (auto &segmentPoints : changedPerSegment)
+      changedPoints.insert(changedPoints.end(), segmentPoints.begin(),
+                           segmentPoints.end());
+
+    // the changes are checked one after another, so labelling the level set
+    // again in parallel is quicker if many signs changed
+    if (changedPoints.size() * maxChangedPointsRatio >
+        domain->getNumberOfPoints())
+      return false;
+
+    auto findChanged = [&changedPoints](const viennahrle::Index<D> &index) {
+      auto it = std::lower_bound(
+          changedPoints.begin(), changedPoints.end(), index,
+          [](const auto &point, const auto &value) {
+            return point.first < value;
+          });
+      return (it != changedPoints.end() && it->first == index)
+                 ? static_cast<std::size_t>(it - changedPoints.begin())
+                 : changedPoints.size();
+    };
+
+    // every thread looks up the old components using its own iterator
+    auto oldComponent = [&](const viennahrle::Index<D> &index,
+                            ConstSparseIterator &oldLookup) {
+      oldLookup.goToIndices(index);
+      return componentOf(labelledComponents, oldLookup);
+    };
+
+    // change the signs one by one and find the component each changed
+    // point belongs to afterwards
+    std::vector<IndexType> changedComponents(changedPoints.size(),
+                                             undefinedComponent);
+    {
+      ConstSparseIterator newLookup(newDomain);
+      ConstSparseIterator oldLookup(oldDomain);
+      for (std::size_t k = 0; k < changedPoints.size(); ++k) {
+        const auto &[center, newSign] = changedPoints[k];
+
+        // signs of the box around the point after the first k changes,
+        // grid points mapped onto the point itself by the boundary
+        // conditions are not its neighbours
+        std::array<bool, boxSize> signs{};
+        std::array<bool, boxSize> excluded{};
+        std::array<viennahrle::Index<D>, boxSize> indices;
+        excluded[boxCenter] = true;
+        for (int position = 0; position < boxSize; ++position) {
+          if (position == boxCenter)
+            continue;
+          indices[position] =
+              grid.globalIndices2LocalIndices(boxIndices(center, position));
+          if (indices[position] == center) {
+            excluded[position] = true;
+            continue;
+          }
+          const auto changed = findChanged(indices[position]);
+          if (changed < changedPoints.size()) {
+            // points changed later still have their old sign
+            const bool changedSign = changedPoints[changed].second;
+            signs[position] = (changed < k) ? changedSign : !changedSign;
+          } else {
+            newLookup.goToIndices(indices[position]);
+            signs[position] = newLookup.getValue() >= 0;
+          }
+        }
+
+        if (!areNeighborsConnected(signs, excluded, !newSign) ||
+            !areNeighborsConnected(signs, excluded, newSign))
+          return false;
+
+        // the point joins the component of its neighbours with the new
+        // sign, which are all connected
+        for (int i = 0, step = 1;
+             i < D && changedComponents[k] == undefinedComponent;
+             ++i, step *= 3) {
+          for (int neighbor : {boxCenter - step, boxCenter + step}) {
+            if (excluded[neighbor] || signs[neighbor] != newSign)
+              continue;
+            const auto changed = findChanged(indices[neighbor]);
+            changedComponents[k] =
+                (changed < k) ? changedComponents[changed]
+                              : oldComponent(indices[neighbor], oldLookup);
+            break;
+          }
+        }
+        if (changedComponents[k] == undefinedComponent)
+          return false;
+      }
+    }
+
+    auto newComponent = [&](const viennahrle::Index<D> &index,
+                            ConstSparseIterator &oldLookup) {
+      const auto changed = findChanged(index);
+      return (changed < changedPoints.size())
+                 ? changedComponents[changed]
+                 : oldComponent(index, oldLookup);
+    };
+
+    // the markers only change at the changed points and their neighbours
+    std::vector<viennahrle::Index<D>> affectedPoints;
+    for (const auto &[index, sign] : changedPoints) {
+      affectedPoints.push_back(index);
+      for (int i = 0; i < D; ++i) {
+        for (int direction : {-1, 1}) {
+          auto neighbor = index;
+          neighbor[i] += direction;
+          affectedPoints.push_back(grid.globalIndices2LocalIndices(neighbor));
+        }
+      }
+    }
+    std::sort(affectedPoints.begin(), affectedPoints.end());
+    affectedPoints.erase(
+        std::unique(affectedPoints.begin(), affectedPoints.end()),
+        affectedPoints.end());
+
+    // the markers and components of the new level set are set per segment
+    std::vector<T> voidPointMarkers(domain->getNumberOfPoints());
+    std::vector<T> componentMarkers(domain->getNumberOfPoints());
+    auto componentList = makeComponentList(newDomain);
+    bool undefinedComponentFound = false;
+#pragma omp parallel num_threads(numberOfSegments)                             \
+    reduction(|| : undefinedComponentFound)
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+
+      viennahrle::Index<D> const startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : newDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> const endVector =
+          (p != static_cast<int>(numberOfSegments - 1))
+              ? newDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      ConstSparseIterator oldIt(oldDomain, startVector);
+      ConstSparseIterator newLookup(newDomain);
+      ConstSparseIterator oldLookup(oldDomain);
+      auto affectedIt = std::lower_bound(affectedPoints.begin(),
+                                         affectedPoints.end(), startVector);
+      for (ConstSparseIterator it(newDomain, startVector);
+           it.getStartIndices() < endVector; it.next()) {
+        const auto &index = it.getStartIndices();
+        oldIt.goToIndicesSequential(index);
+
+        // component of the run, the points of one run all belong to the
+        // same component
+        const auto changed = findChanged(index);
+        componentOf(componentList, it) =
+            (changed < changedPoints.size())
+                ? changedComponents[changed]
+                : componentOf(labelledComponents, oldIt);
+
+        if (!it.isDefined())
+          continue;
+
+        while (affectedIt != affectedPoints.end() && *affectedIt < index)
+          ++affectedIt;
+        const bool affected =
+            affectedIt != affectedPoints.end() && *affectedIt == index;
+
+        const auto pointId = it.getPointId();
+        if (oldIt.isDefined() && !affected) {
+          voidPointMarkers[pointId] = labelledVoidMarkers[oldIt.getPointId()];
+          componentMarkers[pointId] =
+              labelledComponentMarkers[oldIt.getPointId()];
+          continue;
+        }
+
+        const auto component = newComponent(index, oldLookup);
+        if (component == undefinedComponent) {
+          undefinedComponentFound = true;
+          break;
+        }
+        componentMarkers[pointId] = component;
+
+        if (it.getValue() >= 0) {
+          voidPointMarkers[pointId] = (component != labelledTopComponent);
+          continue;
+        }
+
+        // negative points are void points, unless they are next to the top
+        bool isVoid = true;
+        for (int i = 0; i < D && isVoid; ++i) {
+          for (int direction : {-1, 1}) {
+            auto neighbor = index;
+            neighbor[i] += direction;
+            neighbor = grid.globalIndices2LocalIndices(neighbor);
+            newLookup.goToIndices(neighbor);
+            if (std::signbit(newLookup.getValue()) ==
+                std::signbit(it.getValue()))
+              continue;
+            if (newComponent(neighbor, oldLookup) == labelledTopComponent) {
+              isVoid = false;
+              break;
+            }
+          }
+        }
+        voidPointMarkers[pointId] = isVoid;
+      }
+    }
+    if (undefinedComponentFound)
+      return false;
+
+    storeLabelling(std::move(componentList), labelledTopComponent,
+                   voidPointMarkers, componentMarkers);
+    insertMarkers(std::move(voidPointMarkers), std::move(componentMarkers));
+    return true;
+  }
+
 public:
   static constexpr char voidPointLabel[] = "VoidPointMarkers";
 
@@ -102,6 +783,7 @@ public:
   /// of the coordinate of the point.
   void setReverseVoidDetection(bool passedReverseVoidDetection) {
     reverseVoidDetection = passedReverseVoidDetection;
+    clearLabelling();
   }
 
   /// Set whether the number of points of one connected surface
@@ -112,6 +794,7 @@ public:
   /// surface will be used instead.
   void setDetectLargestSurface(bool passedDetect) {
     detectLargestSurface = passedDetect;
+    clearLabelling();
   }
 
   /// Set which connected component to use as the top surface
@@ -142,6 +825,7 @@ public:
       detectLargestSurface = false;
       break;
     }
+    clearLabelling();
   }
 
   /// Set whether the connected component IDs used to generate the void
@@ -149,186 +833,29 @@ public:
   /// denoting which other points it is connected to.
   void setSaveComponentIds(bool scid) { saveComponents = scid; }
 
+  /// Set whether apply() should only label the grid points again, whose
+  /// sign changed since the last call to apply() on the same level set.
+  /// If none of these changes separates or connects components, the
+  /// components and the top surface of the last call are kept, which is
+  /// much cheaper than labelling the whole level set. Otherwise, the whole
+  /// level set is labelled again, which is always done if the largest
+  /// surface is detected. Defaults to false.
+  void setIncremental(bool passedIncremental) {
+    incremental = passedIncremental;
+    if (!incremental)
+      clearLabelling();
+  }
+
   std::size_t getNumberOfComponents() const { return numComponents; }
 
   void apply() {
-    lsInternal::Graph graph;
-
-    std::vector<std::vector<std::vector<IndexType>>> componentList(
-        domain->getNumberOfSegments());
-    for (unsigned segmentId = 0; segmentId < domain->getNumberOfSegments();
-         ++segmentId) {
-      componentList[segmentId].resize(D + 1);
-      for (int dim = -1; dim < D; ++dim) {
-        componentList[segmentId][dim + 1].resize(
-            domain->getDomain().getNumberOfRuns(segmentId, dim), -1);
-      }
+    if (domain == nullptr) {
+      VIENNACORE_LOG_ERROR("No level set passed to MarkVoidPoints.");
+      return;
     }
 
-    std::size_t numberOfComponents = 0;
-    std::vector<IndexType> pointsPerComponent;
-
-    // cycle through and set up the graph to get connectivity information
-    for (viennahrle::ConstSparseStarIterator<typename Domain<T, D>::DomainType,
-                                             1>
-             neighborIt(domain->getDomain());
-         !neighborIt.isFinished(); neighborIt.next()) {
-      auto &center = neighborIt.getCenter();
-
-      // component id of the current run
-      auto &currentComponentId =
-          componentList[center.getSegmentId()][center.getLevel()]
-                       [center.getRunTypePosition()];
-
-      // -1 means it is not set yet
-      if (currentComponentId == -1) {
-        for (int k = 0; k < 2 * D; ++k) {
-          auto &neighbor = neighborIt.getNeighbor(k);
-          const auto neighborComponentId =
-              componentList[neighbor.getSegmentId()][neighbor.getLevel()]
-                           [neighbor.getRunTypePosition()];
-          // if neighbor is already defined
-          // set current component to neighbor component
-          // if they are connected
-          if (neighborComponentId != -1) {
-            if (areConnected(center.getValue(), neighbor.getValue())) {
-              currentComponentId = neighborComponentId;
-              if (center.getValue() >= 0.)
-                ++pointsPerComponent[currentComponentId];
-              break;
-            }
-          }
-        }
-      }
-
-      // it is still not set, so add new vertex
-      if (currentComponentId == -1) {
-        currentComponentId = numberOfComponents;
-        pointsPerComponent.push_back((center.getValue() > 0.) ? 1 : 0);
-        graph.insertNextVertex();
-        ++numberOfComponents;
-      }
-
-      // check if edge can be set
-      for (int k = 0; k < 2 * D; ++k) {
-        auto &neighbor = neighborIt.getNeighbor(k);
-        auto &neighborComponentId =
-            componentList[neighbor.getSegmentId()][neighbor.getLevel()]
-                         [neighbor.getRunTypePosition()];
-        if (areConnected(center.getValue(), neighbor.getValue())) {
-          // if neighbor is already set
-          if (neighborComponentId != -1) {
-            // if neighbor is part of different component
-            if (currentComponentId != neighborComponentId) {
-              graph.insertNextEdge(currentComponentId, neighborComponentId);
-            }
-          } else {
-            neighborComponentId = currentComponentId;
-            if (neighbor.getValue() >= 0.)
-              ++pointsPerComponent[neighborComponentId];
-          }
-        }
-      }
-    }
-
-    auto components = graph.getConnectedComponents();
-
-    int topComponent =
-        (reverseVoidDetection) ? components[0] : components.back();
-
-    // identify which layer to keep
-    {
-      auto pointsPerConnected =
-          mergeComponentCounts(components, pointsPerComponent);
-
-      // find largest connected surface
-      if (detectLargestSurface) {
-        topComponent = calculateTopID(components, pointsPerConnected);
-      } else { // if component does not contain points, take the next one
-        while (topComponent >= 0 && pointsPerConnected[topComponent] == 0) {
-          if (reverseVoidDetection)
-            ++topComponent;
-          else
-            --topComponent;
-        }
-      }
-    }
-
-    std::vector<T> voidPointMarkers;
-    voidPointMarkers.resize(domain->getNumberOfPoints());
-
-    std::vector<T> componentMarkers;
-    if (saveComponents)
-      componentMarkers.resize(domain->getNumberOfPoints());
-
-    // cycle through again to set correct voidPointMarkers
-    for (viennahrle::ConstSparseStarIterator<typename Domain<T, D>::DomainType,
-                                             1>
-             neighborIt(domain->getDomain());
-         !neighborIt.isFinished(); neighborIt.next()) {
-      auto center = neighborIt.getCenter();
-
-      if (!center.isDefined())
-        continue;
-
-      // if it is positive, just check if it is part of the top component
-      if (center.getValue() >= 0) {
-        const int &oldComponentId = componentList[center.getSegmentId()][0]
-                                                 [center.getRunTypePosition()];
-        voidPointMarkers[center.getPointId()] =
-            (components[oldComponentId] != topComponent);
-      } else {
-        // if it is negative, check all neighbours (with different sign),
-        // because they are part of of a positive component, which might
-        // be the top
-        unsigned k;
-        for (k = 0; k < 2 * D; ++k) {
-          auto &neighbor = neighborIt.getNeighbor(k);
-          if (std::signbit(neighbor.getValue()) ==
-              std::signbit(center.getValue()))
-            continue;
-          const int &oldneighborComponentId =
-              componentList[neighbor.getSegmentId()][neighbor.getLevel()]
-                           [neighbor.getRunTypePosition()];
-          if (components[oldneighborComponentId] == topComponent) {
-            break;
-          }
-        }
-        voidPointMarkers[center.getPointId()] = (k == 2 * D);
-      }
-
-      if (saveComponents) {
-        const int &oldComponentId = componentList[center.getSegmentId()][0]
-                                                 [center.getRunTypePosition()];
-        componentMarkers[center.getPointId()] = components[oldComponentId];
-      }
-    }
-
-    auto &pointData = domain->getPointData();
-    auto voidMarkersPointer = pointData.getScalarData(voidPointLabel, true);
-    // if vector data does not exist
-    if (voidMarkersPointer == nullptr) {
-      pointData.insertNextScalarData(voidPointMarkers, voidPointLabel);
-    } else {
-      *voidMarkersPointer = std::move(voidPointMarkers);
-    }
-
-    if (saveComponents) {
-      auto maxComponent =
-          *std::max_element(componentMarkers.begin(), componentMarkers.end());
-      assert(maxComponent >= 0);
-      numComponents = maxComponent + 1;
-
-      auto componentMarkersPointer =
-          pointData.getScalarData("ConnectedComponentId", true);
-      // if vector data does not exist
-      if (componentMarkersPointer == nullptr) {
-        pointData.insertNextScalarData(componentMarkers,
-                                       "ConnectedComponentId");
-      } else {
-        *componentMarkersPointer = std::move(componentMarkers);
-      }
-    }
+    if (!incremental || !labelIncrementally())
+      labelComponents();
   }
 };
 
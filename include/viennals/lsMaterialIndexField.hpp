@@ -0,0 +1,199 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <hrleSparseIterator.hpp>
+
+#include <lsDomain.hpp>
+
+#include <vcSmartPointer.hpp>
+
+namespace lsInternal {
+
+using namespace viennacore;
+
+/// Material of each point of the top level set of a stack of level sets,
+/// indexed by the point id. The material of a point is the lowest level set
+/// whose value is not larger than the value of the top level set, i.e. the
+/// material which is exposed at that point. The value of the level set
+/// directly below the top level set is stored as well. Finding the material
+/// requires moving an iterator of each lower level set to the point, so it is
+/// done once in a single parallel pass and then looked up by all algorithms
+/// which need it. Consecutive points exposing a static material are joined
+/// into runs, which are stored by the grid indices of their first and last
+/// point, so they remain valid while the point ids change.
+template <class T, int D> class MaterialIndexField {
+  using DomainType = typename viennals::Domain<T, D>::DomainType;
+  using ConstSparseIterator = viennahrle::ConstSparseIterator<DomainType>;
+
+public:
+  /// Grid indices of the first and the last point of a run.
+  using RunType = std::pair<viennahrle::Index<D>, viennahrle::Index<D>>;
+
+private:
+  std::vector<int> materials;
+  std::vector<T> valuesBelow;
+  std::vector<RunType> staticRuns;
+
+public:
+  /// Looks up the static runs of grid points visited in increasing order.
+  class StaticRunCursor {
+    typename std::vector<RunType>::const_iterator current;
+    typename std::vector<RunType>::const_iterator end;
+
+  public:
+    StaticRunCursor(typename std::vector<RunType>::const_iterator begin,
+                    typename std::vector<RunType>::const_iterator passedEnd)
+        : current(begin), end(passedEnd) {}
+
+    /// Returns the static run containing the grid point, or nullptr if the
+    /// point is not part of one. The indices passed to successive calls must
+    /// not decrease.
+    const RunType *find(const viennahrle::Index<D> &indices) {
+      while (current != end && current->second < indices)
+        ++current;
+      if (current != end && !(indices < current->first))
+        return &*current;
+      return nullptr;
+    }
+  };
+
+  MaterialIndexField() = default;
+
+  /// Find the materials of all defined points of the last level set in
+  /// levelSets with an absolute value of at most cutoff. A lower level set
+  /// is exposed if its value is at most epsilon larger than the value of the
+  /// top level set. All other points are marked with material -1. Points
+  /// exposing a material marked in staticMaterials are joined into runs,
+  /// which only end at points exposing another material.
+  void build(const std::vector<SmartPointer<viennals::Domain<T, D>>> &levelSets,
+             T cutoff, T epsilon,
+             const std::vector<bool> &staticMaterials = {}) {
+    clear();
+    if (levelSets.empty())
+      return;
+
+    const auto &topDomain = std::as_const(*levelSets.back()).getDomain();
+    auto &grid = levelSets.back()->getGrid();
+    const unsigned numberOfLevelSets = levelSets.size();
+
+    materials.assign(topDomain.getNumberOfPoints(), -1);
+    valuesBelow.assign(topDomain.getNumberOfPoints(),
+                       std::numeric_limits<T>::max());
+
+    auto isStatic = [&staticMaterials](int material) {
+      return material < static_cast<int>(staticMaterials.size()) &&
+             staticMaterials[material];
+    };
+    std::vector<std::vector<RunType>> segmentRuns(
+        topDomain.getNumberOfSegments());
+
+#pragma omp parallel num_threads(topDomain.getNumberOfSegments())
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+      viennahrle::Index<D> startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : topDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> endVector =
+          (p != static_cast<int>(topDomain.getNumberOfSegments() - 1))
+              ? topDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      // an iterator for each lower level set
+      std::vector<ConstSparseIterator> iterators;
+      for (unsigned i = 0; i + 1 < numberOfLevelSets; ++i) {
+        iterators.emplace_back(std::as_const(*levelSets[i]).getDomain(),
+                               startVector);
+      }
+
+      auto &runs = segmentRuns[p];
+      bool inRun = false;
+
+      for (ConstSparseIterator it(topDomain, startVector);
+           it.getStartIndices() < endVector; it.next()) {
+
+        if (!it.isDefined() || std::abs(it.getValue()) > cutoff)
+          continue;
+
+        const T value = it.getValue();
+        const auto &indices = it.getStartIndices();
+        const auto pointId = it.getPointId();
+
+        // the top level set is exposed if no lower level set is
+        int material = numberOfLevelSets - 1;
+        for (unsigned i = 0; i < iterators.size(); ++i) {
+          iterators[i].goToIndicesSequential(indices);
+          if (iterators[i].getValue() <= value + epsilon) {
+            material = i;
+            break;
+          }
+        }
+        materials[pointId] = material;
+
+        if (isStatic(material)) {
+          if (inRun)
+            runs.back().second = indices;
+          else
+            runs.emplace_back(indices, indices);
+          inRun = true;
+        } else {
+          inRun = false;
+        }
+
+        // the level set directly below might not have been reached
+        if (!iterators.empty()) {
+          auto &below = iterators.back();
+          below.goToIndicesSequential(indices);
+          valuesBelow[pointId] = below.getValue();
+        }
+      }
+    }
+
+    for (auto &runs : segmentRuns)
+      staticRuns.insert(staticRuns.end(), runs.begin(), runs.end());
+  }
+
+  void clear() {
+    materials.clear();
+    valuesBelow.clear();
+    staticRuns.clear();
+  }
+
+  bool empty() const { return materials.empty(); }
+
+  std::size_t size() const { return materials.size(); }
+
+  /// Material exposed at the point, or -1 if it was not part of the pass.
+  int getMaterial(std::size_t pointId) const {
+    return (pointId < materials.size()) ? materials[pointId] : -1;
+  }
+
+  /// Value of the level set directly below the top level set at the point,
+  /// or the largest value of T if there is no lower level set.
+  T getValueBelow(std::size_t pointId) const {
+    return (pointId < valuesBelow.size()) ? valuesBelow[pointId]
+                                          : std::numeric_limits<T>::max();
+  }
+
+  /// Cursor starting at the first static run not ending before startIndices.
+  StaticRunCursor getStaticRunCursor(
+      const viennahrle::Index<D> &startIndices) const {
+    auto begin = std::lower_bound(staticRuns.begin(), staticRuns.end(),
+                                  startIndices,
+                                  [](const RunType &run,
+                                     const viennahrle::Index<D> &indices) {
+                                    return run.second < indices;
+                                  });
+    return StaticRunCursor(begin, staticRuns.end());
+  }
+};
+
+} // namespace lsInternal
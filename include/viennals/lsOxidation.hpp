@@ -38,7 +38,7 @@ std::optional<T> findLOCOSInterfaceY(SmartPointer<Domain<T, 2>> levelSet,
                                      viennahrle::IndexType jMax) {
   using ConstIterator =
       viennahrle::ConstSparseIterator<typename Domain<T, 2>::DomainType>;
-  ConstIterator it(levelSet->getDomain());
+  ConstIterator it(std::as_const(*levelSet).getDomain());
 
   const T gridDelta = levelSet->getGrid().getGridDelta();
   viennahrle::Index<2> previousIndex{i, jMin};
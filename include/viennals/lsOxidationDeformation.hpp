@@ -594,7 +594,7 @@ public:
     using VD = typename PointData<T>::VectorDataType;
     VD velocity, stressR0, stressR1, stressR2;
 
-    ConstSparseIterator it(ambientInterface->getDomain());
+    ConstSparseIterator it(std::as_const(*ambientInterface).getDomain());
     for (; !it.isFinished(); ++it) {
       if (!it.isDefined())
         continue;
@@ -663,7 +663,7 @@ private:
     previousVelocity_.assign(nodes.size(), Vec3D<T>{});
     previousPressure_.assign(nodes.size(), T(0));
 
-    ConstSparseIterator it(ambientInterface->getDomain());
+    ConstSparseIterator it(std::as_const(*ambientInterface).getDomain());
     for (; !it.isFinished(); ++it) {
       if (!it.isDefined())
         continue;
@@ -1034,8 +1034,9 @@ public:
     nodes.clear();
     initNodeLookup();
 
-    ConstSparseIterator reactionIt(reactionInterface->getDomain());
-    ConstSparseIterator ambientIt(ambientInterface->getDomain());
+    ConstSparseIterator reactionIt(
+        std::as_const(*reactionInterface).getDomain());
+    ConstSparseIterator ambientIt(std::as_const(*ambientInterface).getDomain());
     auto maskIt = makeMaskIterator();
 
     IndexType index = minIndex;
@@ -2745,8 +2746,9 @@ public:
     if (nodes.empty())
       return;
 
-    ConstSparseIterator reactionIt(reactionInterface->getDomain());
-    ConstSparseIterator ambientIt(ambientInterface->getDomain());
+    ConstSparseIterator reactionIt(
+        std::as_const(*reactionInterface).getDomain());
+    ConstSparseIterator ambientIt(std::as_const(*ambientInterface).getDomain());
     auto maskIt = makeMaskIterator();
     std::size_t count = 0;
 
@@ -2805,7 +2807,7 @@ public:
     for (unsigned i = 0; i < D; ++i)
       index[i] = std::llround(coordinate[i] / gridDelta);
 
-    ConstSparseIterator ambientIt(ambientInterface->getDomain());
+    ConstSparseIterator ambientIt(std::as_const(*ambientInterface).getDomain());
     const auto normal = levelSetNormal(ambientIt, index);
     return detail::vecScaled(normal, localExpansionSpeed(coordinate));
   }
@@ -2815,7 +2817,7 @@ public:
     if (ambientInterface == nullptr || diffusionField == nullptr)
       return maxVelocity;
 
-    ConstSparseIterator ambientIt(ambientInterface->getDomain());
+    ConstSparseIterator ambientIt(std::as_const(*ambientInterface).getDomain());
     for (; !ambientIt.isFinished(); ++ambientIt) {
       if (!ambientIt.isDefined())
         continue;
@@ -2905,21 +2907,24 @@ public:
   }
 
   Vec3D<T> reactionNormal(const IndexType &index) const {
-    ConstSparseIterator reactionIt(reactionInterface->getDomain());
+    ConstSparseIterator reactionIt(
+        std::as_const(*reactionInterface).getDomain());
     return levelSetNormal(reactionIt, index);
   }
 
   Vec3D<T> interfaceNormal(const IndexType &index, Boundary boundary) const {
     if (boundary == Boundary::AMBIENT) {
-      ConstSparseIterator ambientIt(ambientInterface->getDomain());
+      ConstSparseIterator ambientIt(
+          std::as_const(*ambientInterface).getDomain());
       return levelSetNormal(ambientIt, index);
     }
     if (boundary == Boundary::MASK && maskInterface != nullptr) {
-      ConstSparseIterator maskIt(maskInterface->getDomain());
+      ConstSparseIterator maskIt(std::as_const(*maskInterface).getDomain());
       return levelSetNormal(maskIt, index);
     }
 
-    ConstSparseIterator reactionIt(reactionInterface->getDomain());
+    ConstSparseIterator reactionIt(
+        std::as_const(*reactionInterface).getDomain());
     return levelSetNormal(reactionIt, index);
   }
 
@@ -3179,8 +3184,8 @@ public:
 
   ConstSparseIterator makeMaskIterator() const {
     if (maskInterface == nullptr)
-      return ConstSparseIterator(reactionInterface->getDomain());
-    return ConstSparseIterator(maskInterface->getDomain());
+      return ConstSparseIterator(std::as_const(*reactionInterface).getDomain());
+    return ConstSparseIterator(std::as_const(*maskInterface).getDomain());
   }
 
   bool isInsideMask(ConstSparseIterator &maskIt, const IndexType &index) const {
@@ -331,7 +331,8 @@ public:
           node.concentration;
 
     maxScalarVelocity_ = 0.;
-    ConstSparseIterator reactionIt(reactionInterface->getDomain());
+    ConstSparseIterator reactionIt(
+        std::as_const(*reactionInterface).getDomain());
     for (const auto &node : nodes) {
       const auto sample = reactionBoundarySampleFromNode(reactionIt, node);
       if (!sample.found)
@@ -455,7 +456,7 @@ public:
       return;
 
     std::vector<T> concentrations;
-    ConstSparseIterator it(ambientInterface->getDomain());
+    ConstSparseIterator it(std::as_const(*ambientInterface).getDomain());
     for (; !it.isFinished(); ++it) {
       if (!it.isDefined())
         continue;
@@ -482,7 +483,7 @@ public:
       return;
 
     std::vector<T> pressures;
-    ConstSparseIterator it(ambientInterface->getDomain());
+    ConstSparseIterator it(std::as_const(*ambientInterface).getDomain());
     for (; !it.isFinished(); ++it) {
       if (!it.isDefined())
         continue;
@@ -553,7 +554,7 @@ private:
           (pIdx != -1) ? ambientInterface->getPointData().getScalarData(pIdx)
                        : nullptr;
       if (cd != nullptr || pd != nullptr) {
-        ConstSparseIterator it(ambientInterface->getDomain());
+        ConstSparseIterator it(std::as_const(*ambientInterface).getDomain());
         for (; !it.isFinished(); ++it) {
           if (!it.isDefined())
             continue;
@@ -571,8 +572,9 @@ private:
       }
     }
 
-    ConstSparseIterator reactionIt(reactionInterface->getDomain());
-    ConstSparseIterator ambientIt(ambientInterface->getDomain());
+    ConstSparseIterator reactionIt(
+        std::as_const(*reactionInterface).getDomain());
+    ConstSparseIterator ambientIt(std::as_const(*ambientInterface).getDomain());
     auto maskIt = makeMaskIterator();
 
     IndexType index = minIndex;
@@ -606,8 +608,10 @@ private:
     const std::size_t n = nodes.size();
     faceBCTypes_.assign(2 * D * n, Boundary::NONE);
     faceBCDists_.assign(2 * D * n, T(1));
-    ConstSparseIterator faceReactionIt(reactionInterface->getDomain());
-    ConstSparseIterator faceAmbientIt(ambientInterface->getDomain());
+    ConstSparseIterator faceReactionIt(
+        std::as_const(*reactionInterface).getDomain());
+    ConstSparseIterator faceAmbientIt(
+        std::as_const(*ambientInterface).getDomain());
     auto faceMaskIt = makeMaskIterator();
     for (std::size_t id = 0; id < n; ++id) {
       const auto &node = nodes[id];
@@ -1235,7 +1239,8 @@ private:
   }
 
   ReactionBoundarySample reactionBoundarySample(const IndexType &index) const {
-    ConstSparseIterator reactionIt(reactionInterface->getDomain());
+    ConstSparseIterator reactionIt(
+        std::as_const(*reactionInterface).getDomain());
 
     const std::size_t directId = lookupNode(index);
     if (directId != noNode) {
@@ -1529,8 +1534,8 @@ private:
 
   ConstSparseIterator makeMaskIterator() const {
     if (maskInterface == nullptr)
-      return ConstSparseIterator(reactionInterface->getDomain());
-    return ConstSparseIterator(maskInterface->getDomain());
+      return ConstSparseIterator(std::as_const(*reactionInterface).getDomain());
+    return ConstSparseIterator(std::as_const(*maskInterface).getDomain());
   }
 
   bool isInsideMask(ConstSparseIterator &maskIt, const IndexType &index) const {
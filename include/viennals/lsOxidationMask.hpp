@@ -435,7 +435,7 @@ public:
     const bool useElasticU = isElasticContactMode() && !elasticU_.empty();
 
     VD velocity;
-    ConstSparseIterator it(maskInterface->getDomain());
+    ConstSparseIterator it(std::as_const(*maskInterface).getDomain());
     for (; !it.isFinished(); ++it) {
       if (!it.isDefined())
         continue;
@@ -463,8 +463,8 @@ public:
                             : nodes[i].velocity;
 
     VD stressR0, stressR1, stressR2;
-    for (ConstSparseIterator sit(maskInterface->getDomain()); !sit.isFinished();
-         ++sit) {
+    for (ConstSparseIterator sit(std::as_const(*maskInterface).getDomain());
+         !sit.isFinished(); ++sit) {
       if (!sit.isDefined())
         continue;
       const std::size_t nId = lookupNode(sit.getStartIndices());
@@ -526,7 +526,7 @@ private:
     if (vd == nullptr)
       return;
 
-    ConstSparseIterator it(maskInterface->getDomain());
+    ConstSparseIterator it(std::as_const(*maskInterface).getDomain());
     for (; !it.isFinished(); ++it) {
       if (!it.isDefined())
         continue;
@@ -798,7 +798,7 @@ private:
     ambientPhiCache_.clear();
     if (ambientInterface == nullptr)
       return;
-    for (ConstSparseIterator it(ambientInterface->getDomain());
+    for (ConstSparseIterator it(std::as_const(*ambientInterface).getDomain());
          !it.isFinished(); ++it) {
       if (!it.isDefined())
         continue;
@@ -817,7 +817,7 @@ private:
     initNodeLookup();
     buildAmbientPhiCache();
 
-    ConstSparseIterator maskIt(maskInterface->getDomain());
+    ConstSparseIterator maskIt(std::as_const(*maskInterface).getDomain());
     IndexType index = minIndex;
     while (true) {
       if (isInsideMask(maskIt, index)) {
@@ -2354,8 +2354,8 @@ private:
     if (maskInterface == nullptr)
       return;
     maskGridDelta_ = maskInterface->getGrid().getGridDelta();
-    for (ConstSparseIterator it(maskInterface->getDomain()); !it.isFinished();
-         ++it) {
+    for (ConstSparseIterator it(std::as_const(*maskInterface).getDomain());
+         !it.isFinished(); ++it) {
       if (!it.isDefined())
         continue;
       const auto key = detail::gridIndexHash<D>(it.getStartIndices());
@@ -2382,8 +2382,8 @@ private:
     const T gridDelta = ambientInterface->getGrid().getGridDelta();
     bool foundInterfacePoint = false;
     viennahrle::ConstSparseStarIterator<typename Domain<T, D>::DomainType, 1>
-        neighborIterator(ambientInterface->getDomain());
-    for (ConstSparseIterator it(ambientInterface->getDomain());
+        neighborIterator(std::as_const(*ambientInterface).getDomain());
+    for (ConstSparseIterator it(std::as_const(*ambientInterface).getDomain());
          !it.isFinished(); ++it) {
       if (!it.isDefined() || std::abs(it.getValue()) > T(1))
         continue;
@@ -319,7 +319,7 @@ protected:
 private:
   GridBounds definedPointBounds(SmartPointer<Domain<T, D>> levelSet) const {
     GridBounds bounds;
-    ConstSparseIterator it(levelSet->getDomain());
+    ConstSparseIterator it(std::as_const(*levelSet).getDomain());
     for (; !it.isFinished(); ++it) {
       if (!it.isDefined())
         continue;
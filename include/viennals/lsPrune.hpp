@@ -2,6 +2,7 @@
 
 #include <hrleSparseStarIterator.hpp>
 #include <lsDomain.hpp>
+#include <lsIndexRegion.hpp>
 #include <lsPreCompileMacros.hpp>
 #include <vcVectorType.hpp>
 
@@ -18,6 +19,7 @@ template <class T, int D> class Prune {
   SmartPointer<Domain<T, D>> levelSet = nullptr;
   bool updatePointData = true;
   bool removeStrayZeros = false;
+  IndexRegion<D> region;
 
   template <class Numeric> static bool isNegative(const Numeric a) {
     return a <= -std::numeric_limits<Numeric>::epsilon();
@@ -68,6 +70,12 @@ public:
   /// points with the same sign
   void setRemoveStrayZeros(bool rsz) { removeStrayZeros = rsz; }
 
+  /// Only prune points inside the region and copy all other points
+  /// unchanged. An empty region, the default, prunes the whole level set.
+  void setRegion(const IndexRegion<D> &passedRegion) {
+    region = passedRegion;
+  }
+
   /// removes all grid points, which do not have at least one opposite signed
   /// neighbour
   /// returns the number of removed points
@@ -83,14 +91,14 @@ public:
     }
 
     auto &grid = levelSet->getGrid();
-    auto newlsDomain = SmartPointer<Domain<T, D>>::New(grid);
-    typename Domain<T, D>::DomainType &newDomain = newlsDomain->getDomain();
-    typename Domain<T, D>::DomainType &domain = levelSet->getDomain();
+    typename Domain<T, D>::DomainType &newDomain = levelSet->getBufferDomain();
+    const auto &domain = std::as_const(*levelSet).getDomain();
 
     newDomain.initialize(domain.getNewSegmentation(), domain.getAllocation());
 
     const bool updateData = updatePointData;
     const bool removeZeros = removeStrayZeros;
+    const bool restricted = !region.empty();
     // save how data should be transferred to new level set
     // list of indices into the old pointData vector
     std::vector<std::vector<unsigned>> newDataSourceIds;
@@ -115,81 +123,108 @@ public:
               ? newDomain.getSegmentation()[p]
               : grid.incrementIndices(grid.getMaxGridPoint());
 
-      for (viennahrle::SparseStarIterator<typename Domain<T, D>::DomainType, 1>
-               neighborIt(domain, startVector);
-           neighborIt.getIndices() < endVector; neighborIt.next()) {
-        auto &centerIt = neighborIt.getCenter();
-        bool centerSign = isNegative(centerIt.getValue());
-        if (centerIt.isDefined()) {
-          bool keepPoint = true;
-          // if center is exact zero, always treat as unprunable
-          if (std::abs(centerIt.getValue()) != 0.) {
-            if (removeZeros) {
-              keepPoint =
-                  checkNeighbourSigns(neighborIt, isSignDifferentOrZero<T>);
-            } else {
-              keepPoint = checkNeighbourSigns(neighborIt, isSignDifferent<T>);
+      auto copyRange = [&](const viennahrle::Index<D> &rangeStart,
+                           const viennahrle::Index<D> &rangeEnd) {
+        lsInternal::copyDomainRange(
+            domain, domainSegment, rangeStart, rangeEnd,
+            updateData ? &newDataSourceIds[p] : nullptr);
+      };
+
+      auto pruneRange = [&](const viennahrle::Index<D> &rangeStart,
+                            const viennahrle::Index<D> &rangeEnd) {
+        using StarIterator = viennahrle::SparseStarIterator<
+            typename Domain<T, D>::DomainType, 1>;
+        for (StarIterator neighborIt(domain, rangeStart);
+             neighborIt.getIndices() < rangeEnd; neighborIt.next()) {
+          auto &centerIt = neighborIt.getCenter();
+          bool centerSign = isNegative(centerIt.getValue());
+          if (centerIt.isDefined() && restricted &&
+              !region.contains(neighborIt.getIndices())) {
+            // points outside of the region are kept as they are
+            domainSegment.insertNextDefinedPoint(neighborIt.getIndices(),
+                                                 centerIt.getValue());
+            if (updateData)
+              newDataSourceIds[p].push_back(centerIt.getPointId());
+          } else if (centerIt.isDefined()) {
+            bool keepPoint = true;
+            // if center is exact zero, always treat as unprunable
+            if (std::abs(centerIt.getValue()) != 0.) {
+              if (removeZeros) {
+                keepPoint =
+                    checkNeighbourSigns(neighborIt, isSignDifferentOrZero<T>);
+              } else {
+                keepPoint = checkNeighbourSigns(neighborIt, isSignDifferent<T>);
+              }
             }
-          }
 
-          if (removeZeros) {
-            // if the centre point is 0.0 and the level set values
-            // along each grid dimension are not monotone, it is
-            // a numerical glitch and should be removed
-            if (std::abs(centerIt.getValue()) == 0.) {
-              bool overWritePoint = false;
-              T undefVal = 0.;
-              for (int i = 0; i < D; i++) {
-                const auto &negVal = neighborIt.getNeighbor(i).getValue();
-                const auto &posVal = neighborIt.getNeighbor(D + i).getValue();
-
-                // if LS function is not monotone around the zero value,
-                // set the points value to that of the lower neighbour
-                if (!isMonotone(negVal, posVal)) {
-                  overWritePoint = true;
-                  undefVal =
-                      std::abs(negVal) < std::abs(posVal) ? negVal : posVal;
-                  break;
+            if (removeZeros) {
+              // if the centre point is 0.0 and the level set values
+              // along each grid dimension are not monotone, it is
+              // a numerical glitch and should be removed
+              if (std::abs(centerIt.getValue()) == 0.) {
+                bool overWritePoint = false;
+                T undefVal = 0.;
+                for (int i = 0; i < D; i++) {
+                  const auto &negVal = neighborIt.getNeighbor(i).getValue();
+                  const auto &posVal = neighborIt.getNeighbor(D + i).getValue();
+
+                  // if LS function is not monotone around the zero value,
+                  // set the points value to that of the lower neighbour
+                  if (!isMonotone(negVal, posVal)) {
+                    overWritePoint = true;
+                    undefVal =
+                        std::abs(negVal) < std::abs(posVal) ? negVal : posVal;
+                    break;
+                  }
+                }
+                if (overWritePoint) {
+                  domainSegment.insertNextDefinedPoint(neighborIt.getIndices(),
+                                                       undefVal);
+                  continue;
                 }
-              }
-              if (overWritePoint) {
-                domainSegment.insertNextDefinedPoint(neighborIt.getIndices(),
-                                                     undefVal);
-                continue;
               }
             }
-          }
 
-          if (keepPoint) {
-            domainSegment.insertNextDefinedPoint(neighborIt.getIndices(),
-                                                 centerIt.getValue());
-            if (updateData)
-              newDataSourceIds[p].push_back(centerIt.getPointId());
+            if (keepPoint) {
+              domainSegment.insertNextDefinedPoint(neighborIt.getIndices(),
+                                                   centerIt.getValue());
+              if (updateData)
+                newDataSourceIds[p].push_back(centerIt.getPointId());
+            } else {
+              // TODO: it is more efficient to insertNextUndefinedRunType, since
+              // we know it already exists
+              domainSegment.insertNextUndefinedPoint(
+                  neighborIt.getIndices(),
+                  centerSign ? Domain<T, D>::NEG_VALUE
+                             : Domain<T, D>::POS_VALUE);
+            }
           } else {
-            // TODO: it is more efficient to insertNextUndefinedRunType, since
-            // we know it already exists
             domainSegment.insertNextUndefinedPoint(
-                neighborIt.getIndices(),
-                centerSign ? Domain<T, D>::NEG_VALUE : Domain<T, D>::POS_VALUE);
+                neighborIt.getIndices(), centerSign ? Domain<T, D>::NEG_VALUE
+                                                    : Domain<T, D>::POS_VALUE);
           }
-        } else {
-          domainSegment.insertNextUndefinedPoint(
-              neighborIt.getIndices(),
-              centerSign ? Domain<T, D>::NEG_VALUE : Domain<T, D>::POS_VALUE);
         }
+      };
+
+      if (restricted) {
+        region.splitRange(startVector, endVector, grid, copyRange, pruneRange);
+      } else {
+        pruneRange(startVector, endVector);
       }
     }
 
     // now copy old data into new level set
+    typename Domain<T, D>::PointDataType newPointData;
     if (updateData) {
-      newlsDomain->getPointData().translateFromMultiData(
-          levelSet->getPointData(), newDataSourceIds);
+      newPointData.translateFromMultiData(
+          std::as_const(*levelSet).getPointData(), newDataSourceIds);
     }
 
-    // distribute evenly across segments and copy
+    // distribute evenly across segments and swap in the new values
     newDomain.finalize();
-    newDomain.segment();
-    levelSet->deepCopy(newlsDomain);
+    if (!restricted)
+      newDomain.segment();
+    levelSet->swapBuffer(std::move(newPointData));
     levelSet->finalize(2);
   }
 };
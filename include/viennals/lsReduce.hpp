@@ -66,9 +66,8 @@ public:
     const T valueLimit = width * 0.5;
 
     auto &grid = levelSet->getGrid();
-    auto newlsDomain = Domain<T, D>::New(levelSet->getGrid());
-    typename Domain<T, D>::DomainType &newDomain = newlsDomain->getDomain();
-    typename Domain<T, D>::DomainType &domain = levelSet->getDomain();
+    typename Domain<T, D>::DomainType &newDomain = levelSet->getBufferDomain();
+    const auto &domain = std::as_const(*levelSet).getDomain();
 
     if (noNewSegment)
       newDomain.initialize(domain.getSegmentation(), domain.getAllocation());
@@ -120,16 +119,17 @@ public:
     }
 
     // now copy old data into new level set
+    typename Domain<T, D>::PointDataType newPointData;
     if (updateData) {
-      newlsDomain->getPointData().translateFromMultiData(
-          levelSet->getPointData(), newDataSourceIds);
+      newPointData.translateFromMultiData(
+          std::as_const(*levelSet).getPointData(), newDataSourceIds);
     }
 
-    // distribute evenly across segments and copy
+    // distribute evenly across segments and swap in the new values
     newDomain.finalize();
     if (!noNewSegment)
       newDomain.segment();
-    levelSet->deepCopy(newlsDomain);
+    levelSet->swapBuffer(std::move(newPointData));
     levelSet->finalize(width);
   }
 };
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <lsPreCompileMacros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <hrleSparseStarIterator.hpp>
+
+#include <lsDomain.hpp>
+
+#include <vcLogger.hpp>
+#include <vcSmartPointer.hpp>
+
+namespace viennals {
+
+using namespace viennacore;
+
+/// Replaces the values of all points outside the interface (|value| > 0.5)
+/// with Euclidean distances to the interface, by solving the Eikonal
+/// equation |grad(phi)| = 1 in the narrow band. The interface points are
+/// kept fixed. The values are updated with the first order upwind
+/// (Godunov) discretisation, starting from the current values, which must be
+/// an upper bound of the distance, e.g. the Manhattan distances from
+/// rebuilding the level set. Since information only has to travel through
+/// the few layers of the narrow band, each iteration updates all points from
+/// the values of the previous iteration, which makes the result independent
+/// of the segmentation. Segments are processed in parallel.
+template <class T, int D> class Reinitialize {
+  using DomainType = typename Domain<T, D>::DomainType;
+
+  SmartPointer<Domain<T, D>> levelSet = nullptr;
+  unsigned maxIterations = 0;
+
+  /// Smallest solution of sum_i (u - a_i)^2 = 1 with u > a_i for all used
+  /// a_i, for the sorted upwind neighbour distances a.
+  static T solveEikonal(std::array<T, D> &a) {
+    std::sort(a.begin(), a.end());
+    T sum = 0.;
+    T sumOfSquares = 0.;
+    T u = a[0] + T(1);
+    for (int n = 0; n < D && a[n] < u; ++n) {
+      sum += a[n];
+      sumOfSquares += a[n] * a[n];
+      const T discriminant = sum * sum - (n + 1) * (sumOfSquares - T(1));
+      if (discriminant < 0.)
+        break;
+      u = (sum + std::sqrt(discriminant)) / (n + 1);
+    }
+    return u;
+  }
+
+public:
+  Reinitialize() = default;
+
+  Reinitialize(SmartPointer<Domain<T, D>> passedLevelSet)
+      : levelSet(passedLevelSet) {}
+
+  void setLevelSet(SmartPointer<Domain<T, D>> passedLevelSet) {
+    levelSet = passedLevelSet;
+  }
+
+  /// Set the number of Jacobi iterations. Each iteration moves the
+  /// information by one layer. Defaults to 0, which uses as many iterations
+  /// as there are layers outside the interface.
+  void setMaxIterations(unsigned passedMaxIterations) {
+    maxIterations = passedMaxIterations;
+  }
+
+  void apply() {
+    if (levelSet == nullptr) {
+      Logger::getInstance()
+          .addError("No level set was passed to Reinitialize.")
+          .print();
+      return;
+    }
+
+    if (levelSet->getNumberOfPoints() == 0)
+      return;
+
+    auto &domain = levelSet->getDomain();
+    auto &grid = levelSet->getGrid();
+    const unsigned numberOfSegments = domain.getNumberOfSegments();
+
+    const unsigned iterations =
+        (maxIterations > 0)
+            ? maxIterations
+            : static_cast<unsigned>((levelSet->getLevelSetWidth() + 1) / 2);
+
+    std::vector<std::vector<T>> newValues(numberOfSegments);
+
+    for (unsigned iteration = 0; iteration < iterations; ++iteration) {
+      bool changed = false;
+
+#pragma omp parallel num_threads(numberOfSegments) reduction(|| : changed)
+      {
+        int p = 0;
+#ifdef _OPENMP
+        p = omp_get_thread_num();
+#endif
+        auto &values = newValues[p];
+        values.clear();
+        values.reserve(domain.getDomainSegment(p).getNumberOfPoints());
+
+        viennahrle::Index<D> const startVector =
+            (p == 0) ? grid.getMinGridPoint() : domain.getSegmentation()[p - 1];
+
+        viennahrle::Index<D> const endVector =
+            (p != static_cast<int>(numberOfSegments - 1))
+                ? domain.getSegmentation()[p]
+                : grid.incrementIndices(grid.getMaxGridPoint());
+
+        for (viennahrle::ConstSparseStarIterator<DomainType, 1> neighborIt(
+                 domain, startVector);
+             neighborIt.getIndices() < endVector; neighborIt.next()) {
+
+          auto &centerIt = neighborIt.getCenter();
+          if (!centerIt.isDefined())
+            continue;
+
+          const T value = centerIt.getValue();
+          const T distance = std::abs(value);
+          if (distance <= 0.5) {
+            values.push_back(value);
+            continue;
+          }
+
+          // smallest distance of the defined neighbours along each axis
+          std::array<T, D> upwind;
+          for (int i = 0; i < D; ++i) {
+            upwind[i] = distance;
+            for (int j : {i, i + D}) {
+              auto &neighbor = neighborIt.getNeighbor(j);
+              if (neighbor.isDefined())
+                upwind[i] = std::min(upwind[i], std::abs(neighbor.getValue()));
+            }
+          }
+
+          const T newDistance = solveEikonal(upwind);
+          if (newDistance < distance) {
+            values.push_back((value < 0) ? -newDistance : newDistance);
+            changed = true;
+          } else {
+            values.push_back(value);
+          }
+        }
+      }
+
+      if (!changed)
+        break;
+
+      // only write the values once all of them have been calculated
+#pragma omp parallel num_threads(numberOfSegments)
+      {
+        int p = 0;
+#ifdef _OPENMP
+        p = omp_get_thread_num();
+#endif
+        auto &segment = domain.getDomainSegment(p);
+        std::copy(newValues[p].begin(), newValues[p].end(),
+                  segment.definedValues.begin());
+      }
+    }
+  }
+};
+
+// add all template specialisations for this class
+PRECOMPILE_PRECISION_DIMENSION(Reinitialize)
+
+} // namespace viennals
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include <lsDomain.hpp>
 #include <lsMarkVoidPoints.hpp>
 
@@ -66,7 +68,7 @@ public:
     auto &grid = levelSet->getGrid();
     auto newlsDomain = SmartPointer<Domain<T, D>>::New(grid);
     typename Domain<T, D>::DomainType &newDomain = newlsDomain->getDomain();
-    typename Domain<T, D>::DomainType &domain = levelSet->getDomain();
+    const auto &domain = std::as_const(*levelSet).getDomain();
 
     newDomain.initialize(domain.getNewSegmentation(), domain.getAllocation());
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include <lsDomain.hpp>
 #include <lsMesh.hpp>
 #include <lsPreCompileMacros.hpp>
@@ -115,7 +117,7 @@ public:
 
     // Iterate through the source domain
     viennahrle::ConstSparseIterator<typename Domain<T, 3>::DomainType> it(
-        sourceLevelSet->getDomain());
+        std::as_const(*sourceLevelSet).getDomain());
 
     while (!it.isFinished()) {
       if (!it.isDefined()) {
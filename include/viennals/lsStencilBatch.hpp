@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include <hrleSparseStarIterator.hpp>
+
+#include <lsDomain.hpp>
+
+namespace lsInternal {
+
+/// Number of grid points evaluated together by the batched spatial
+/// discretization schemes.
+constexpr unsigned stencilBatchSize = 16;
+
+/// Star stencils of a batch of grid points, stored as a structure of arrays.
+/// The values of the same stencil point of all points in the batch are
+/// contiguous, so the arithmetic of the spatial discretization schemes can
+/// be evaluated for the whole batch with SIMD instructions.
+/// values[i][radius + k][lane] is the value of the neighbor at offset k
+/// along axis i of the point in lane, so the center is stored for each axis.
+template <class T, int D, int radius> class StencilBatch {
+  viennahrle::ConstSparseStarIterator<viennahrle::Domain<T, D>, radius>
+      neighborIterator;
+
+public:
+  static constexpr unsigned size = stencilBatchSize;
+  static constexpr int width = 2 * radius + 1;
+
+  alignas(64) T values[D][width][size];
+  std::size_t pointIds[size];
+  unsigned count = 0;
+
+  StencilBatch(const viennahrle::Domain<T, D> &domain)
+      : neighborIterator(domain) {}
+
+  void clear() { count = 0; }
+
+  /// Appends the stencil of the grid point to the batch. The indices passed
+  /// to successive calls must not decrease.
+  void gather(const viennahrle::Index<D> &indices) {
+    neighborIterator.goToIndicesSequential(indices);
+    const unsigned lane = count++;
+    const auto &center = neighborIterator.getCenter();
+    pointIds[lane] = center.getPointId();
+    for (int i = 0; i < D; ++i) {
+      values[i][radius][lane] = center.getValue();
+      for (int k = 1; k <= radius; ++k) {
+        values[i][radius + k][lane] =
+            neighborIterator.getNeighbor((k - 1) * 2 * D + i).getValue();
+        values[i][radius - k][lane] =
+            neighborIterator.getNeighbor((k - 1) * 2 * D + D + i).getValue();
+      }
+    }
+  }
+};
+
+/// Whether the spatial discretization scheme can evaluate batches of points
+/// using evaluateBatch().
+template <class SchemeType, class = void>
+struct HasBatchEvaluation : std::false_type {};
+
+template <class SchemeType>
+struct HasBatchEvaluation<
+    SchemeType, std::void_t<decltype(&SchemeType::evaluateBatch)>>
+    : std::true_type {};
+
+} // namespace lsInternal
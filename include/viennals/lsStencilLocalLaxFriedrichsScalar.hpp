@@ -2,9 +2,11 @@
 
 #include <hrleSparseBoxIterator.hpp>
 
+#include <lsDissipationCache.hpp>
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
 #include <lsFiniteDifferences.hpp>
+#include <lsVelocityCache.hpp>
 #include <lsVelocityField.hpp>
 
 #include <vcVectorType.hpp>
@@ -29,12 +31,15 @@ using namespace viennacore;
 /// DOI: 10.1109/SISPAD.2019.8870443
 template <class T, int D, int order,
           DifferentiationSchemeEnum finiteDifferenceScheme =
-              DifferentiationSchemeEnum::FIRST_ORDER>
+              DifferentiationSchemeEnum::FIRST_ORDER,
+          class VelocityType = viennals::VelocityField<T>>
 class StencilLocalLaxFriedrichsScalar {
   using LevelSetType = SmartPointer<viennals::Domain<T, D>>;
 
   LevelSetType levelSet;
-  SmartPointer<viennals::VelocityField<T>> velocities;
+  SmartPointer<VelocityType> velocities;
+  const VelocityCache<T> *velocityCache = nullptr;
+  DissipationCache<T, D> *dissipationCache = nullptr;
   viennahrle::ConstSparseBoxIterator<viennahrle::Domain<T, D>,
                                      static_cast<int>(finiteDifferenceScheme) +
                                          1 + order>
@@ -209,6 +214,98 @@ class StencilLocalLaxFriedrichsScalar {
     return gradient;
   }
 
+  /// Calculate the dissipation coefficients at the stencil point offset by
+  /// currentIndex from the stencil center, which lies at localCoordArray.
+  VectorType<T, D>
+  calculateLocalAlpha(const viennahrle::Index<D> &currentIndex,
+                      const Vec3D<T> &localCoordArray, int material,
+                      unsigned long pointId) {
+    VectorType<T, D> alpha{};
+    Vec3D<T> localNormal = calculateNormal(currentIndex);
+
+    // Check for corrupted normal
+    if ((std::abs(localNormal[0]) < 1e-6) &&
+        (std::abs(localNormal[1]) < 1e-6) &&
+        (std::abs(localNormal[2]) < 1e-6)) {
+      return alpha;
+    }
+
+    // get local velocity
+    T localScalarVelocity = velocities->getScalarVelocity(
+        localCoordArray, material, localNormal, pointId);
+    Vec3D<T> localVectorVelocity = velocities->getVectorVelocity(
+        localCoordArray, material, localNormal, pointId);
+    // now calculate scalar product of normal vector with velocity
+    for (unsigned dir = 0; dir < D; ++dir) {
+      localScalarVelocity += localVectorVelocity[dir] * localNormal[dir];
+    }
+
+    // Calculate epsilon based on selected strategy
+    T DN;
+#if ADAPTIVE_EPSILON_STRATEGY == 0
+    // Original fixed epsilon approach
+    DN = std::abs(baseNormalEpsilon * localScalarVelocity);
+#elif ADAPTIVE_EPSILON_STRATEGY == 1
+    // Simple adaptive epsilon (recommended)
+    DN = calculateSimpleAdaptiveEpsilon(localScalarVelocity);
+#elif ADAPTIVE_EPSILON_STRATEGY == 2
+    // Full adaptive epsilon (most accurate but slower)
+    DN = calculateAdaptiveEpsilon(localScalarVelocity, localCoordArray,
+                                  material, localNormal);
+#else
+    // Fallback to original method
+    DN = std::abs(baseNormalEpsilon * localScalarVelocity);
+#endif
+
+    Vec3D<T> normal_p = localNormal; // p=previous
+    Vec3D<T> normal_n = localNormal; // n=next
+
+    VectorType<T, D> velocityDelta;
+    for (int k = 0; k < D; ++k) {
+
+      normal_p[k] -= DN;
+      normal_n[k] += DN;
+
+      T vp = velocities->getScalarVelocity(localCoordArray, material,
+                                           normal_p, pointId);
+      T vn = velocities->getScalarVelocity(localCoordArray, material,
+                                           normal_n, pointId);
+      // central difference
+      velocityDelta[k] = (vn - vp) / (2.0 * DN);
+
+      normal_p[k] += DN;
+      normal_n[k] -= DN;
+    }
+
+    // determine \partial H / \partial phi_l
+    for (int k = 0; k < D; ++k) { // iterate over dimensions
+
+      // Monti term
+      T monti = 0;
+      // Toifl Quell term
+      T toifl = 0;
+
+      VectorType<T, D> gradient = calculateGradient(currentIndex);
+
+      for (int j = 0; j < D - 1; ++j) { // phi_p**2 + phi_q**2
+        int idx = (k + 1 + j) % D;
+        monti += gradient[idx] * gradient[idx];
+        toifl += gradient[idx] * velocityDelta[idx];
+      }
+      // denominator: |grad(phi)|^2
+      T denom = DotProduct(gradient, gradient);
+      monti *= velocityDelta[k] / denom;
+      toifl *= -gradient[k] / denom;
+
+      // Osher (constant V) term
+      T osher = localScalarVelocity * localNormal[k];
+      // Total derivative is sum of terms given above
+      alpha[k] = std::fabs(monti + toifl + osher);
+    }
+
+    return alpha;
+  }
+
   static void incrementIndex(viennahrle::Index<D> &index) {
     int dim = 0;
     for (; dim < D - 1; ++dim) {
@@ -227,14 +324,26 @@ public:
   }
 
   StencilLocalLaxFriedrichsScalar(LevelSetType passedlsDomain,
-                                  SmartPointer<viennals::VelocityField<T>> vel,
+                                  SmartPointer<VelocityType> vel,
                                   double a = 1.0)
       : levelSet(passedlsDomain), velocities(vel),
-        neighborIterator(levelSet->getDomain()),
+        neighborIterator(std::as_const(*levelSet).getDomain()),
         gridDelta(levelSet->getGrid().getGridDelta()), alphaFactor(a) {}
 
   static void setMaxDissipation(double maxDiss) { maxDissipation = maxDiss; }
 
+  /// Use the velocities stored in cache for the center point instead of
+  /// querying the velocity field, where available.
+  void setVelocityCache(const VelocityCache<T> *cache) {
+    velocityCache = cache;
+  }
+
+  /// Share the dissipation coefficients of stencil points between all
+  /// stencils containing them using cache.
+  void setDissipationCache(DissipationCache<T, D> *cache) {
+    dissipationCache = cache;
+  }
+
   std::pair<T, T> operator()(const viennahrle::Index<D> &indices,
                              int material) {
     // center coordinate of the local stencil
@@ -242,19 +351,19 @@ public:
     for (unsigned i = 0; i < D; ++i) {
       coordinate[i] = indices[i] * gridDelta;
     }
-    const auto pointId = neighborIterator.getCenter().getPointId();
-
     // move neighborIterator to current position
     neighborIterator.goToIndicesSequential(indices);
+    const auto pointId = neighborIterator.getCenter().getPointId();
 
     // if there is a vector velocity, we need to project it onto a scalar
     // velocity first using its normal vector
     Vec3D<T> normalVector = calculateNormal(viennahrle::Index<D>(0));
 
-    double scalarVelocity = velocities->getScalarVelocity(
-        coordinate, material, normalVector, pointId);
-    auto vectorVelocity = velocities->getVectorVelocity(coordinate, material,
-                                                        normalVector, pointId);
+    T scalarVelocity;
+    Vec3D<T> vectorVelocity;
+    VelocityCache<T>::getVelocities(velocityCache, *velocities, coordinate,
+                                    material, normalVector, pointId,
+                                    scalarVelocity, vectorVelocity);
 
     // now calculate scalar product of normal vector with velocity
     for (unsigned i = 0; i < D; ++i) {
@@ -276,91 +385,24 @@ public:
     viennahrle::Index<D> currentIndex(-order);
     // iterate over all points in local stencil and calculate alpha values
     for (auto &alpha : alphas) {
-      Vec3D<T> localNormal = calculateNormal(currentIndex);
-
-      // Check for corrupted normal
-      if ((std::abs(localNormal[0]) < 1e-6) &&
-          (std::abs(localNormal[1]) < 1e-6) &&
-          (std::abs(localNormal[2]) < 1e-6)) {
-        alpha.fill(0);
-        continue;
-      }
-
-      // get local velocity
+      const auto &stencilPoint = neighborIterator.getNeighbor(currentIndex);
       Vec3D<T> localCoordArray = coordinate;
-      for (unsigned dir = 0; dir < D; ++dir)
-        localCoordArray[dir] += currentIndex[dir] * gridDelta;
-
-      T localScalarVelocity = velocities->getScalarVelocity(
-          localCoordArray, material, localNormal, pointId);
-      Vec3D<T> localVectorVelocity = velocities->getVectorVelocity(
-          localCoordArray, material, localNormal, pointId);
-      // now calculate scalar product of normal vector with velocity
-      for (unsigned dir = 0; dir < D; ++dir) {
-        localScalarVelocity += localVectorVelocity[dir] * localNormal[dir];
-      }
-
-      // Calculate epsilon based on selected strategy
-      T DN;
-#if ADAPTIVE_EPSILON_STRATEGY == 0
-      // Original fixed epsilon approach
-      DN = std::abs(baseNormalEpsilon * localScalarVelocity);
-#elif ADAPTIVE_EPSILON_STRATEGY == 1
-      // Simple adaptive epsilon (recommended)
-      DN = calculateSimpleAdaptiveEpsilon(localScalarVelocity);
-#elif ADAPTIVE_EPSILON_STRATEGY == 2
-      // Full adaptive epsilon (most accurate but slower)
-      DN = calculateAdaptiveEpsilon(localScalarVelocity, localCoordArray,
-                                    material, localNormal);
-#else
-      // Fallback to original method
-      DN = std::abs(baseNormalEpsilon * localScalarVelocity);
-#endif
-
-      Vec3D<T> normal_p = localNormal; // p=previous
-      Vec3D<T> normal_n = localNormal; // n=next
-
-      VectorType<T, D> velocityDelta;
-      for (int k = 0; k < D; ++k) {
-
-        normal_p[k] -= DN;
-        normal_n[k] += DN;
-
-        T vp = velocities->getScalarVelocity(localCoordArray, material,
-                                             normal_p, pointId);
-        T vn = velocities->getScalarVelocity(localCoordArray, material,
-                                             normal_n, pointId);
-        // central difference
-        velocityDelta[k] = (vn - vp) / (2.0 * DN);
-
-        normal_p[k] += DN;
-        normal_n[k] -= DN;
-      }
-
-      // determine \partial H / \partial phi_l
-      for (int k = 0; k < D; ++k) { // iterate over dimensions
-
-        // Monti term
-        T monti = 0;
-        // Toifl Quell term
-        T toifl = 0;
-
-        VectorType<T, D> gradient = calculateGradient(currentIndex);
-
-        for (int j = 0; j < D - 1; ++j) { // phi_p**2 + phi_q**2
-          int idx = (k + 1 + j) % D;
-          monti += gradient[idx] * gradient[idx];
-          toifl += gradient[idx] * velocityDelta[idx];
-        }
-        // denominator: |grad(phi)|^2
-        T denom = DotProduct(gradient, gradient);
-        monti *= velocityDelta[k] / denom;
-        toifl *= -gradient[k] / denom;
-
-        // Osher (constant V) term
-        T osher = localScalarVelocity * localNormal[k];
-        // Total derivative is sum of terms given above
-        alpha[k] = std::fabs(monti + toifl + osher);
+      if (dissipationCache != nullptr && stencilPoint.isDefined()) {
+        // alphas of a stencil point only depend on the point itself, so
+        // they are shared by all stencils containing it and must not depend
+        // on the stencil center they are calculated from
+        for (unsigned dir = 0; dir < D; ++dir)
+          localCoordArray[dir] = (indices[dir] + currentIndex[dir]) * gridDelta;
+        const auto stencilPointId = stencilPoint.getPointId();
+        alpha = dissipationCache->get(stencilPointId, material, [&]() {
+          return calculateLocalAlpha(currentIndex, localCoordArray, material,
+                                     stencilPointId);
+        });
+      } else {
+        for (unsigned dir = 0; dir < D; ++dir)
+          localCoordArray[dir] += currentIndex[dir] * gridDelta;
+        alpha = calculateLocalAlpha(currentIndex, localCoordArray, material,
+                                    pointId);
       }
 
       incrementIndex(currentIndex);
@@ -398,9 +440,9 @@ public:
 };
 
 template <class T, int D, int order,
-          DifferentiationSchemeEnum finiteDifferenceScheme>
-double StencilLocalLaxFriedrichsScalar<T, D, order,
-                                       finiteDifferenceScheme>::maxDissipation =
+          DifferentiationSchemeEnum finiteDifferenceScheme, class VelocityType>
+double StencilLocalLaxFriedrichsScalar<T, D, order, finiteDifferenceScheme,
+                                       VelocityType>::maxDissipation =
     std::numeric_limits<double>::max();
 
 } // namespace lsInternal
@@ -0,0 +1,388 @@
+#pragma once
+
+#include <lsPreCompileMacros.hpp>
+
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <hrleSparseBoxIterator.hpp>
+#include <hrleSparseStarIterator.hpp>
+
+#include <lsDomain.hpp>
+
+#include <vcLogger.hpp>
+#include <vcSmartPointer.hpp>
+
+namespace viennals {
+
+using namespace viennacore;
+
+enum struct StencilShapeEnum : unsigned {
+  STAR = 0, ///< the center and the neighbors along the axes
+  BOX = 1   ///< all grid points within the radius in every direction
+};
+
+/// Values and point ids of the stencils of all defined points of a level
+/// set, collected in one parallel sweep. Algorithms which need the
+/// neighbors of every point can read them from the snapshot instead of
+/// moving their own sparse iterators through the level set, so several
+/// algorithms working on the same level set share a single sweep. The
+/// stencil of each point is stored contiguously and indexed by the point id.
+/// The snapshot remembers the version of the level set it was built from
+/// (see Domain::getVersion()) and apply() only builds it again if the level
+/// set was changed since. Star stencils of radius r hold 2 * D * r + 1
+/// points, box stencils (2 * r + 1)^D points.
+template <class T, int D> class StencilSnapshot {
+public:
+  using DomainType = typename Domain<T, D>::DomainType;
+
+  static constexpr viennahrle::SizeType undefinedPointId =
+      std::numeric_limits<viennahrle::SizeType>::max();
+  static constexpr int maxRadius = 3;
+
+  /// Value and point id of one grid point of a stencil.
+  class StencilPoint {
+    T value = 0.;
+    viennahrle::SizeType pointId = undefinedPointId;
+
+  public:
+    StencilPoint() = default;
+
+    StencilPoint(T passedValue, viennahrle::SizeType passedPointId)
+        : value(passedValue), pointId(passedPointId) {}
+
+    T getValue() const { return value; }
+
+    bool isDefined() const { return pointId != undefinedPointId; }
+
+    viennahrle::SizeType getPointId() const { return pointId; }
+  };
+
+  /// Stencil of one defined point. It offers the same interface as the
+  /// sparse neighbor iterators, so it can be passed to the functions which
+  /// evaluate derivatives from an iterator, e.g. lsInternal::meanCurvature.
+  class Stencil {
+    const StencilSnapshot &snapshot;
+    const StencilPoint *points;
+    viennahrle::SizeType pointId;
+
+  public:
+    using DomainType = typename Domain<T, D>::DomainType;
+
+    Stencil(const StencilSnapshot &passedSnapshot,
+            viennahrle::SizeType passedPointId)
+        : snapshot(passedSnapshot),
+          points(&passedSnapshot.points[passedPointId *
+                                        passedSnapshot.stencilSize]),
+          pointId(passedPointId) {}
+
+    const DomainType &getDomain() const {
+      return std::as_const(*snapshot.levelSet).getDomain();
+    }
+
+    const viennahrle::Index<D> &getIndices() const {
+      return snapshot.indices[pointId];
+    }
+
+    const StencilPoint &getCenter() const {
+      return points[snapshot.centerPosition];
+    }
+
+    /// Neighbor at the offset from the center, which must be part of the
+    /// stencil.
+    const StencilPoint &getNeighbor(const viennahrle::Index<D> &offset) const {
+      const int position = snapshot.getPosition(offset);
+      assert(position >= 0);
+      return points[position];
+    }
+
+    /// Neighbor number neighbor. Star stencils number the neighbors like
+    /// ConstSparseStarIterator, box stencils number all of their points,
+    /// see getSize().
+    const StencilPoint &getNeighbor(int neighbor) const {
+      return points[(snapshot.shape == StencilShapeEnum::STAR) ? neighbor + 1
+                                                               : neighbor];
+    }
+
+    /// Number of neighbors which can be accessed by number.
+    unsigned getSize() const { return snapshot.getNumberOfNeighbors(); }
+  };
+
+private:
+  SmartPointer<Domain<T, D>> levelSet = nullptr;
+  StencilShapeEnum shape = StencilShapeEnum::STAR;
+  int radius = 1;
+
+  // the level set version, shape and radius the stencils were built for
+  std::size_t builtVersion = 0;
+  StencilShapeEnum builtShape = StencilShapeEnum::STAR;
+  int builtRadius = 0;
+
+  // the values the stencils are collected from while building them
+  const DomainType *domain = nullptr;
+  unsigned stencilSize = 0;
+  unsigned centerPosition = 0;
+  std::vector<StencilPoint> points;
+  std::vector<viennahrle::Index<D>> indices;
+
+  /// Position of the grid point at offset within each stencil, or -1 if it
+  /// is not part of the stencil.
+  int getPosition(const viennahrle::Index<D> &offset) const {
+    if (shape == StencilShapeEnum::STAR) {
+      int axis = -1;
+      for (int i = 0; i < D; ++i) {
+        if (offset[i] == 0)
+          continue;
+        if (axis >= 0)
+          return -1;
+        axis = i;
+      }
+      if (axis < 0)
+        return 0;
+      const int distance = std::abs(offset[axis]);
+      if (distance > radius)
+        return -1;
+      return 1 + (distance - 1) * 2 * D + axis + ((offset[axis] < 0) ? D : 0);
+    }
+
+    const int width = 2 * radius + 1;
+    int position = 0;
+    for (int i = D - 1; i >= 0; --i) {
+      if (std::abs(offset[i]) > radius)
+        return -1;
+      position = position * width + offset[i] + radius;
+    }
+    return position;
+  }
+
+  unsigned getNumberOfNeighbors() const {
+    return (shape == StencilShapeEnum::STAR) ? stencilSize - 1 : stencilSize;
+  }
+
+  /// Offsets of the stencil points in the order they are stored.
+  std::vector<viennahrle::Index<D>> getOffsets() const {
+    std::vector<viennahrle::Index<D>> offsets;
+    if (shape == StencilShapeEnum::STAR) {
+      offsets.emplace_back(0);
+      for (int distance = 1; distance <= radius; ++distance) {
+        for (int sign : {1, -1}) {
+          for (int i = 0; i < D; ++i) {
+            viennahrle::Index<D> offset(0);
+            offset[i] = sign * distance;
+            offsets.push_back(offset);
+          }
+        }
+      }
+      return offsets;
+    }
+
+    viennahrle::Index<D> offset(-radius);
+    while (true) {
+      offsets.push_back(offset);
+      int i = 0;
+      while (i < D && offset[i] == radius) {
+        offset[i] = -radius;
+        ++i;
+      }
+      if (i == D)
+        break;
+      ++offset[i];
+    }
+    return offsets;
+  }
+
+  template <class NeighborIterator>
+  void collectStencils(const viennahrle::Index<D> &startVector,
+                       const viennahrle::Index<D> &endVector,
+                       const std::vector<viennahrle::Index<D>> &offsets) {
+    const viennahrle::Index<D> centerOffset(0);
+    for (NeighborIterator neighborIt(*domain, startVector);
+         neighborIt.getIndices() < endVector; neighborIt.next()) {
+      auto &center = neighborIt.getCenter();
+      if (!center.isDefined())
+        continue;
+
+      const auto pointId = center.getPointId();
+      indices[pointId] = neighborIt.getIndices();
+      auto *stencil = &points[pointId * stencilSize];
+      for (unsigned n = 0; n < stencilSize; ++n) {
+        auto &neighbor = (offsets[n] == centerOffset)
+                             ? center
+                             : neighborIt.getNeighbor(offsets[n]);
+        stencil[n] = StencilPoint(neighbor.getValue(),
+                                  neighbor.isDefined() ? neighbor.getPointId()
+                                                       : undefinedPointId);
+      }
+    }
+  }
+
+  template <int order> void build() {
+    auto &grid = levelSet->getGrid();
+    // only reading the values keeps the version of the level set
+    domain = &std::as_const(*levelSet).getDomain();
+
+    const auto offsets = getOffsets();
+    stencilSize = offsets.size();
+    centerPosition = getPosition(viennahrle::Index<D>(0));
+    points.assign(domain->getNumberOfPoints() * stencilSize, StencilPoint());
+    indices.resize(domain->getNumberOfPoints());
+
+#pragma omp parallel num_threads(domain->getNumberOfSegments())
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+      viennahrle::Index<D> const startVector =
+          (p == 0) ? grid.getMinGridPoint() : domain->getSegmentation()[p - 1];
+
+      viennahrle::Index<D> const endVector =
+          (p != static_cast<int>(domain->getNumberOfSegments() - 1))
+              ? domain->getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      if (shape == StencilShapeEnum::STAR) {
+        collectStencils<viennahrle::ConstSparseStarIterator<DomainType, order>>(
+            startVector, endVector, offsets);
+      } else {
+        collectStencils<viennahrle::ConstSparseBoxIterator<DomainType, order>>(
+            startVector, endVector, offsets);
+      }
+    }
+  }
+
+public:
+  StencilSnapshot() = default;
+
+  StencilSnapshot(SmartPointer<Domain<T, D>> passedLevelSet,
+                  StencilShapeEnum passedShape = StencilShapeEnum::STAR,
+                  int passedRadius = 1)
+      : levelSet(passedLevelSet), shape(passedShape), radius(passedRadius) {}
+
+  void setLevelSet(SmartPointer<Domain<T, D>> passedLevelSet) {
+    levelSet = passedLevelSet;
+  }
+
+  SmartPointer<Domain<T, D>> getLevelSet() const { return levelSet; }
+
+  /// Set the shape of the stencils. Defaults to STAR.
+  void setShape(StencilShapeEnum passedShape) { shape = passedShape; }
+
+  StencilShapeEnum getShape() const { return shape; }
+
+  /// Set the largest distance of the stencil points from the center along
+  /// each axis. At most maxRadius. Defaults to 1.
+  void setRadius(int passedRadius) { radius = passedRadius; }
+
+  int getRadius() const { return radius; }
+
+  /// Whether the stencils contain all points of a stencil of the given
+  /// shape and radius.
+  bool contains(StencilShapeEnum passedShape, int passedRadius) const {
+    return passedRadius <= radius &&
+           (shape == StencilShapeEnum::BOX || passedShape == shape);
+  }
+
+  /// Whether the stencils were built from the current values of the level
+  /// set with the current shape and radius.
+  bool isValid() const {
+    return levelSet != nullptr && builtVersion == levelSet->getVersion() &&
+           builtShape == shape && builtRadius == radius;
+  }
+
+  /// Number of stencils, i.e. the number of defined points of the level set
+  /// when the snapshot was built.
+  std::size_t getNumberOfPoints() const { return indices.size(); }
+
+  /// Stencil of the defined point with the point id.
+  Stencil getStencil(viennahrle::SizeType pointId) const {
+    return Stencil(*this, pointId);
+  }
+
+  /// Free the memory held by the stencils.
+  void clear() {
+    points = std::vector<StencilPoint>();
+    indices = std::vector<viennahrle::Index<D>>();
+    builtVersion = 0;
+    builtRadius = 0;
+  }
+
+  /// Collect the stencils of all defined points, unless they are still
+  /// valid.
+  void apply() {
+    if (levelSet == nullptr) {
+      Logger::getInstance()
+          .addError("No level set was passed to StencilSnapshot.")
+          .print();
+      return;
+    }
+    if (radius < 1 || radius > maxRadius) {
+      Logger::getInstance()
+          .addError("StencilSnapshot: Radius must be between 1 and " +
+                    std::to_string(maxRadius) + ".")
+          .print();
+      return;
+    }
+
+    if (isValid())
+      return;
+
+    switch (radius) {
+    case 1:
+      build<1>();
+      break;
+    case 2:
+      build<2>();
+      break;
+    default:
+      build<3>();
+      break;
+    }
+
+    builtVersion = levelSet->getVersion();
+    builtShape = shape;
+    builtRadius = radius;
+  }
+};
+
+// add all template specialisations for this class
+PRECOMPILE_PRECISION_DIMENSION(StencilSnapshot)
+
+} // namespace viennals
+
+namespace lsInternal {
+
+/// Brings the stencil snapshot passed to an algorithm up to date. Returns
+/// whether the algorithm can read its stencils of the given shape and
+/// radius from the snapshot. Otherwise, the algorithm has to iterate over
+/// the level set itself and a warning is printed if a snapshot was passed.
+template <class T, int D>
+bool prepareStencilSnapshot(
+    const viennacore::SmartPointer<viennals::StencilSnapshot<T, D>> &snapshot,
+    const viennacore::SmartPointer<viennals::Domain<T, D>> &levelSet,
+    viennals::StencilShapeEnum shape, int radius,
+    const std::string &algorithm) {
+  if (snapshot == nullptr)
+    return false;
+
+  if (snapshot->getLevelSet() != levelSet) {
+    VIENNACORE_LOG_WARNING(algorithm + ": The stencil snapshot belongs to "
+                                       "another level set. Not using it.");
+    return false;
+  }
+  if (!snapshot->contains(shape, radius)) {
+    VIENNACORE_LOG_WARNING(algorithm + ": The stencil snapshot does not "
+                                       "contain the required stencils. Not "
+                                       "using it.");
+    return false;
+  }
+
+  snapshot->apply();
+  return snapshot->isValid();
+}
+
+} // namespace lsInternal
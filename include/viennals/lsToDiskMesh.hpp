@@ -7,9 +7,11 @@
 #include <lsCalculateNormalVectors.hpp>
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
+#include <lsMaterialIndexField.hpp>
 #include <lsMaterialMap.hpp>
 #include <lsMesh.hpp>
 #include <unordered_map>
+#include <utility>
 
 namespace viennals {
 
@@ -107,8 +109,9 @@ public:
 
     const T gridDelta = levelSets.back()->getGrid().getGridDelta();
     const auto &normalVectors =
-        *(levelSets.back()->getPointData().getVectorData(
-            CalculateNormalVectors<T, D>::normalVectorsLabel));
+        *(std::as_const(*levelSets.back())
+              .getPointData()
+              .getVectorData(CalculateNormalVectors<T, D>::normalVectorsLabel));
 
     // set up data arrays
     std::vector<N> values;
@@ -135,14 +138,14 @@ public:
       translator->reserve(normalVectors.size());
     }
 
-    // an iterator for each levelset
-    std::vector<viennahrle::ConstSparseIterator<hrleDomainType>> iterators;
-    for (const auto levelSet : levelSets) {
-      iterators.emplace_back(levelSet->getDomain());
-    }
+    // find the exposed material of all points in a single parallel pass
+    lsInternal::MaterialIndexField<T, D> materialIndices;
+    materialIndices.build(levelSets, maxValue, wrappingLayerEpsilon);
 
     // iterate over top levelset
-    for (auto &topIt = iterators.back(); !topIt.isFinished(); ++topIt) {
+    for (viennahrle::ConstSparseIterator<hrleDomainType> topIt(
+             std::as_const(*levelSets.back()).getDomain());
+         !topIt.isFinished(); ++topIt) {
       if (!topIt.isDefined() || std::abs(topIt.getValue()) > maxValue) {
         continue;
       }
@@ -156,19 +159,7 @@ public:
 
       // insert material ID
       const T value = topIt.getValue();
-      int matId = levelSets.size() - 1;
-      for (int lowerLevelSetId = 0; lowerLevelSetId < levelSets.size() - 1;
-           ++lowerLevelSetId) {
-        // check if there is any other levelset at the same point:
-        // put iterator to same position as the top levelset
-        iterators[lowerLevelSetId].goToIndicesSequential(
-            topIt.getStartIndices());
-        if (iterators[lowerLevelSetId].getValue() <=
-            value + wrappingLayerEpsilon) {
-          matId = lowerLevelSetId;
-          break;
-        }
-      }
+      int matId = materialIndices.getMaterial(pointId);
       if (useMaterialMap)
         matId = materialMap->getMaterialId(matId);
 
@@ -57,7 +57,7 @@ template <class T, int D> class ToHullMesh {
     for (auto &ls : levelSets) {
       if (ls->getNumberOfPoints() == 0)
         continue;
-      auto &dom = ls->getDomain();
+      const auto &dom = std::as_const(*ls).getDomain();
       auto &grd = ls->getGrid();
       for (int i = 0; i < D; ++i) {
         int minP = (grd.isNegBoundaryInfinite(i)) ? dom.getMinRunBreak(i) - 1
@@ -129,7 +129,7 @@ template <class T, int D> class ToHullMesh {
           }
 
           viennahrle::ConstDenseIterator<hrleDomainType> it(
-              levelSets.back()->getDomain());
+              std::as_const(*levelSets.back()).getDomain());
           it.goToIndices(idx);
           if (it.getValue() > 0.)
             return;
@@ -162,7 +162,7 @@ template <class T, int D> class ToHullMesh {
 
           for (unsigned l = 0; l < levelSets.size(); ++l) {
             viennahrle::ConstDenseIterator<hrleDomainType> it(
-                levelSets[l]->getDomain());
+                std::as_const(*levelSets[l]).getDomain());
             it.goToIndices(queryIdx);
             double val = it.getValue();
             if (val < -1e-6 * gridDelta) {
@@ -307,7 +307,7 @@ template <class T, int D> class ToHullMesh {
 
                 for (unsigned l = 0; l < levelSets.size(); ++l) {
                   viennahrle::ConstDenseIterator<hrleDomainType> it(
-                      levelSets[l]->getDomain());
+                      std::as_const(*levelSets[l]).getDomain());
                   it.goToIndices(idx);
                   if (it.getValue() <= 0) {
                     mask |= (1 << k);
@@ -2,6 +2,7 @@
 
 #include <lsPreCompileMacros.hpp>
 
+#include <utility>
 #include <vector>
 
 #include <hrleSparseIterator.hpp>
@@ -71,7 +72,7 @@ public:
     std::vector<T> LSValues;
     std::vector<T> subLS;
     // point data
-    const auto &pointData = levelSet->getPointData();
+    const auto &pointData = std::as_const(*levelSet).getPointData();
     using DomainType = Domain<T, D>;
     using ScalarDataType = typename DomainType::PointDataType::ScalarDataType;
     using VectorDataType = typename DomainType::PointDataType::VectorDataType;
@@ -85,7 +86,7 @@ public:
     const T gridDelta = levelSet->getGrid().getGridDelta();
 
     for (viennahrle::ConstSparseIterator<hrleDomainType> it(
-             levelSet->getDomain());
+             std::as_const(*levelSet).getDomain());
          !it.isFinished(); ++it) {
       if ((onlyDefined && !it.isDefined()) ||
           (onlyActive && std::abs(it.getValue()) > 0.5))
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <utility>
+
 #include <lsMaterialMap.hpp>
 #include <lsToSurfaceMesh.hpp>
 
@@ -62,7 +64,7 @@ class ToMultiSurfaceMesh : public ToSurfaceMesh<NumericType, D> {
       // Evaluate LS_m at the active grid corner of material l's corner cell.
       // delta approximates the local layer thickness between material m and l.
       viennahrle::ConstSparseIterator<hrleDomainType> mIt(
-          levelSets[m]->getDomain());
+          std::as_const(*levelSets[m]).getDomain());
       mIt.goToIndices(activeGridIdx);
       const NumericType lsMAtActive = mIt.getValue();
       // Only apply the layer-thickness check when the active corner is inside
@@ -663,7 +665,7 @@ public:
     // an iterator for each level set
     std::vector<viennahrle::ConstSparseCellIterator<hrleDomainType>> cellIts;
     for (const auto &ls : levelSets)
-      cellIts.emplace_back(ls->getDomain());
+      cellIts.emplace_back(std::as_const(*ls).getDomain());
 
     // Explicit storage for sharp corner nodes, keyed by material index
     std::unordered_map<unsigned, std::vector<SharpCornerNode>> sharpCornerNodes;
@@ -681,12 +683,15 @@ public:
             NormalCalculationMethodEnum::ONE_SIDED_MIN_MOD);
         normalCalculator.setMaxValue(std::numeric_limits<NumericType>::max());
         normalCalculator.apply();
-        normalVectorData = currentLevelSet->getPointData().getVectorData(
-            CalculateNormalVectors<NumericType, D>::normalVectorsLabel);
+        normalVectorData =
+            std::as_const(*currentLevelSet)
+                .getPointData()
+                .getVectorData(
+                    CalculateNormalVectors<NumericType, D>::normalVectorsLabel);
       }
 
       viennahrle::ConstSparseIterator<hrleDomainType> valueIt(
-          currentLevelSet->getDomain());
+          std::as_const(*currentLevelSet).getDomain());
 
       // iterate over all active surface points
       for (auto cellIt = cellIts[l]; !cellIt.isFinished(); cellIt.next()) {
@@ -730,7 +735,7 @@ public:
         if (sharpCorners && l > 0) {
           touchingMaterial = l - 1;
           viennahrle::ConstSparseIterator<hrleDomainType> prevIt(
-              levelSets[touchingMaterial]->getDomain());
+              std::as_const(*levelSets[touchingMaterial]).getDomain());
           for (int i = 0; i < (1 << D); ++i) {
             hrleIndex cornerIdx =
                 cellIt.getIndices() + viennahrle::BitMaskToIndex<D>(i);
@@ -5,6 +5,7 @@
 #include <map>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 
 #include <hrleSparseCellIterator.hpp>
 #include <hrleSparseStarIterator.hpp>
@@ -66,7 +67,7 @@ protected:
   std::vector<T> currentMaterials;
   T currentMaterialId = 0;
   SmartPointer<lsDomainType> currentLevelSet = nullptr;
-  typename PointData<T>::VectorDataType *normalVectorData = nullptr;
+  const typename PointData<T>::VectorDataType *normalVectorData = nullptr;
 
   // Store sharp corner nodes created during this cell iteration
   std::vector<std::pair<unsigned, Vec3D<T>>> matSharpCornerNodes;
@@ -129,7 +130,7 @@ public:
       }
     }
 
-    ConstSparseIterator valueIt(currentLevelSet->getDomain());
+    ConstSparseIterator valueIt(std::as_const(*currentLevelSet).getDomain());
 
     typedef std::map<hrleIndex, unsigned> nodeContainerType;
 
@@ -154,12 +155,15 @@ public:
           NormalCalculationMethodEnum::ONE_SIDED_MIN_MOD);
       normalCalculator.setMaxValue(std::numeric_limits<T>::max());
       normalCalculator.apply();
-      normalVectorData = currentLevelSet->getPointData().getVectorData(
-          CalculateNormalVectors<T, D>::normalVectorsLabel);
+      normalVectorData =
+          std::as_const(*currentLevelSet)
+              .getPointData()
+              .getVectorData(CalculateNormalVectors<T, D>::normalVectorsLabel);
     }
 
     // iterate over all cells with active points
-    for (ConstSparseCellIterator cellIt(currentLevelSet->getDomain());
+    for (ConstSparseCellIterator cellIt(
+             std::as_const(*currentLevelSet).getDomain());
          !cellIt.isFinished(); cellIt.next()) {
 
       // Clear node caches for dimensions that have moved out of scope
@@ -320,7 +324,7 @@ public:
     // now copy old data into new level set
     if (updatePointData && !newDataSourceIds[0].empty()) {
       mesh->getPointData().translateFromMultiData(
-          currentLevelSet->getPointData(), newDataSourceIds);
+          std::as_const(*currentLevelSet).getPointData(), newDataSourceIds);
     }
   }
 
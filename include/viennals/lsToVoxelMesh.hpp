@@ -1,6 +1,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <utility>
 
 #include <lsPreCompileMacros.hpp>
 
@@ -33,7 +34,7 @@ template <class T, int D> class ToVoxelMesh {
     }
     for (unsigned l = 0; l < levelSets.size(); ++l) {
       auto &grid = levelSets[l]->getGrid();
-      auto &domain = levelSets[l]->getDomain();
+      const auto &domain = std::as_const(*levelSets[l]).getDomain();
       for (unsigned i = 0; i < D; ++i) {
         minIndex[i] = std::min(minIndex[i], (grid.isNegBoundaryInfinite(i))
                                                 ? domain.getMinRunBreak(i)
@@ -120,7 +121,7 @@ public:
         viennahrle::ConstDenseCellIterator<typename Domain<T, D>::DomainType>>
         iterators;
     for (auto it = levelSets.begin(); it != levelSets.end(); ++it) {
-      iterators.emplace_back((*it)->getDomain(), minIndex);
+      iterators.emplace_back(std::as_const(**it).getDomain(), minIndex);
     }
 
     // move iterator for lowest material id and then adjust others if they are
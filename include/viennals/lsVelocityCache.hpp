@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <hrleSparseIterator.hpp>
+
+#include <lsDomain.hpp>
+#include <lsVelocityField.hpp>
+
+#include <vcVectorType.hpp>
+
+namespace lsInternal {
+
+using namespace viennacore;
+
+/// Velocities of the points of a level set for one advection step, indexed
+/// by the point id. Spatial discretization schemes look up velocities in this
+/// cache first and only query the velocity field if a point is not stored
+/// for the requested material.
+template <class T> class VelocityCache {
+  std::vector<int> materials;
+  std::vector<T> scalarVelocities;
+  std::vector<Vec3D<T>> vectorVelocities;
+
+public:
+  VelocityCache() = default;
+
+  /// Remove all stored velocities and prepare the cache to hold
+  /// numberOfPoints points.
+  void reset(std::size_t numberOfPoints) {
+    materials.assign(numberOfPoints, -1);
+    scalarVelocities.resize(numberOfPoints);
+    vectorVelocities.resize(numberOfPoints);
+  }
+
+  void clear() {
+    materials.clear();
+    scalarVelocities.clear();
+    vectorVelocities.clear();
+  }
+
+  bool empty() const { return materials.empty(); }
+
+  /// Material the velocities of the point were stored for, or -1.
+  int getMaterial(std::size_t pointId) const {
+    return (pointId < materials.size()) ? materials[pointId] : -1;
+  }
+
+  std::size_t size() const { return materials.size(); }
+
+  /// Store the velocities of a point. Different points can be inserted
+  /// concurrently.
+  void insert(std::size_t pointId, int material, T scalarVelocity,
+              const Vec3D<T> &vectorVelocity) {
+    materials[pointId] = material;
+    scalarVelocities[pointId] = scalarVelocity;
+    vectorVelocities[pointId] = vectorVelocity;
+  }
+
+  /// Returns true and writes the velocities of the point if they were stored
+  /// for the given material.
+  bool find(std::size_t pointId, int material, T &scalarVelocity,
+            Vec3D<T> &vectorVelocity) const {
+    if (pointId >= materials.size() || materials[pointId] != material)
+      return false;
+    scalarVelocity = scalarVelocities[pointId];
+    vectorVelocity = vectorVelocities[pointId];
+    return true;
+  }
+
+  /// Get the velocities of a point from cache, if it is not a nullptr and
+  /// contains the point, or from the velocity field otherwise.
+  template <class VelocityType>
+  static void getVelocities(const VelocityCache *cache,
+                            VelocityType &velocities,
+                            const Vec3D<T> &coordinate, int material,
+                            const Vec3D<T> &normalVector, unsigned long pointId,
+                            T &scalarVelocity, Vec3D<T> &vectorVelocity) {
+    if (cache != nullptr &&
+        cache->find(pointId, material, scalarVelocity, vectorVelocity))
+      return;
+
+    scalarVelocity = velocities.getScalarVelocity(coordinate, material,
+                                                  normalVector, pointId);
+    vectorVelocity = velocities.getVectorVelocity(coordinate, material,
+                                                  normalVector, pointId);
+  }
+};
+
+/// Velocities cached for the first stage of a time step, stored sorted by the
+/// grid indices of the points. The point ids change whenever the narrow band
+/// of the level set is expanded, reduced or rebuilt, so the velocities are
+/// restored into a VelocityCache for the current point ids by the later
+/// stages. Active points without stored velocities take the velocities of a
+/// neighbor, like rebuilding the narrow band takes the point data of new
+/// points from a neighbor.
+template <class T, int D> class StageVelocities {
+  struct Entry {
+    viennahrle::Index<D> indices;
+    int material;
+    T scalarVelocity;
+    Vec3D<T> vectorVelocity;
+  };
+
+  std::vector<Entry> entries;
+
+  const Entry *find(const viennahrle::Index<D> &indices) const {
+    auto it = std::lower_bound(
+        entries.begin(), entries.end(), indices,
+        [](const Entry &entry, const viennahrle::Index<D> &searched) {
+          return entry.indices < searched;
+        });
+    return (it != entries.end() && it->indices == indices) ? &(*it) : nullptr;
+  }
+
+  /// Calls function with the iterator range of the segment of the thread.
+  template <class Function>
+  static void forEachSegment(const viennals::Domain<T, D> &levelSet,
+                             Function function) {
+    const auto &domain = levelSet.getDomain();
+    const auto &grid = levelSet.getGrid();
+
+#pragma omp parallel num_threads(domain.getNumberOfSegments())
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+      viennahrle::Index<D> startVector =
+          (p == 0) ? grid.getMinGridPoint() : domain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> endVector =
+          (p != static_cast<int>(domain.getNumberOfSegments() - 1))
+              ? domain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      function(p, startVector, endVector);
+    }
+  }
+
+public:
+  StageVelocities() = default;
+
+  /// Stores the velocities of all points of levelSet in cache.
+  void store(const VelocityCache<T> &cache,
+             const viennals::Domain<T, D> &levelSet) {
+    using ConstSparseIterator = viennahrle::ConstSparseIterator<
+        typename viennals::Domain<T, D>::DomainType>;
+
+    std::vector<std::vector<Entry>> segmentEntries(
+        levelSet.getNumberOfSegments());
+    forEachSegment(levelSet, [&](int p, const viennahrle::Index<D> &start,
+                                 const viennahrle::Index<D> &end) {
+      for (ConstSparseIterator it(levelSet.getDomain(), start);
+           it.getStartIndices() < end; it.next()) {
+        if (!it.isDefined())
+          continue;
+        Entry entry;
+        entry.indices = it.getStartIndices();
+        entry.material = cache.getMaterial(it.getPointId());
+        if (entry.material >= 0 &&
+            cache.find(it.getPointId(), entry.material, entry.scalarVelocity,
+                       entry.vectorVelocity))
+          segmentEntries[p].push_back(entry);
+      }
+    });
+
+    entries.clear();
+    for (auto &segment : segmentEntries)
+      entries.insert(entries.end(), segment.begin(), segment.end());
+  }
+
+  /// Fills cache with the stored velocities of all points of levelSet whose
+  /// absolute value is at most cutoff.
+  void restore(VelocityCache<T> &cache, const viennals::Domain<T, D> &levelSet,
+               double cutoff) const {
+    using ConstSparseIterator = viennahrle::ConstSparseIterator<
+        typename viennals::Domain<T, D>::DomainType>;
+
+    cache.reset(levelSet.getNumberOfPoints());
+    forEachSegment(levelSet, [&](int, const viennahrle::Index<D> &start,
+                                 const viennahrle::Index<D> &end) {
+      for (ConstSparseIterator it(levelSet.getDomain(), start);
+           it.getStartIndices() < end; it.next()) {
+        if (!it.isDefined() || std::abs(it.getValue()) > cutoff)
+          continue;
+
+        const auto &indices = it.getStartIndices();
+        const Entry *entry = find(indices);
+        for (int i = 0; entry == nullptr && i < 2 * D; ++i) {
+          auto neighbor = indices;
+          neighbor[i % D] += (i < D) ? 1 : -1;
+          entry = find(neighbor);
+        }
+        if (entry != nullptr)
+          cache.insert(it.getPointId(), entry->material, entry->scalarVelocity,
+                       entry->vectorVelocity);
+      }
+    });
+  }
+
+  void clear() { entries = std::vector<Entry>(); }
+
+  bool empty() const { return entries.empty(); }
+
+  std::size_t size() const { return entries.size(); }
+};
+
+} // namespace lsInternal
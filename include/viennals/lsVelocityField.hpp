@@ -1,11 +1,65 @@
 #pragma once
 
+#include <future>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <vcSmartPointer.hpp>
 #include <vcVectorType.hpp>
 
 namespace viennals {
 
 using namespace viennacore;
 
+// Forward declaration
+template <class T, int D> class Domain;
+
+/// Points passed to VelocityField::getVelocities as a structure of arrays.
+/// The input arrays coordinates, materials, normalVectors and pointIds all
+/// have the same length. The output arrays scalarVelocities and
+/// vectorVelocities are resized to this length before the batch is passed
+/// to the velocity field.
+template <class T> struct VelocityBatch {
+  std::vector<Vec3D<T>> coordinates;
+  std::vector<int> materials;
+  std::vector<Vec3D<T>> normalVectors;
+  std::vector<unsigned long> pointIds;
+
+  std::vector<T> scalarVelocities;
+  std::vector<Vec3D<T>> vectorVelocities;
+
+  std::size_t size() const { return coordinates.size(); }
+
+  bool empty() const { return coordinates.empty(); }
+
+  void reserve(std::size_t numberOfPoints) {
+    coordinates.reserve(numberOfPoints);
+    materials.reserve(numberOfPoints);
+    normalVectors.reserve(numberOfPoints);
+    pointIds.reserve(numberOfPoints);
+    scalarVelocities.reserve(numberOfPoints);
+    vectorVelocities.reserve(numberOfPoints);
+  }
+
+  void push_back(const Vec3D<T> &coordinate, int material,
+                 const Vec3D<T> &normalVector, unsigned long pointId) {
+    coordinates.push_back(coordinate);
+    materials.push_back(material);
+    normalVectors.push_back(normalVector);
+    pointIds.push_back(pointId);
+  }
+
+  void clear() {
+    coordinates.clear();
+    materials.clear();
+    normalVectors.clear();
+    pointIds.clear();
+    scalarVelocities.clear();
+    vectorVelocities.clear();
+  }
+};
+
 /// Abstract class defining the interface for
 /// the velocity field used during advection using lsAdvect.
 template <class T> class VelocityField {
@@ -14,6 +68,12 @@ public:
 
   /// Should return a scalar value for the velocity at coordinate
   /// for a point of material with the given normalVector.
+  /// pointId is the id of the active point of the top level set whose rate
+  /// is being calculated. When the local Lax Friedrichs schemes query the
+  /// velocities of the other points in its stencil, pointId is still the id
+  /// of the stencil center, unless Advect::setCacheDissipation is enabled:
+  /// then it is the id of the stencil point at coordinate, if that point is
+  /// defined, and the id of the stencil center otherwise.
   virtual T getScalarVelocity(const Vec3D<T> & /*coordinate*/, int /*material*/,
                               const Vec3D<T> & /*normalVector*/,
                               unsigned long /*pointId*/) {
@@ -29,6 +89,22 @@ public:
     return Vec3D<T>{0, 0, 0};
   }
 
+  /// Batched version of getScalarVelocity and getVectorVelocity, which
+  /// should fill the scalar and vector velocities of all points in the batch
+  /// and return true. Velocity fields which can evaluate many points at once
+  /// more efficiently should override this function. If it is not
+  /// overridden, false is returned and the velocities are requested point by
+  /// point instead. This function may be called with an empty batch.
+  virtual bool getVelocities(VelocityBatch<T> & /*batch*/) { return false; }
+
+  /// Should return true if no point of material ever moves, i.e. the scalar
+  /// and vector velocities are zero for all points of this material, such as
+  /// for a mask. Advect then skips the points at which this material is
+  /// exposed without querying the velocity field or evaluating the spatial
+  /// discretization scheme. This is only a hint, returning false is always
+  /// correct.
+  virtual bool isStaticMaterial(int /*material*/) { return false; }
+
   /// If lsLocalLaxFriedrichsAnalytical is used as the spatial discretization
   /// scheme, this is called to provide the analytical solution for the alpha
   /// values, needed for numerical stability.
@@ -37,7 +113,80 @@ public:
     return 0;
   }
 
+  /// Called by Advect before the rates of each time step or Runge-Kutta
+  /// stage are computed, with all level sets advected by Advect, the top
+  /// level set being the last one. The top level set is already expanded by
+  /// the spatial discretization scheme, so its point ids are the ones passed
+  /// to the velocity getters, and the velocities of all points can be
+  /// calculated at once. stage is the Runge-Kutta stage, 0 for forward
+  /// Euler, and time is the time of the stage since the start of
+  /// Advect::apply(). The level sets must not be changed. This is called
+  /// for two dimensional level sets, prepare3D for three dimensional ones.
+  /// The two have different names, so overriding one does not hide the
+  /// other.
+  virtual void
+  prepare2D(const std::vector<SmartPointer<Domain<T, 2>>> & /*levelSets*/,
+            unsigned /*stage*/, double /*time*/) {}
+
+  /// Three dimensional version of prepare2D.
+  virtual void
+  prepare3D(const std::vector<SmartPointer<Domain<T, 3>>> & /*levelSets*/,
+            unsigned /*stage*/, double /*time*/) {}
+
+  /// Called by Advect after the rates of a time step or Runge-Kutta stage
+  /// were computed, so no more velocities are requested until prepare2D or
+  /// prepare3D is called again and the data calculated by them can be
+  /// released.
+  virtual void finalize() {}
+
+  /// Called by Advect if the velocities are prepared asynchronously, see
+  /// Advect::setAsyncVelocityPreparation. The passed level set is a copy of
+  /// the top level set, whose velocities will be requested next. It is
+  /// already expanded by the spatial discretization scheme, so its point
+  /// ids are the ones passed to the velocity getters, and it may be changed
+  /// freely. Advect waits for the returned future to become ready before
+  /// it requests the velocities, e.g. it can be returned by std::async
+  /// running the expensive part of the velocity calculation. Advect
+  /// finishes the previous time step in the meantime. An invalid future
+  /// is returned if nothing has to be prepared. This is called for two
+  /// dimensional level sets, prepareAsync3D for three dimensional ones.
+  virtual std::future<void>
+  prepareAsync2D(SmartPointer<Domain<T, 2>> /*levelSet*/) {
+    return {};
+  }
+
+  /// Three dimensional version of prepareAsync2D.
+  virtual std::future<void>
+  prepareAsync3D(SmartPointer<Domain<T, 3>> /*levelSet*/) {
+    return {};
+  }
+
   virtual ~VelocityField() = default;
 };
 
+/// Velocity field with the scalar velocity given by a callable object,
+/// which is called as function(coordinate, material, normalVector, pointId).
+/// The class is final, so if it is passed as the velocity type of Advect,
+/// e.g. Advect<T, D, FunctionVelocityField<T, Function>>, the function is
+/// called directly and can be inlined into the spatial discretization.
+template <class T, class Function>
+class FunctionVelocityField final : public VelocityField<T> {
+  static_assert(std::is_invocable_r_v<T, Function &, const Vec3D<T> &, int,
+                                      const Vec3D<T> &, unsigned long>,
+                "FunctionVelocityField: Function must be callable as "
+                "T(coordinate, material, normalVector, pointId).");
+
+  Function function;
+
+public:
+  explicit FunctionVelocityField(Function passedFunction)
+      : function(std::move(passedFunction)) {}
+
+  T getScalarVelocity(const Vec3D<T> &coordinate, int material,
+                      const Vec3D<T> &normalVector,
+                      unsigned long pointId) override {
+    return function(coordinate, material, normalVector, pointId);
+  }
+};
+
 } // namespace viennals
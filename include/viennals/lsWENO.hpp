@@ -4,6 +4,8 @@
 #include <hrleSparseStarIterator.hpp>
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
+#include <lsStencilBatch.hpp>
+#include <lsVelocityCache.hpp>
 #include <lsVelocityField.hpp>
 #include <vcVectorType.hpp>
 
@@ -17,17 +19,21 @@ using namespace viennacore;
 /// Weighted Essentially Non-Oscillatory (WENO) scheme.
 /// This kernel acts as the grid-interface for the mathematical logic
 /// defined in lsFiniteDifferences.hpp.
-template <class T, int D, int order> class WENO {
+template <class T, int D, int order,
+          class VelocityType = viennals::VelocityField<T>>
+class WENO {
   static_assert(order == 3 || order == 5, "WENO order must be 3 or 5.");
 
   SmartPointer<viennals::Domain<T, D>> levelSet;
-  SmartPointer<viennals::VelocityField<T>> velocities;
+  SmartPointer<VelocityType> velocities;
+  const VelocityCache<T> *velocityCache = nullptr;
 
   static constexpr int stencilRadius = (order + 1) / 2;
 
   // Iterator depth: WENO needs stencilRadius neighbors on each side.
   viennahrle::ConstSparseStarIterator<viennahrle::Domain<T, D>, stencilRadius>
       neighborIterator;
+  StencilBatch<T, D, stencilRadius> stencils;
 
   const bool calculateNormalVectors = true;
 
@@ -45,11 +51,18 @@ public:
   }
 
   WENO(SmartPointer<viennals::Domain<T, D>> passedlsDomain,
-       SmartPointer<viennals::VelocityField<T>> vel, bool calcNormal = true)
+       SmartPointer<VelocityType> vel, bool calcNormal = true)
       : levelSet(passedlsDomain), velocities(vel),
-        neighborIterator(levelSet->getDomain()),
+        neighborIterator(std::as_const(*levelSet).getDomain()),
+        stencils(std::as_const(*levelSet).getDomain()),
         calculateNormalVectors(calcNormal) {}
 
+  /// Use the velocities stored in cache for the center point instead of
+  /// querying the velocity field, where available.
+  void setVelocityCache(const VelocityCache<T> *cache) {
+    velocityCache = cache;
+  }
+
   std::pair<T, T> operator()(const viennahrle::Index<D> &indices,
                              int material) {
     auto &grid = levelSet->getGrid();
@@ -129,12 +142,12 @@ public:
     }
 
     // --- Retrieve Velocity ---
-    double scalarVelocity = velocities->getScalarVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
-    Vec3D<T> vectorVelocity = velocities->getVectorVelocity(
-        coordinate, material, normalVector,
-        neighborIterator.getCenter().getPointId());
+    T scalarVelocity;
+    Vec3D<T> vectorVelocity;
+    VelocityCache<T>::getVelocities(velocityCache, *velocities, coordinate,
+                                    material, normalVector,
+                                    neighborIterator.getCenter().getPointId(),
+                                    scalarVelocity, vectorVelocity);
 
     // --- Apply Velocities ---
 
@@ -160,6 +173,109 @@ public:
     return {vel_grad, 0.};
   }
 
+  /// Evaluates the scheme for count <= stencilBatchSize grid points at once
+  /// and writes their rates to rates. The stencils of all points are
+  /// gathered first, so the WENO derivatives can be calculated with SIMD
+  /// instructions. The arithmetic is the same as in operator(). The indices
+  /// must increase, also between successive calls.
+  void evaluateBatch(const viennahrle::Index<D> *indices, const int *materials,
+                     unsigned count, std::pair<T, T> *rates) {
+    constexpr unsigned size = StencilBatch<T, D, stencilRadius>::size;
+    constexpr int width = StencilBatch<T, D, stencilRadius>::width;
+    assert(count <= size);
+
+    const double gridDelta = levelSet->getGrid().getGridDelta();
+
+    stencils.clear();
+    for (unsigned p = 0; p < count; ++p)
+      stencils.gather(indices[p]);
+
+    alignas(64) T wenoGradMinus[D][size];
+    alignas(64) T wenoGradPlus[D][size];
+    alignas(64) T normals[D][size];
+    alignas(64) T gradPosTotal[size] = {};
+    alignas(64) T gradNegTotal[size] = {};
+
+    for (int i = 0; i < D; ++i) {
+      const auto &phi = stencils.values[i];
+#pragma omp simd
+      for (unsigned p = 0; p < count; ++p) {
+        T stencil[width];
+        for (int k = 0; k < width; ++k)
+          stencil[k] = phi[k][p];
+
+        const T gradMinus = MathScheme::differenceNegative(stencil, gridDelta);
+        const T gradPlus = MathScheme::differencePositive(stencil, gridDelta);
+        wenoGradMinus[i][p] = gradMinus;
+        wenoGradPlus[i][p] = gradPlus;
+
+        gradPosTotal[p] +=
+            pow2(std::max(gradMinus, T(0))) + pow2(std::min(gradPlus, T(0)));
+        gradNegTotal[p] +=
+            pow2(std::min(gradMinus, T(0))) + pow2(std::max(gradPlus, T(0)));
+
+        normals[i][p] = phi[stencilRadius + 1][p] - phi[stencilRadius - 1][p];
+      }
+    }
+
+    if (calculateNormalVectors) {
+#pragma omp simd
+      for (unsigned p = 0; p < count; ++p) {
+        T denominator = 0;
+        for (int i = 0; i < D; ++i)
+          denominator += normals[i][p] * normals[i][p];
+        if (denominator > 0) {
+          denominator = 1. / std::sqrt(denominator);
+          for (int i = 0; i < D; ++i)
+            normals[i][p] *= denominator;
+        }
+      }
+    }
+
+    // the velocity field is queried point by point
+    alignas(64) T scalarVelocities[size];
+    alignas(64) T vectorVelocities[D][size];
+    for (unsigned p = 0; p < count; ++p) {
+      VectorType<T, 3> coordinate{0., 0., 0.};
+      Vec3D<T> normalVector{};
+      for (unsigned i = 0; i < D; ++i) {
+        coordinate[i] = indices[p][i] * gridDelta;
+        if (calculateNormalVectors)
+          normalVector[i] = normals[i][p];
+      }
+
+      Vec3D<T> vectorVelocity;
+      VelocityCache<T>::getVelocities(
+          velocityCache, *velocities, coordinate, materials[p], normalVector,
+          stencils.pointIds[p], scalarVelocities[p], vectorVelocity);
+      for (int w = 0; w < D; ++w)
+        vectorVelocities[w][p] = vectorVelocity[w];
+    }
+
+    alignas(64) T velGrad[size];
+#pragma omp simd
+    for (unsigned p = 0; p < count; ++p) {
+      T vel_grad = 0.;
+      if (scalarVelocities[p] > 0) {
+        vel_grad += std::sqrt(gradPosTotal[p]) * scalarVelocities[p];
+      } else {
+        vel_grad += std::sqrt(gradNegTotal[p]) * scalarVelocities[p];
+      }
+
+      for (int w = 0; w < D; ++w) {
+        if (vectorVelocities[w][p] > 0.) {
+          vel_grad += vectorVelocities[w][p] * wenoGradMinus[w][p];
+        } else {
+          vel_grad += vectorVelocities[w][p] * wenoGradPlus[w][p];
+        }
+      }
+      velGrad[p] = vel_grad;
+    }
+
+    for (unsigned p = 0; p < count; ++p)
+      rates[p] = {velGrad[p], 0.};
+  }
+
   void reduceTimeStepHamiltonJacobi(double &MaxTimeStep,
                                     double gridDelta) const {}
   //   // --- STABILITY IMPROVEMENT ---
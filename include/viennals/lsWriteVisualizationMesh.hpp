@@ -239,7 +239,7 @@ template <class T, int D> class WriteVisualizationMesh {
                      int infiniteMaximum = -std::numeric_limits<int>::max()) {
 
     auto &grid = levelSet->getGrid();
-    auto &domain = levelSet->getDomain();
+    const auto &domain = std::as_const(*levelSet).getDomain();
     double gridDelta = grid.getGridDelta();
     int numLayers = levelSet->getLevelSetWidth();
 
@@ -309,7 +309,7 @@ template <class T, int D> class WriteVisualizationMesh {
     {
       // use dense iterator to got to every index location
       viennahrle::ConstDenseIterator<typename Domain<T, D>::DomainType> it(
-          levelSet->getDomain());
+          std::as_const(*levelSet).getDomain());
 
 #pragma omp for
       for (vtkIdType pointId = 0; pointId < numGridPoints; ++pointId) {
@@ -522,7 +522,7 @@ public:
         continue;
       }
       auto &grid = it->getGrid();
-      auto &domain = it->getDomain();
+      const auto &domain = std::as_const(*it).getDomain();
       for (unsigned i = 0; i < D; ++i) {
         if (grid.getBoundaryConditions(i) ==
             Domain<T, D>::BoundaryType::INFINITE_BOUNDARY) {
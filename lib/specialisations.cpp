@@ -15,6 +15,7 @@
 #include <lsCompareSparseField.hpp>
 #include <lsCompareVolume.hpp>
 #include <lsDetectFeatures.hpp>
+#include <lsDistributedAdvect.hpp>
 #include <lsDomain.hpp>
 #include <lsExpand.hpp>
 #include <lsExtrude.hpp>
@@ -26,7 +27,9 @@
 #include <lsPrune.hpp>
 #include <lsReader.hpp>
 #include <lsReduce.hpp>
+#include <lsReinitialize.hpp>
 #include <lsSlice.hpp>
+#include <lsStencilSnapshot.hpp>
 #include <lsToDiskMesh.hpp>
 #include <lsToHullMesh.hpp>
 #include <lsToMesh.hpp>
@@ -58,6 +61,9 @@ PRECOMPILE_SPECIALIZE(Domain)
 PRECOMPILE_SPECIALIZE(Expand)
 PRECOMPILE_SPECIALIZE(GeometricAdvect)
 PRECOMPILE_SPECIALIZE(DetectFeatures)
+#ifdef VIENNALS_USE_MPI
+PRECOMPILE_SPECIALIZE(DistributedAdvect)
+#endif
 PRECOMPILE_SPECIALIZE(FromMesh)
 PRECOMPILE_SPECIALIZE(FromSurfaceMesh)
 PRECOMPILE_SPECIALIZE(FromVolumeMesh)
@@ -69,6 +75,8 @@ PRECOMPILE_SPECIALIZE(MakeGeometry)
 PRECOMPILE_SPECIALIZE(Prune)
 PRECOMPILE_SPECIALIZE(Reader)
 PRECOMPILE_SPECIALIZE(Reduce)
+PRECOMPILE_SPECIALIZE(Reinitialize)
+PRECOMPILE_SPECIALIZE(StencilSnapshot)
 PRECOMPILE_SPECIALIZE(ToDiskMesh)
 PRECOMPILE_SPECIALIZE(ToHullMesh)
 PRECOMPILE_SPECIALIZE(ToMesh)
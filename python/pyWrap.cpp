@@ -33,6 +33,30 @@ public:
     PYBIND11_OVERLOAD(vectorType, VelocityField<T>, getVectorVelocity,
                       coordinate, material, normalVector, pointId);
   }
+
+  bool getVelocities(VelocityBatch<T> &batch) override {
+    PYBIND11_OVERLOAD(bool, VelocityField<T>, getVelocities, batch);
+  }
+
+  bool isStaticMaterial(int material) override {
+    PYBIND11_OVERLOAD(bool, VelocityField<T>, isStaticMaterial, material);
+  }
+
+  void prepare2D(const std::vector<SmartPointer<Domain<T, 2>>> &levelSets,
+                 unsigned stage, double time) override {
+    PYBIND11_OVERLOAD(void, VelocityField<T>, prepare2D, levelSets, stage,
+                      time);
+  }
+
+  void prepare3D(const std::vector<SmartPointer<Domain<T, 3>>> &levelSets,
+                 unsigned stage, double time) override {
+    PYBIND11_OVERLOAD(void, VelocityField<T>, prepare3D, levelSets, stage,
+                      time);
+  }
+
+  void finalize() override {
+    PYBIND11_OVERLOAD(void, VelocityField<T>, finalize, );
+  }
 };
 
 // module specification
@@ -115,6 +139,8 @@ PYBIND11_MODULE(VIENNALS_MODULE_NAME, module) {
       .value("FORWARD_EULER", TemporalSchemeEnum::FORWARD_EULER)
       .value("RUNGE_KUTTA_2ND_ORDER", TemporalSchemeEnum::RUNGE_KUTTA_2ND_ORDER)
       .value("RUNGE_KUTTA_3RD_ORDER", TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER)
+      .value("RUNGE_KUTTA_3RD_ORDER_ADAPTIVE",
+             TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER_ADAPTIVE)
       .finalize();
 
   py::native_enum<BooleanOperationEnum>(module, "BooleanOperationEnum",
@@ -138,6 +164,12 @@ PYBIND11_MODULE(VIENNALS_MODULE_NAME, module) {
       .value("NORMALS_ANGLE", FeatureDetectionEnum::NORMALS_ANGLE)
       .finalize();
 
+  py::native_enum<StencilShapeEnum>(module, "StencilShapeEnum",
+                                    "enum.IntEnum")
+      .value("STAR", StencilShapeEnum::STAR)
+      .value("BOX", StencilShapeEnum::BOX)
+      .finalize();
+
   py::native_enum<NormalCalculationMethodEnum>(
       module, "NormalCalculationMethodEnum", "enum.IntEnum")
       .value("CENTRAL_DIFFERENCES",
@@ -374,6 +406,21 @@ PYBIND11_MODULE(VIENNALS_MODULE_NAME, module) {
       .def("getMaterialMap", &MaterialMap::getMaterialMap,
            "Get the material map.");
 
+  // VelocityBatch
+  py::class_<VelocityBatch<T>>(module, "VelocityBatch")
+      // constructors
+      .def(py::init<>())
+      // members
+      .def_readwrite("coordinates", &VelocityBatch<T>::coordinates)
+      .def_readwrite("materials", &VelocityBatch<T>::materials)
+      .def_readwrite("normalVectors", &VelocityBatch<T>::normalVectors)
+      .def_readwrite("pointIds", &VelocityBatch<T>::pointIds)
+      .def_readwrite("scalarVelocities", &VelocityBatch<T>::scalarVelocities)
+      .def_readwrite("vectorVelocities", &VelocityBatch<T>::vectorVelocities)
+      // methods
+      .def("size", &VelocityBatch<T>::size,
+           "Return the number of points in the batch.");
+
   // VelocityField
   py::class_<VelocityField<T>, SmartPointer<VelocityField<T>>,
              PylsVelocityField>(module, "VelocityField")
@@ -386,6 +433,23 @@ PYBIND11_MODULE(VIENNALS_MODULE_NAME, module) {
       .def("getVectorVelocity", &VelocityField<T>::getVectorVelocity,
            "Return the vector velocity for a point of material at coordinate "
            "with normal vector normal.")
+      .def("getVelocities", &VelocityField<T>::getVelocities,
+           "Fill the scalar and vector velocities of all points in the batch "
+           "and return True. Returns False if batches are not supported.")
+      .def("isStaticMaterial", &VelocityField<T>::isStaticMaterial,
+           "Return True if no point of the material ever moves, so it can be "
+           "skipped during advection.")
+      .def("prepare2D", &VelocityField<T>::prepare2D, py::arg("levelSets"),
+           py::arg("stage"), py::arg("time"),
+           "Called before the velocities of each time step or Runge-Kutta "
+           "stage are requested, with all advected 2D level sets.")
+      .def("prepare3D", &VelocityField<T>::prepare3D, py::arg("levelSets"),
+           py::arg("stage"), py::arg("time"),
+           "Called before the velocities of each time step or Runge-Kutta "
+           "stage are requested, with all advected 3D level sets.")
+      .def("finalize", &VelocityField<T>::finalize,
+           "Called after the velocities of each time step or Runge-Kutta "
+           "stage were requested.")
       .def("getDissipationAlpha", &VelocityField<T>::getDissipationAlpha,
            "Return the analytical dissipation alpha value if the "
            "lsLocalLaxFriedrichsAnalytical scheme is used for advection.");
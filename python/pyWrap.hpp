@@ -37,8 +37,10 @@
 #include <lsPrune.hpp>
 #include <lsReader.hpp>
 #include <lsReduce.hpp>
+#include <lsReinitialize.hpp>
 #include <lsRemoveStrayPoints.hpp>
 #include <lsSlice.hpp>
+#include <lsStencilSnapshot.hpp>
 #include <lsToDiskMesh.hpp>
 #include <lsToHullMesh.hpp>
 #include <lsToMesh.hpp>
@@ -290,6 +292,9 @@ template <int D> void bindApi(py::module &module) {
       // methods
       .def("deepCopy", &Domain<T, D>::deepCopy,
            "Copy lsDomain in this lsDomain.")
+      .def("deepCopyOnWrite", &Domain<T, D>::deepCopyOnWrite,
+           "Make this lsDomain a copy of the passed lsDomain, which shares "
+           "its values until one of them is modified.")
       .def("getNumberOfSegments", &Domain<T, D>::getNumberOfSegments,
            "Get the number of segments, the level set structure is divided "
            "into.")
@@ -303,6 +308,9 @@ template <int D> void bindApi(py::module &module) {
            "stored around the explicit surface.")
       .def("clearMetaData", &Domain<T, D>::clearMetaData,
            "Clear all metadata stored in the level set.")
+      .def("getVersion", &Domain<T, D>::getVersion,
+           "Get the version of the level set values, which changes whenever "
+           "they are modified.")
       // allow filehandle to be passed and default to python standard output
       .def(
           "print",
@@ -351,15 +359,56 @@ template <int D> void bindApi(py::module &module) {
       .def("setIgnoreVoids", &Advect<T, D>::setIgnoreVoids,
            "Set whether voids in the geometry should be ignored during "
            "advection or not.")
+      .def("setIncrementalVoidDetection",
+           &Advect<T, D>::setIncrementalVoidDetection,
+           "Set whether void points should only be marked again where the "
+           "sign of the level set changed since the last time step.")
       .def("setAdaptiveTimeStepping", &Advect<T, D>::setAdaptiveTimeStepping,
            py::arg("enabled") = true, py::arg("subdivisions") = 20,
            "Enable/disable adaptive time stepping and set the number of "
            "subdivisions.")
+      .def("setMultirateTimeStepping",
+           &Advect<T, D>::setMultirateTimeStepping, py::arg("enabled") = true,
+           py::arg("subcycles") = 4,
+           "Enable/disable reusing the rates of slowly moving points for "
+           "several time steps and set the largest number of time steps.")
       .def(
           "setSaveAdvectionVelocities",
           &Advect<T, D>::setSaveAdvectionVelocities,
           "Set whether the velocities applied to each point should be saved in "
           "the level set for debug purposes.")
+      .def("setFusedRateUpdate", &Advect<T, D>::setFusedRateUpdate,
+           py::arg("fused"),
+           "Set whether rates should be applied directly after they are "
+           "calculated, instead of storing them for all points first.")
+      .def("setBatchedSchemeEvaluation",
+           &Advect<T, D>::setBatchedSchemeEvaluation, py::arg("batched"),
+           "Set whether the Engquist Osher and WENO schemes should be "
+           "evaluated for batches of points using SIMD instructions.")
+      .def("setCacheDissipation", &Advect<T, D>::setCacheDissipation,
+           py::arg("cache"),
+           "Set whether local Lax Friedrichs schemes should share the "
+           "dissipation coefficients of stencil points between stencils.")
+      .def("setCacheVelocities", &Advect<T, D>::setCacheVelocities,
+           py::arg("cache"),
+           "Set whether the velocities of all active points should be "
+           "evaluated once per time step and cached for the spatial scheme.")
+      .def("setReuseStageVelocities", &Advect<T, D>::setReuseStageVelocities,
+           py::arg("reuse"),
+           "Set whether the Runge-Kutta schemes should evaluate the "
+           "velocities only in the first stage of each time step.")
+      .def("setWorkStealing", &Advect<T, D>::setWorkStealing, py::arg("ws"),
+           "Set whether active points should be split into small chunks "
+           "which are distributed between threads using work stealing.")
+      .def("setEuclideanReinitialization",
+           &Advect<T, D>::setEuclideanReinitialization, py::arg("euclidean"),
+           "Set whether the level set values should be replaced by Euclidean "
+           "distances after each rebuild.")
+      .def("setRestrictLayerAdjustment",
+           &Advect<T, D>::setRestrictLayerAdjustment,
+           py::arg("restrictAdjustment"),
+           "Set whether the lower level sets should only be adjusted where "
+           "the top level set moved during a time step.")
       .def("setCheckDissipation", &Advect<T, D>::setCheckDissipation,
            py::arg("check"), "Enable/disable dissipation checking.")
       .def("setUpdatePointData", &Advect<T, D>::setUpdatePointData,
@@ -370,6 +419,10 @@ template <int D> void bindApi(py::module &module) {
       .def("getNumberOfTimeSteps", &Advect<T, D>::getNumberOfTimeSteps,
            "Get how many advection steps were performed after the last apply() "
            "call.")
+      .def("getNumberOfRejectedTimeSteps",
+           &Advect<T, D>::getNumberOfRejectedTimeSteps,
+           "Get how many time steps were rejected by the error control during "
+           "the last apply() call.")
       .def("getTimeStepRatio", &Advect<T, D>::getTimeStepRatio,
            "Get the time step ratio used for advection.")
       .def("getCurrentTimeStep", &Advect<T, D>::getCurrentTimeStep,
@@ -381,6 +434,10 @@ template <int D> void bindApi(py::module &module) {
            "Set the spatial discretization scheme to use during advection.")
       .def("setTemporalScheme", &Advect<T, D>::setTemporalScheme,
            "Set the time integration scheme to use during advection.")
+      .def("setErrorTolerance", &Advect<T, D>::setErrorTolerance,
+           py::arg("tolerance"),
+           "Set the largest accepted local error of a time step, in grid "
+           "units, for the adaptive Runge-Kutta scheme.")
       .def("setIntegrationScheme", &Advect<T, D>::setIntegrationScheme,
            "(DEPRECATED, use setSpatialScheme instead) Set the spatial "
            "discretization scheme to use during advection.")
@@ -827,6 +884,9 @@ template <int D> void bindApi(py::module &module) {
            "curvature.")
       .def("setMaxValue", &CalculateCurvatures<T, D>::setMaxValue,
            "Curvatures will be calculated for all LS values < maxValue.")
+      .def("setStencilSnapshot", &CalculateCurvatures<T, D>::setStencilSnapshot,
+           "Read the neighbors from a stencil snapshot with box stencils of "
+           "radius 1.")
       .def("apply", &CalculateCurvatures<T, D>::apply,
            "Perform normal vector calculation.");
 
@@ -846,6 +906,10 @@ template <int D> void bindApi(py::module &module) {
            "Set the maximum value for which normals should be calculated.")
       .def("setMethod", &CalculateNormalVectors<T, D>::setMethod,
            "Set the method to use for normal calculation.")
+      .def("setStencilSnapshot",
+           &CalculateNormalVectors<T, D>::setStencilSnapshot,
+           "Read the neighbors from a stencil snapshot containing star "
+           "stencils of radius 1.")
       .def("apply", &CalculateNormalVectors<T, D>::apply,
            "Perform normal vector calculation.");
 
@@ -915,6 +979,9 @@ template <int D> void bindApi(py::module &module) {
            "feature.")
       .def("setDetectionMethod", &DetectFeatures<T, D>::setDetectionMethod,
            "Set which method to use to detect features. Defaults to Curvature.")
+      .def("setStencilSnapshot", &DetectFeatures<T, D>::setStencilSnapshot,
+           "Read the neighbors from a stencil snapshot with box stencils of "
+           "radius 1.")
       .def("apply", &DetectFeatures<T, D>::apply, "Detect features.");
 
   // GeometricAdvect
@@ -1178,6 +1245,9 @@ template <int D> void bindApi(py::module &module) {
       .def("setSaveComponentIds", &MarkVoidPoints<T, D>::setSaveComponentIds,
            "Save the connectivity information of all LS points in the "
            "pointData of the level set.")
+      .def("setIncremental", &MarkVoidPoints<T, D>::setIncremental,
+           "Set whether only the points whose sign changed since the last "
+           "call to apply() should be labelled again.")
       .def("getNumberOfComponents",
            &MarkVoidPoints<T, D>::getNumberOfComponents,
            "Get the number of connected components found in the level set.")
@@ -1226,6 +1296,22 @@ template <int D> void bindApi(py::module &module) {
            "cores) after reduction.")
       .def("apply", &Reduce<T, D>::apply, "Perform reduction.");
 
+  // Reinitialize
+  py::class_<Reinitialize<T, D>, SmartPointer<Reinitialize<T, D>>>(
+      module, "Reinitialize")
+      // constructors
+      .def(py::init(&SmartPointer<Reinitialize<T, D>>::template New<>))
+      .def(py::init(&SmartPointer<Reinitialize<T, D>>::template New<
+                    SmartPointer<Domain<T, D>> &>))
+      // methods
+      .def("setLevelSet", &Reinitialize<T, D>::setLevelSet,
+           "Set levelset to reinitialize.")
+      .def("setMaxIterations", &Reinitialize<T, D>::setMaxIterations,
+           "Set the number of iterations. 0 uses one iteration per layer.")
+      .def("apply", &Reinitialize<T, D>::apply,
+           "Replace the values outside the interface by Euclidean "
+           "distances.");
+
   // RemoveStrayPoints
   py::class_<RemoveStrayPoints<T, D>, SmartPointer<RemoveStrayPoints<T, D>>>(
       module, "RemoveStrayPoints")
@@ -1241,6 +1327,30 @@ template <int D> void bindApi(py::module &module) {
            "All other LS values will be marked as stray points and removed.")
       .def("apply", &RemoveStrayPoints<T, D>::apply, "Remove stray points.");
 
+  // StencilSnapshot
+  py::class_<StencilSnapshot<T, D>, SmartPointer<StencilSnapshot<T, D>>>(
+      module, "StencilSnapshot")
+      // constructors
+      .def(py::init(&SmartPointer<StencilSnapshot<T, D>>::template New<>))
+      .def(py::init(&SmartPointer<StencilSnapshot<T, D>>::template New<
+                    SmartPointer<Domain<T, D>> &>))
+      .def(py::init(&SmartPointer<StencilSnapshot<T, D>>::template New<
+                    SmartPointer<Domain<T, D>> &, StencilShapeEnum, int>))
+      // methods
+      .def("setLevelSet", &StencilSnapshot<T, D>::setLevelSet,
+           "Set levelset whose stencils should be collected.")
+      .def("setShape", &StencilSnapshot<T, D>::setShape,
+           "Set the shape of the stencils.")
+      .def("setRadius", &StencilSnapshot<T, D>::setRadius,
+           "Set the radius of the stencils.")
+      .def("isValid", &StencilSnapshot<T, D>::isValid,
+           "Whether the stencils are up to date with the levelset.")
+      .def("clear", &StencilSnapshot<T, D>::clear,
+           "Release the memory of the stencils.")
+      .def("apply", &StencilSnapshot<T, D>::apply,
+           "Collect the stencils if the levelset changed since the last "
+           "call.");
+
   // ToDiskMesh
   py::class_<ToDiskMesh<T, D>, SmartPointer<ToDiskMesh<T, D>>>(module,
                                                                "ToDiskMesh")
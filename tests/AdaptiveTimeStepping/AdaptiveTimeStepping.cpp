@@ -0,0 +1,120 @@
+#include <array>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsBooleanOperation.hpp>
+#include <lsCompareChamfer.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+#include <lsVelocityField.hpp>
+
+/**
+  Test of the Runge-Kutta 3rd order scheme with error control. With a very
+  loose tolerance, it must take the same time steps as the scheme without
+  error control. With a tight tolerance, more and smaller time steps are
+  taken and the result must still be close to the one without error control.
+*/
+
+namespace ls = viennals;
+
+// the top material grows, the mask below does not
+template <class T> class GrowthVelocity : public ls::VelocityField<T> {
+public:
+  T getScalarVelocity(const std::array<T, 3> & /*coordinate*/, int material,
+                      const std::array<T, 3> & /*normalVector*/,
+                      unsigned long /*pointId*/) override {
+    return (material == 1) ? 1. : 0.;
+  }
+};
+
+template <class T, int D>
+ls::SmartPointer<ls::Domain<T, D>>
+advect(ls::SmartPointer<ls::Domain<T, D>> mask,
+       ls::SmartPointer<ls::Domain<T, D>> substrate,
+       ls::TemporalSchemeEnum scheme, double tolerance,
+       unsigned &numberOfTimeSteps, unsigned &numberOfRejectedTimeSteps) {
+  auto maskCopy = ls::SmartPointer<ls::Domain<T, D>>::New(mask);
+  auto levelSet = ls::SmartPointer<ls::Domain<T, D>>::New(substrate);
+
+  ls::Advect<T, D> advectionKernel;
+  advectionKernel.insertNextLevelSet(maskCopy);
+  advectionKernel.insertNextLevelSet(levelSet);
+  advectionKernel.setVelocityField(ls::SmartPointer<GrowthVelocity<T>>::New());
+  advectionKernel.setSpatialScheme(
+      ls::SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER);
+  advectionKernel.setTemporalScheme(scheme);
+  advectionKernel.setErrorTolerance(tolerance);
+  advectionKernel.setAdvectionTime(1.);
+  advectionKernel.apply();
+
+  numberOfTimeSteps = advectionKernel.getNumberOfTimeSteps();
+  numberOfRejectedTimeSteps = advectionKernel.getNumberOfRejectedTimeSteps();
+  VC_TEST_ASSERT(std::abs(advectionKernel.getAdvectedTime() - 1.) < 1e-6);
+  LSTEST_ASSERT_VALID_LS(levelSet, T, D);
+  LSTEST_ASSERT_VALID_LS(maskCopy, T, D);
+
+  return levelSet;
+}
+
+int main() {
+  constexpr int D = 2;
+  using T = double;
+  omp_set_num_threads(4);
+
+  double gridDelta = 0.25;
+  double bounds[2 * D] = {-10., 10., -10., 10.};
+  ls::Domain<T, D>::BoundaryType boundaryCons[D];
+  for (int i = 0; i < D; ++i)
+    boundaryCons[i] = ls::Domain<T, D>::BoundaryType::REFLECTIVE_BOUNDARY;
+
+  auto substrate =
+      ls::SmartPointer<ls::Domain<T, D>>::New(bounds, boundaryCons, gridDelta);
+  T origin[D] = {0., 0.};
+  ls::MakeGeometry<T, D>(substrate, ls::Sphere<T, D>::New(origin, 3.)).apply();
+
+  auto mask =
+      ls::SmartPointer<ls::Domain<T, D>>::New(bounds, boundaryCons, gridDelta);
+  T maskOrigin[D] = {0., -2.};
+  ls::MakeGeometry<T, D>(mask, ls::Sphere<T, D>::New(maskOrigin, 2.)).apply();
+  ls::BooleanOperation<T, D>(substrate, mask, ls::BooleanOperationEnum::UNION)
+      .apply();
+
+  unsigned steps = 0, rejected = 0;
+  auto reference =
+      advect(mask, substrate, ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER,
+             0.01, steps, rejected);
+  VC_TEST_ASSERT(rejected == 0);
+  std::cout << "RK3: " << steps << " time steps" << std::endl;
+
+  // the error control never limits the time step
+  unsigned looseSteps = 0, looseRejected = 0;
+  auto loose = advect(mask, substrate,
+                      ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER_ADAPTIVE,
+                      1e6, looseSteps, looseRejected);
+  std::cout << "Adaptive RK3, loose tolerance: " << looseSteps
+            << " time steps, " << looseRejected << " rejected" << std::endl;
+  VC_TEST_ASSERT(looseRejected == 0);
+  VC_TEST_ASSERT(looseSteps == steps);
+
+  ls::CompareChamfer<T, D> compareLoose(reference, loose);
+  compareLoose.apply();
+  VC_TEST_ASSERT(compareLoose.getChamferDistance() < 1e-6);
+
+  // the error control limits the time step
+  unsigned tightSteps = 0, tightRejected = 0;
+  auto tight = advect(mask, substrate,
+                      ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER_ADAPTIVE,
+                      1e-5, tightSteps, tightRejected);
+  std::cout << "Adaptive RK3, tight tolerance: " << tightSteps
+            << " time steps, " << tightRejected << " rejected" << std::endl;
+  VC_TEST_ASSERT(tightSteps >= steps);
+
+  ls::CompareChamfer<T, D> compareTight(reference, tight);
+  compareTight.apply();
+  std::cout << "Chamfer distance: " << compareTight.getChamferDistance()
+            << std::endl;
+  VC_TEST_ASSERT(compareTight.getChamferDistance() < 0.1 * gridDelta);
+
+  return 0;
+}
@@ -0,0 +1,168 @@
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsBooleanOperation.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that velocities prepared asynchronously for the point ids of
+  the copy of the top level set passed to VelocityField::prepareAsync2D are
+  the ones requested by Advect, so advecting with them gives the same level
+  sets as advecting with velocities calculated point by point.
+*/
+
+namespace ls = viennals;
+
+constexpr int D = 2;
+using LevelSetType = ls::SmartPointer<ls::Domain<double, D>>;
+
+double velocityAt(double x) { return 1. + 0.1 * x; }
+
+// calculates the velocity of each point of the top level set when the
+// preparation is started and only looks them up afterwards
+class PreparedVelocity : public ls::VelocityField<double> {
+  std::vector<double> xCoordinates;
+  std::vector<double> preparedVelocities;
+
+public:
+  std::atomic<unsigned> numberOfPreparations{0};
+  std::atomic<unsigned> numberOfWrongPoints{0};
+
+  std::future<void> prepareAsync2D(LevelSetType levelSet) override {
+    ++numberOfPreparations;
+    return std::async(std::launch::async, [this, levelSet]() {
+      const auto gridDelta = levelSet->getGrid().getGridDelta();
+      xCoordinates.assign(levelSet->getNumberOfPoints(), 0.);
+      preparedVelocities.assign(levelSet->getNumberOfPoints(), 0.);
+      for (viennahrle::ConstSparseIterator<ls::Domain<double, D>::DomainType>
+               it(std::as_const(*levelSet).getDomain());
+           !it.isFinished(); it.next()) {
+        if (!it.isDefined())
+          continue;
+        const double x = it.getStartIndices()[0] * gridDelta;
+        xCoordinates[it.getPointId()] = x;
+        preparedVelocities[it.getPointId()] = velocityAt(x);
+      }
+    });
+  }
+
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int /*material*/,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long pointId) override {
+    if (pointId >= xCoordinates.size() ||
+        xCoordinates[pointId] != coordinate[0]) {
+      ++numberOfWrongPoints;
+      return velocityAt(coordinate[0]);
+    }
+    return preparedVelocities[pointId];
+  }
+};
+
+class DirectVelocity : public ls::VelocityField<double> {
+public:
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int /*material*/,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    return velocityAt(coordinate[0]);
+  }
+};
+
+// sphere on a substrate, so the lower level set is adjusted every time step
+std::vector<LevelSetType> makeGeometry() {
+  double bounds[2 * D] = {-8., 8., -4., 8.};
+  ls::BoundaryConditionEnum boundaryCons[D] = {
+      ls::BoundaryConditionEnum::REFLECTIVE_BOUNDARY,
+      ls::BoundaryConditionEnum::INFINITE_BOUNDARY};
+
+  auto substrate = LevelSetType::New(bounds, boundaryCons, 0.25);
+  double origin[D] = {0., 0.};
+  double normal[D] = {0., 1.};
+  ls::MakeGeometry<double, D>(substrate,
+                              ls::Plane<double, D>::New(origin, normal))
+      .apply();
+
+  auto top = LevelSetType::New(substrate);
+  auto sphere = LevelSetType::New(substrate->getGrid());
+  origin[1] = 1.;
+  ls::MakeGeometry<double, D>(sphere, ls::Sphere<double, D>::New(origin, 2.))
+      .apply();
+  ls::BooleanOperation<double, D>(top, sphere, ls::BooleanOperationEnum::UNION)
+      .apply();
+
+  return {substrate, top};
+}
+
+double maxDifference(LevelSetType levelSetA, LevelSetType levelSetB) {
+  using ConstSparseIterator =
+      viennahrle::ConstSparseIterator<ls::Domain<double, D>::DomainType>;
+
+  double difference = 0.;
+  ConstSparseIterator itB(levelSetB->getDomain());
+  for (ConstSparseIterator itA(levelSetA->getDomain()); !itA.isFinished();
+       itA.next()) {
+    if (!itA.isDefined() || std::abs(itA.getValue()) > 0.5)
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(itB.isDefined());
+    difference =
+        std::max(difference, std::abs(itA.getValue() - itB.getValue()));
+  }
+  return difference;
+}
+
+void runTest(ls::TemporalSchemeEnum temporalScheme) {
+  auto levelSets = makeGeometry();
+  auto referenceLevelSets = makeGeometry();
+
+  auto velocities = ls::SmartPointer<PreparedVelocity>::New();
+  ls::Advect<double, D> advection;
+  advection.setVelocityField(velocities);
+  advection.setTemporalScheme(temporalScheme);
+  advection.setAsyncVelocityPreparation(true);
+  advection.setAdvectionTime(0.5);
+
+  ls::Advect<double, D> referenceAdvection;
+  referenceAdvection.setVelocityField(ls::SmartPointer<DirectVelocity>::New());
+  referenceAdvection.setTemporalScheme(temporalScheme);
+  referenceAdvection.setAdvectionTime(0.5);
+
+  for (unsigned i = 0; i < 2; ++i) {
+    advection.insertNextLevelSet(levelSets[i]);
+    referenceAdvection.insertNextLevelSet(referenceLevelSets[i]);
+  }
+
+  // the preparation started after the last time step is used by the next
+  // call to apply()
+  for (unsigned i = 0; i < 3; ++i) {
+    advection.apply();
+    referenceAdvection.apply();
+  }
+
+  std::cout << "Temporal scheme " << static_cast<unsigned>(temporalScheme)
+            << ": " << velocities->numberOfPreparations
+            << " preparations for " << advection.getNumberOfTimeSteps()
+            << " time steps" << std::endl;
+  VC_TEST_ASSERT(velocities->numberOfPreparations > 0);
+  VC_TEST_ASSERT(velocities->numberOfWrongPoints == 0);
+
+  for (unsigned i = 0; i < 2; ++i) {
+    LSTEST_ASSERT_VALID_LS(levelSets[i], double, D);
+    VC_TEST_ASSERT(maxDifference(levelSets[i], referenceLevelSets[i]) == 0.);
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest(ls::TemporalSchemeEnum::FORWARD_EULER);
+  runTest(ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER);
+
+  return 0;
+}
@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsEngquistOsher.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+#include <lsWENO.hpp>
+
+/**
+  Test checking that the batched evaluation of the Engquist Osher and WENO
+  schemes gives the same rates as the point by point evaluation, for float
+  and double, and that advecting with batched evaluation gives the same
+  level set.
+*/
+
+namespace ls = viennals;
+
+// scalar and vector velocities depending on the position and normal
+template <class T> class MixedVelocity : public ls::VelocityField<T> {
+public:
+  T getScalarVelocity(const std::array<T, 3> &coordinate, int material,
+                      const std::array<T, 3> &normalVector,
+                      unsigned long /*pointId*/) override {
+    return (material == 0) ? T(-0.5) + coordinate[0] * T(0.1) + normalVector[1]
+                           : T(0.3);
+  }
+
+  std::array<T, 3> getVectorVelocity(const std::array<T, 3> &coordinate,
+                                     int /*material*/,
+                                     const std::array<T, 3> &normalVector,
+                                     unsigned long /*pointId*/) override {
+    return {normalVector[0] - T(0.2), coordinate[1] * T(0.05), T(0.1)};
+  }
+};
+
+template <class T, int D>
+ls::SmartPointer<ls::Domain<T, D>> makeSphere(double gridDelta) {
+  double bounds[2 * D];
+  typename ls::Domain<T, D>::BoundaryType boundaryCons[D];
+  for (int i = 0; i < D; ++i) {
+    bounds[2 * i] = -5.;
+    bounds[2 * i + 1] = 5.;
+    boundaryCons[i] = ls::Domain<T, D>::BoundaryType::REFLECTIVE_BOUNDARY;
+  }
+  auto sphere = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+  T origin[3] = {0.1, -0.2, 0.3};
+  ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 3.)).apply();
+  return sphere;
+}
+
+template <class T, int D, class SchemeType>
+void compareScheme(const char *name) {
+  using ConstSparseIterator =
+      viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType>;
+
+  auto levelSet = makeSphere<T, D>(0.37);
+  SchemeType::prepareLS(levelSet);
+  auto velocities = ls::SmartPointer<MixedVelocity<T>>::New();
+
+  SchemeType scalarScheme(levelSet, velocities);
+  SchemeType batchedScheme(levelSet, velocities);
+
+  std::vector<viennahrle::Index<D>> indices;
+  std::vector<int> materials;
+  for (ConstSparseIterator it(levelSet->getDomain()); !it.isFinished();
+       it.next()) {
+    if (it.isDefined() && std::abs(it.getValue()) <= 0.5) {
+      indices.push_back(it.getStartIndices());
+      materials.push_back(indices.size() % 2);
+    }
+  }
+  VC_TEST_ASSERT(indices.size() > lsInternal::stencilBatchSize);
+
+  // use partial batches as well
+  std::vector<std::pair<T, T>> batchedRates(indices.size());
+  for (std::size_t start = 0; start < indices.size();) {
+    const std::size_t batchSize =
+        (start % 3 == 0) ? lsInternal::stencilBatchSize : 5;
+    const unsigned count = std::min(indices.size() - start, batchSize);
+    batchedScheme.evaluateBatch(&indices[start], &materials[start], count,
+                                &batchedRates[start]);
+    start += count;
+  }
+
+  const T tolerance = 16 * std::numeric_limits<T>::epsilon();
+  T maxDifference = 0.;
+  for (std::size_t i = 0; i < indices.size(); ++i) {
+    const auto rate = scalarScheme(indices[i], materials[i]);
+    const T difference = std::abs(rate.first - batchedRates[i].first) /
+                         std::max(T(1), std::abs(rate.first));
+    maxDifference = std::max(maxDifference, difference);
+    VC_TEST_ASSERT(batchedRates[i].second == rate.second);
+  }
+
+  std::cout << name << " " << D << "D " << sizeof(T) * 8
+            << " bit: " << indices.size()
+            << " points, largest relative difference " << maxDifference
+            << std::endl;
+  VC_TEST_ASSERT(maxDifference <= tolerance);
+}
+
+template <class T, int D> void compareSchemes() {
+  using VelocityType = ls::VelocityField<T>;
+  compareScheme<T, D, lsInternal::EngquistOsher<T, D, 1, VelocityType>>(
+      "EO1");
+  compareScheme<T, D, lsInternal::EngquistOsher<T, D, 2, VelocityType>>(
+      "EO2");
+  compareScheme<T, D, lsInternal::WENO<T, D, 3, VelocityType>>("WENO3");
+  compareScheme<T, D, lsInternal::WENO<T, D, 5, VelocityType>>("WENO5");
+}
+
+template <int D> void compareAdvection(ls::SpatialSchemeEnum spatialScheme) {
+  using T = double;
+  using ConstSparseIterator =
+      viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType>;
+
+  auto sphere = makeSphere<T, D>(0.25);
+  auto batchedSphere = makeSphere<T, D>(0.25);
+  auto velocities = ls::SmartPointer<MixedVelocity<T>>::New();
+
+  for (auto &levelSet : {sphere, batchedSphere}) {
+    ls::Advect<T, D> advection(levelSet, velocities);
+    advection.setSpatialScheme(spatialScheme);
+    advection.setBatchedSchemeEvaluation(levelSet == batchedSphere);
+    advection.setAdvectionTime(1.);
+    advection.apply();
+  }
+
+  LSTEST_ASSERT_VALID_LS(batchedSphere, T, D);
+  VC_TEST_ASSERT(sphere->getNumberOfPoints() ==
+                 batchedSphere->getNumberOfPoints());
+
+  ConstSparseIterator itA(sphere->getDomain());
+  ConstSparseIterator itB(batchedSphere->getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    if (!itA.isDefined())
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(itB.isDefined());
+    VC_TEST_ASSERT(std::abs(itA.getValue() - itB.getValue()) < 1e-12);
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  compareSchemes<double, 2>();
+  compareSchemes<double, 3>();
+  compareSchemes<float, 2>();
+  compareSchemes<float, 3>();
+
+  compareAdvection<2>(ls::SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER);
+  compareAdvection<3>(ls::SpatialSchemeEnum::ENGQUIST_OSHER_2ND_ORDER);
+  compareAdvection<2>(ls::SpatialSchemeEnum::WENO_5TH_ORDER);
+
+  return 0;
+}
@@ -0,0 +1,99 @@
+#include <atomic>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that velocity fields evaluating whole batches of points
+  produce the same advection result as velocity fields which are queried
+  point by point.
+*/
+
+namespace ls = viennals;
+
+class PointVelocity : public ls::VelocityField<double> {
+public:
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int /*material*/,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    return 1. + 0.1 * coordinate[0];
+  }
+};
+
+class BatchVelocity : public PointVelocity {
+public:
+  std::atomic<unsigned> numberOfPoints{0};
+
+  bool getVelocities(ls::VelocityBatch<double> &batch) override {
+    for (std::size_t i = 0; i < batch.size(); ++i) {
+      batch.scalarVelocities[i] =
+          getScalarVelocity(batch.coordinates[i], batch.materials[i],
+                            batch.normalVectors[i], batch.pointIds[i]);
+      batch.vectorVelocities[i] =
+          getVectorVelocity(batch.coordinates[i], batch.materials[i],
+                            batch.normalVectors[i], batch.pointIds[i]);
+    }
+    numberOfPoints += batch.size();
+    return true;
+  }
+};
+
+template <int D> void runTest(ls::SpatialSchemeEnum spatialScheme) {
+  using T = double;
+  double gridDelta = 0.25;
+
+  auto makeSphere = [&]() {
+    auto sphere = ls::Domain<T, D>::New(gridDelta);
+    T origin[3] = {0., 0., 0.};
+    ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 5.)).apply();
+    return sphere;
+  };
+
+  auto pointSphere = makeSphere();
+  auto batchSphere = makeSphere();
+
+  auto pointVelocities = ls::SmartPointer<PointVelocity>::New();
+  auto batchVelocities = ls::SmartPointer<BatchVelocity>::New();
+
+  ls::Advect<T, D> pointAdvection(pointSphere, pointVelocities);
+  pointAdvection.setSpatialScheme(spatialScheme);
+  pointAdvection.setAdvectionTime(1.);
+  pointAdvection.apply();
+
+  ls::Advect<T, D> batchAdvection(batchSphere, batchVelocities);
+  batchAdvection.setSpatialScheme(spatialScheme);
+  batchAdvection.setAdvectionTime(1.);
+  batchAdvection.apply();
+
+  VC_TEST_ASSERT(batchVelocities->numberOfPoints > 0);
+  VC_TEST_ASSERT(pointAdvection.getNumberOfTimeSteps() ==
+                 batchAdvection.getNumberOfTimeSteps());
+  LSTEST_ASSERT_VALID_LS(batchSphere, T, D);
+  VC_TEST_ASSERT(pointSphere->getNumberOfPoints() ==
+                 batchSphere->getNumberOfPoints());
+
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itA(
+      pointSphere->getDomain());
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itB(
+      batchSphere->getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    if (!itA.isDefined())
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(std::abs(itA.getValue() - itB.getValue()) < 1e-12);
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>(ls::SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER);
+  runTest<2>(ls::SpatialSchemeEnum::LAX_FRIEDRICHS_1ST_ORDER);
+  runTest<3>(ls::SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER);
+
+  return 0;
+}
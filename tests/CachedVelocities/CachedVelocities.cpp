@@ -0,0 +1,191 @@
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that caching velocities or dissipation coefficients gives the
+  same result as querying the velocity field for each stencil, while querying
+  the velocity field less often. The global Lax Friedrichs schemes cache the
+  velocities in a separate pass and reuse them for the dissipation
+  coefficients, the local Lax Friedrichs schemes share the dissipation
+  coefficients of stencil points between stencils. Also checks the point ids
+  passed to the velocity field by the local Lax Friedrichs schemes.
+*/
+
+namespace ls = viennals;
+
+class CountingVelocity : public ls::VelocityField<double> {
+public:
+  std::atomic<unsigned long> numberOfCalls{0};
+
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int /*material*/,
+                           const std::array<double, 3> &normalVector,
+                           unsigned long /*pointId*/) override {
+    ++numberOfCalls;
+    return 1. + 0.1 * coordinate[0] + 0.5 * std::abs(normalVector[1]);
+  }
+};
+
+// velocity depending on the coordinate of the point with the passed point id,
+// which counts the queries whose point id is not the one of the point at the
+// queried coordinate
+class PointIdVelocity : public ls::VelocityField<double> {
+  std::vector<std::array<double, 3>> pointCoordinates;
+
+  template <int D>
+  void storeCoordinates(const std::vector<ls::SmartPointer<ls::Domain<double, D>>>
+                            &levelSets) {
+    const auto &levelSet = levelSets.back();
+    const auto gridDelta = levelSet->getGrid().getGridDelta();
+    pointCoordinates.assign(levelSet->getNumberOfPoints(), {});
+    for (viennahrle::ConstSparseIterator<
+             typename ls::Domain<double, D>::DomainType>
+             it(std::as_const(*levelSet).getDomain());
+         !it.isFinished(); it.next()) {
+      if (!it.isDefined())
+        continue;
+      auto &coordinate = pointCoordinates[it.getPointId()];
+      for (unsigned i = 0; i < D; ++i)
+        coordinate[i] = it.getStartIndices(i) * gridDelta;
+    }
+  }
+
+public:
+  std::atomic<unsigned long> numberOfOtherPointIds{0};
+
+  void prepare2D(const std::vector<ls::SmartPointer<ls::Domain<double, 2>>>
+                     &levelSets,
+                 unsigned /*stage*/, double /*time*/) override {
+    storeCoordinates(levelSets);
+  }
+
+  void prepare3D(const std::vector<ls::SmartPointer<ls::Domain<double, 3>>>
+                     &levelSets,
+                 unsigned /*stage*/, double /*time*/) override {
+    storeCoordinates(levelSets);
+  }
+
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int /*material*/,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long pointId) override {
+    VC_TEST_ASSERT(pointId < pointCoordinates.size());
+    const auto &pointCoordinate = pointCoordinates[pointId];
+    if (pointCoordinate != coordinate)
+      ++numberOfOtherPointIds;
+    return 1. + 0.1 * pointCoordinate[0];
+  }
+};
+
+template <int D>
+ls::SmartPointer<ls::Domain<double, D>> makeSphere(double gridDelta) {
+  auto sphere = ls::Domain<double, D>::New(gridDelta);
+  double origin[3] = {0., 0., 0.};
+  ls::MakeGeometry<double, D>(sphere, ls::Sphere<double, D>::New(origin, 3.))
+      .apply();
+  return sphere;
+}
+
+template <int D, class EnableCache>
+void runTest(ls::SpatialSchemeEnum spatialScheme, EnableCache enableCache,
+             double tolerance) {
+  using T = double;
+  double gridDelta = 0.25;
+
+  auto sphere = makeSphere<D>(gridDelta);
+  auto cachedSphere = makeSphere<D>(gridDelta);
+
+  auto velocities = ls::SmartPointer<CountingVelocity>::New();
+  auto cachedVelocities = ls::SmartPointer<CountingVelocity>::New();
+
+  ls::Advect<T, D> advection(sphere, velocities);
+  advection.setSpatialScheme(spatialScheme);
+  advection.setAdvectionTime(0.5);
+  advection.apply();
+
+  ls::Advect<T, D> cachedAdvection(cachedSphere, cachedVelocities);
+  cachedAdvection.setSpatialScheme(spatialScheme);
+  enableCache(cachedAdvection);
+  cachedAdvection.setAdvectionTime(0.5);
+  cachedAdvection.apply();
+
+  VC_TEST_ASSERT(cachedVelocities->numberOfCalls < velocities->numberOfCalls);
+  VC_TEST_ASSERT(advection.getNumberOfTimeSteps() ==
+                 cachedAdvection.getNumberOfTimeSteps());
+  LSTEST_ASSERT_VALID_LS(cachedSphere, T, D);
+  VC_TEST_ASSERT(sphere->getNumberOfPoints() ==
+                 cachedSphere->getNumberOfPoints());
+
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itA(
+      sphere->getDomain());
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itB(
+      cachedSphere->getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    if (!itA.isDefined())
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(std::abs(itA.getValue() - itB.getValue()) < tolerance);
+  }
+}
+
+// stencil points are queried with the id of the stencil center by default
+// and with their own id if the dissipation coefficients are cached
+template <int D> void runPointIdTest(ls::SpatialSchemeEnum spatialScheme) {
+  using T = double;
+  double gridDelta = 0.25;
+
+  for (bool cacheDissipation : {false, true}) {
+    auto sphere = makeSphere<D>(gridDelta);
+    auto velocities = ls::SmartPointer<PointIdVelocity>::New();
+
+    ls::Advect<T, D> advection(sphere, velocities);
+    advection.setSpatialScheme(spatialScheme);
+    advection.setCacheDissipation(cacheDissipation);
+    advection.setAdvectionTime(0.5);
+    advection.apply();
+
+    LSTEST_ASSERT_VALID_LS(sphere, T, D);
+    if (cacheDissipation) {
+      VC_TEST_ASSERT(velocities->numberOfOtherPointIds == 0);
+    } else {
+      VC_TEST_ASSERT(velocities->numberOfOtherPointIds > 0);
+    }
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  // normals of the scheme and the cache pass only differ by round-off
+  auto cacheVelocities = [](auto &advection) {
+    advection.setCacheVelocities(true);
+  };
+  runTest<2>(ls::SpatialSchemeEnum::LAX_FRIEDRICHS_1ST_ORDER, cacheVelocities,
+             1e-8);
+  runTest<3>(ls::SpatialSchemeEnum::LAX_FRIEDRICHS_1ST_ORDER, cacheVelocities,
+             1e-8);
+
+  auto cacheDissipation = [](auto &advection) {
+    advection.setCacheDissipation(true);
+  };
+  runTest<2>(ls::SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_1ST_ORDER,
+             cacheDissipation, 1e-12);
+  runTest<2>(ls::SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_2ND_ORDER,
+             cacheDissipation, 1e-12);
+  runTest<2>(ls::SpatialSchemeEnum::STENCIL_LOCAL_LAX_FRIEDRICHS_1ST_ORDER,
+             cacheDissipation, 1e-12);
+  runTest<3>(ls::SpatialSchemeEnum::STENCIL_LOCAL_LAX_FRIEDRICHS_1ST_ORDER,
+             cacheDissipation, 1e-12);
+
+  runPointIdTest<2>(ls::SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_1ST_ORDER);
+  runPointIdTest<3>(
+      ls::SpatialSchemeEnum::STENCIL_LOCAL_LAX_FRIEDRICHS_1ST_ORDER);
+
+  return 0;
+}
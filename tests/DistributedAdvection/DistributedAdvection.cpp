@@ -0,0 +1,120 @@
+#include <cmath>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsDistributedAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that advecting a level set distributed among several MPI
+  processes gives the same level set as advecting it on a single process,
+  and that all processes perform the same time steps. Has to be run with
+  several processes, e.g. mpiexec -n 3 ./DistributedAdvection.
+*/
+
+namespace ls = viennals;
+
+template <class T> class RadialVelocity : public ls::VelocityField<T> {
+public:
+  T getScalarVelocity(const std::array<T, 3> &coordinate, int /*material*/,
+                      const std::array<T, 3> & /*normalVector*/,
+                      unsigned long /*pointId*/) override {
+    return 1. + 0.05 * coordinate[0];
+  }
+};
+
+template <int D> ls::SmartPointer<ls::Domain<double, D>> makeSphere() {
+  auto sphere = ls::Domain<double, D>::New(0.25);
+  double origin[3] = {0.1, -0.2, 0.3};
+  ls::MakeGeometry<double, D>(sphere, ls::Sphere<double, D>::New(origin, 4.))
+      .apply();
+  return sphere;
+}
+
+template <int D>
+void runTest(ls::SpatialSchemeEnum spatialScheme,
+             ls::TemporalSchemeEnum temporalScheme) {
+  int rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  auto velocities = ls::SmartPointer<RadialVelocity<double>>::New();
+
+  // every process starts with the full level set
+  auto sphere = makeSphere<D>();
+  ls::DistributedAdvect<double, D> distributedAdvection(sphere, velocities);
+  distributedAdvection.setSpatialScheme(spatialScheme);
+  distributedAdvection.setTemporalScheme(temporalScheme);
+  distributedAdvection.setAdvectionTime(1.);
+  distributedAdvection.apply();
+
+  // each process only holds its slab and the ghost layers
+  const auto slab = distributedAdvection.getSlabBounds();
+  VC_TEST_ASSERT(slab.first < slab.second);
+  LSTEST_ASSERT_VALID_LS(sphere, double, D);
+
+  // all processes advected the level set by the same time steps
+  double advectedTime[2] = {distributedAdvection.getAdvectedTime(),
+                            -distributedAdvection.getAdvectedTime()};
+  MPI_Allreduce(MPI_IN_PLACE, advectedTime, 2, MPI_DOUBLE, MPI_MAX,
+                MPI_COMM_WORLD);
+  VC_TEST_ASSERT(advectedTime[0] == -advectedTime[1]);
+  VC_TEST_ASSERT(std::abs(advectedTime[0] - 1.) < 1e-10);
+
+  auto gathered = distributedAdvection.gatherLevelSet(0);
+  if (rank != 0) {
+    VC_TEST_ASSERT(gathered == nullptr);
+    return;
+  }
+  VC_TEST_ASSERT(gathered != nullptr);
+  LSTEST_ASSERT_VALID_LS(gathered, double, D);
+
+  auto serialSphere = makeSphere<D>();
+  ls::Advect<double, D> advection(serialSphere, velocities);
+  advection.setSpatialScheme(spatialScheme);
+  advection.setTemporalScheme(temporalScheme);
+  advection.setAdvectionTime(1.);
+  advection.apply();
+
+  using ConstSparseIterator = viennahrle::ConstSparseIterator<
+      typename ls::Domain<double, D>::DomainType>;
+  ConstSparseIterator gatheredIt(gathered->getDomain());
+  unsigned numberOfComparedPoints = 0;
+  double maxDifference = 0.;
+  for (ConstSparseIterator it(serialSphere->getDomain()); !it.isFinished();
+       it.next()) {
+    if (!it.isDefined() || std::abs(it.getValue()) > 0.5)
+      continue;
+    gatheredIt.goToIndicesSequential(it.getStartIndices());
+    VC_TEST_ASSERT(gatheredIt.isDefined());
+    maxDifference = std::max(maxDifference,
+                             std::abs(it.getValue() - gatheredIt.getValue()));
+    ++numberOfComparedPoints;
+  }
+
+  std::cout << D << "D: " << distributedAdvection.getNumberOfTimeSteps()
+            << " time steps, ghost width "
+            << distributedAdvection.getGhostWidth() << ", "
+            << numberOfComparedPoints
+            << " points, largest difference to serial advection "
+            << maxDifference << std::endl;
+  VC_TEST_ASSERT(numberOfComparedPoints > 0);
+  // the time steps may differ slightly, since the points at the boundary of
+  // the ghost layers also limit the time step
+  VC_TEST_ASSERT(maxDifference < 1e-2);
+}
+
+int main(int argc, char **argv) {
+  MPI_Init(&argc, &argv);
+  omp_set_num_threads(2);
+
+  runTest<2>(ls::SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER,
+             ls::TemporalSchemeEnum::FORWARD_EULER);
+  runTest<2>(ls::SpatialSchemeEnum::ENGQUIST_OSHER_2ND_ORDER,
+             ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER);
+  runTest<3>(ls::SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER,
+             ls::TemporalSchemeEnum::RUNGE_KUTTA_2ND_ORDER);
+
+  MPI_Finalize();
+  return 0;
+}
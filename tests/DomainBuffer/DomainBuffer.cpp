@@ -0,0 +1,111 @@
+#include <iostream>
+
+#include <lsBooleanOperation.hpp>
+#include <lsDomain.hpp>
+#include <lsExpand.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsReduce.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that algorithms which install their result by swapping the
+  buffer domain of a level set keep the level set and its point data
+  consistent, also when the buffer is kept and reused by several algorithms.
+*/
+
+namespace ls = viennals;
+
+template <class T, int D>
+void checkEqual(ls::SmartPointer<ls::Domain<T, D>> levelSetA,
+                ls::SmartPointer<ls::Domain<T, D>> levelSetB) {
+  VC_TEST_ASSERT(levelSetA->getNumberOfPoints() ==
+                 levelSetB->getNumberOfPoints());
+
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itA(
+      levelSetA->getDomain());
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itB(
+      levelSetB->getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    if (!itA.isDefined())
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(itB.isDefined());
+    VC_TEST_ASSERT(std::abs(itA.getValue() - itB.getValue()) < 1e-12);
+  }
+}
+
+template <class T, int D>
+void checkPointData(ls::SmartPointer<ls::Domain<T, D>> levelSet) {
+  auto ids = levelSet->getPointData().getScalarData("ids", true);
+  VC_TEST_ASSERT(ids != nullptr);
+  VC_TEST_ASSERT(ids->size() == levelSet->getNumberOfPoints());
+}
+
+template <int D> void runTest() {
+  using T = double;
+  double gridDelta = 0.4;
+
+  auto sphere = ls::Domain<T, D>::New(gridDelta);
+  T origin[3] = {0., 0., 0.};
+  ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 4.)).apply();
+
+  typename ls::PointData<T>::ScalarDataType ids(sphere->getNumberOfPoints());
+  for (std::size_t i = 0; i < ids.size(); ++i)
+    ids[i] = i;
+  sphere->getPointData().insertNextScalarData(ids, "ids");
+
+  auto reference = ls::Domain<T, D>::New(sphere);
+
+  // expanding in two steps reuses the buffer domain of the first step
+  auto expanded = ls::Domain<T, D>::New(sphere);
+  expanded->setKeepBuffer(true);
+  ls::Expand<T, D>(expanded, 3).apply();
+  ls::Expand<T, D>(expanded, 5).apply();
+  checkPointData(expanded);
+
+  auto expandedOnce = ls::Domain<T, D>::New(sphere);
+  ls::Expand<T, D>(expandedOnce, 5).apply();
+  checkEqual(expanded, expandedOnce);
+
+  // the point data is translated to the same original points, whether it is
+  // translated once for all layers or once per call
+  VC_TEST_ASSERT(*expanded->getPointData().getScalarData("ids") ==
+                 *expandedOnce->getPointData().getScalarData("ids"));
+
+  ls::Reduce<T, D>(expanded, 1).apply();
+  checkPointData(expanded);
+  LSTEST_ASSERT_VALID_LS(expanded, T, D);
+
+  // the union with itself does not change the level set
+  ls::BooleanOperation<T, D>(expandedOnce, expandedOnce,
+                             ls::BooleanOperationEnum::UNION)
+      .apply();
+  checkPointData(expandedOnce);
+  ls::Reduce<T, D>(expandedOnce, 1).apply();
+  checkEqual(expanded, expandedOnce);
+
+  // the level sets the results were copied from are not changed
+  checkEqual(sphere, reference);
+  checkPointData(sphere);
+
+  // freeing the kept buffer sets it up again when it is needed
+  expanded->setKeepBuffer(false);
+  ls::Expand<T, D>(expanded, 3).apply();
+  checkPointData(expanded);
+  LSTEST_ASSERT_VALID_LS(expanded, T, D);
+
+  sphere->clearBuffer();
+  ls::Expand<T, D>(sphere, 3).apply();
+  checkPointData(sphere);
+  LSTEST_ASSERT_VALID_LS(sphere, T, D);
+  VC_TEST_ASSERT(!sphere->getKeepBuffer());
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>();
+  runTest<3>();
+
+  return 0;
+}
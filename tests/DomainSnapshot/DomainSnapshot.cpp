@@ -0,0 +1,258 @@
+#include <iostream>
+#include <utility>
+
+#include <lsAdvect.hpp>
+#include <lsBooleanOperation.hpp>
+#include <lsDomain.hpp>
+#include <lsExpand.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that copy on write snapshots of a level set hold the values
+  the level set had when the snapshot was taken, no matter whether the
+  level set is changed, restored or destroyed afterwards. Values replaced
+  by an algorithm are kept for the snapshots instead of copying them, only
+  changing the values in place copies them. Also checks that Runge-Kutta
+  steps of several level sets do not copy the values of the lower level
+  sets.
+*/
+
+namespace ls = viennals;
+
+class EtchingVelocity : public ls::VelocityField<double> {
+public:
+  double getScalarVelocity(const std::array<double, 3> & /*coordinate*/,
+                           int /*material*/,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    return -1.;
+  }
+};
+
+// only reads the values, so snapshots keep sharing them
+template <class T, int D>
+void checkEqual(const ls::Domain<T, D> &levelSetA,
+                const ls::Domain<T, D> &levelSetB) {
+  VC_TEST_ASSERT(levelSetA.getNumberOfPoints() ==
+                 levelSetB.getNumberOfPoints());
+  VC_TEST_ASSERT(levelSetA.getLevelSetWidth() == levelSetB.getLevelSetWidth());
+
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itA(
+      levelSetA.getDomain());
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itB(
+      levelSetB.getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    if (!itA.isDefined())
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(itB.isDefined());
+    VC_TEST_ASSERT(itA.getValue() == itB.getValue());
+  }
+
+  auto idsA = levelSetA.getPointData().getScalarData("ids", true);
+  auto idsB = levelSetB.getPointData().getScalarData("ids", true);
+  VC_TEST_ASSERT((idsA == nullptr) == (idsB == nullptr));
+  if (idsA != nullptr)
+    VC_TEST_ASSERT(*idsA == *idsB);
+}
+
+template <int D> void runTest() {
+  using T = double;
+  double gridDelta = 0.4;
+
+  auto makeSphere = [&](T radius) {
+    auto sphere = ls::Domain<T, D>::New(gridDelta);
+    T origin[3] = {0., 0., 0.};
+    ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, radius))
+        .apply();
+    typename ls::PointData<T>::ScalarDataType ids(sphere->getNumberOfPoints());
+    for (std::size_t i = 0; i < ids.size(); ++i)
+      ids[i] = i;
+    sphere->getPointData().insertNextScalarData(ids, "ids");
+    return sphere;
+  };
+
+  auto sphere = makeSphere(4.);
+  auto reference = ls::Domain<T, D>::New(sphere);
+
+  // restoring an unchanged level set from its snapshot keeps it unchanged
+  {
+    auto snapshot = ls::Domain<T, D>::New(gridDelta);
+    snapshot->deepCopyOnWrite(sphere);
+    VC_TEST_ASSERT(snapshot->isSharingValues());
+    sphere->deepCopy(snapshot);
+    VC_TEST_ASSERT(snapshot->isSharingValues());
+    checkEqual(*sphere, *reference);
+    // reading the values of the snapshot keeps sharing them
+    checkEqual(*snapshot, *reference);
+    VC_TEST_ASSERT(snapshot->isSharingValues());
+  }
+
+  // replacing the values of the level set keeps the previous values for the
+  // snapshot without copying them
+  {
+    auto snapshot = ls::Domain<T, D>::New(gridDelta);
+    snapshot->deepCopyOnWrite(sphere);
+    const auto version = sphere->getVersion();
+    ls::Expand<T, D>(sphere, 5).apply();
+    VC_TEST_ASSERT(sphere->getVersion() != version);
+    VC_TEST_ASSERT(snapshot->isSharingValues());
+    checkEqual(*snapshot, *reference);
+
+    // and the level set can be restored from it, which installs the kept
+    // values again
+    sphere->deepCopy(snapshot);
+    VC_TEST_ASSERT(snapshot->isSharingValues());
+    checkEqual(*sphere, *reference);
+  }
+
+  // replacing the values through a boolean operation
+  {
+    auto snapshot = ls::Domain<T, D>::New(gridDelta);
+    snapshot->deepCopyOnWrite(sphere);
+    ls::BooleanOperation<T, D>(sphere, makeSphere(2.),
+                               ls::BooleanOperationEnum::RELATIVE_COMPLEMENT)
+        .apply();
+    VC_TEST_ASSERT(snapshot->isSharingValues());
+    checkEqual(*snapshot, *reference);
+    sphere->deepCopy(snapshot);
+    checkEqual(*sphere, *reference);
+  }
+
+  // changing the values in place through the non const getDomain() copies
+  // them into the snapshot and marks them as changed, only reading them
+  // does neither
+  {
+    auto snapshot = ls::Domain<T, D>::New(gridDelta);
+    snapshot->deepCopyOnWrite(sphere);
+    auto version = sphere->getVersion();
+    std::as_const(*sphere).getDomain();
+    VC_TEST_ASSERT(snapshot->isSharingValues());
+    VC_TEST_ASSERT(sphere->getVersion() == version);
+
+    sphere->getDomain();
+    VC_TEST_ASSERT(!snapshot->isSharingValues());
+    VC_TEST_ASSERT(sphere->getVersion() != version);
+    checkEqual(*snapshot, *reference);
+  }
+
+  // changing the values of a level set restored from kept values copies
+  // them into the snapshot
+  {
+    auto snapshot = ls::Domain<T, D>::New(gridDelta);
+    snapshot->deepCopyOnWrite(sphere);
+    ls::Expand<T, D>(sphere, 5).apply();
+    sphere->deepCopy(snapshot);
+    ls::BooleanOperation<T, D>(sphere, ls::BooleanOperationEnum::INVERT)
+        .apply();
+    VC_TEST_ASSERT(!snapshot->isSharingValues());
+    checkEqual(*snapshot, *reference);
+    sphere->deepCopy(reference);
+  }
+
+  // changing the snapshot itself copies the values
+  {
+    auto snapshot = ls::Domain<T, D>::New(gridDelta);
+    snapshot->deepCopyOnWrite(sphere);
+    ls::Expand<T, D>(snapshot, 5).apply();
+    VC_TEST_ASSERT(!snapshot->isSharingValues());
+    checkEqual(*sphere, *reference);
+  }
+
+  // a snapshot of a snapshot shares the values of the original level set,
+  // also once they were replaced
+  {
+    auto snapshot = ls::Domain<T, D>::New(gridDelta);
+    auto secondSnapshot = ls::Domain<T, D>::New(gridDelta);
+    snapshot->deepCopyOnWrite(sphere);
+    secondSnapshot->deepCopyOnWrite(snapshot);
+    VC_TEST_ASSERT(snapshot->isSharingValues());
+    VC_TEST_ASSERT(secondSnapshot->isSharingValues());
+    ls::Expand<T, D>(sphere, 5).apply();
+    auto thirdSnapshot = ls::Domain<T, D>::New(gridDelta);
+    thirdSnapshot->deepCopyOnWrite(snapshot);
+    VC_TEST_ASSERT(thirdSnapshot->isSharingValues());
+    checkEqual(*snapshot, *reference);
+    checkEqual(*secondSnapshot, *reference);
+    checkEqual(*thirdSnapshot, *reference);
+    sphere->deepCopy(reference);
+    VC_TEST_ASSERT(!thirdSnapshot->isSharingValues());
+    checkEqual(*thirdSnapshot, *reference);
+  }
+
+  // destroying the level set copies its values into the snapshots, also the
+  // values kept for them
+  {
+    auto snapshot = ls::Domain<T, D>::New(gridDelta);
+    auto keptSnapshot = ls::Domain<T, D>::New(gridDelta);
+    {
+      auto copy = ls::Domain<T, D>::New(sphere);
+      keptSnapshot->deepCopyOnWrite(copy);
+      ls::Expand<T, D>(copy, 5).apply();
+      snapshot->deepCopyOnWrite(copy);
+    }
+    VC_TEST_ASSERT(!snapshot->isSharingValues());
+    VC_TEST_ASSERT(!keptSnapshot->isSharingValues());
+    checkEqual(*keptSnapshot, *reference);
+    VC_TEST_ASSERT(snapshot->getLevelSetWidth() == 5);
+  }
+
+  // discarded snapshots are not updated anymore
+  {
+    auto snapshot = ls::Domain<T, D>::New(gridDelta);
+    snapshot->deepCopyOnWrite(sphere);
+    snapshot->discardSnapshot();
+    VC_TEST_ASSERT(!snapshot->isSharingValues());
+    ls::Expand<T, D>(sphere, 5).apply();
+    sphere->deepCopy(reference);
+  }
+}
+
+// The lower level set is etched by the Runge-Kutta steps. Its values are
+// only replaced, so a snapshot taken before advecting still shares them
+// afterwards, i.e. they were never copied.
+template <int D> void runAdvectionTest() {
+  using T = double;
+  double gridDelta = 0.25;
+
+  T origin[3] = {0., 0., 0.};
+  auto substrate = ls::Domain<T, D>::New(gridDelta);
+  ls::MakeGeometry<T, D>(substrate, ls::Sphere<T, D>::New(origin, 2.))
+      .apply();
+  auto layer = ls::Domain<T, D>::New(gridDelta);
+  ls::MakeGeometry<T, D>(layer, ls::Sphere<T, D>::New(origin, 2.5)).apply();
+
+  auto reference = ls::Domain<T, D>::New(substrate);
+  auto snapshot = ls::Domain<T, D>::New(gridDelta);
+  snapshot->deepCopyOnWrite(substrate);
+
+  ls::Advect<T, D> advection;
+  advection.insertNextLevelSet(substrate);
+  advection.insertNextLevelSet(layer);
+  advection.setVelocityField(ls::SmartPointer<EtchingVelocity>::New());
+  advection.setTemporalScheme(ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER);
+  advection.setAdvectionTime(1.);
+  advection.apply();
+
+  LSTEST_ASSERT_VALID_LS(substrate, T, D);
+  VC_TEST_ASSERT(advection.getNumberOfTimeSteps() > 1);
+  // the substrate was etched
+  VC_TEST_ASSERT(substrate->getNumberOfPoints() <
+                 reference->getNumberOfPoints());
+  VC_TEST_ASSERT(snapshot->isSharingValues());
+  checkEqual(*snapshot, *reference);
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>();
+  runTest<3>();
+
+  runAdvectionTest<2>();
+  runAdvectionTest<3>();
+
+  std::cout << "Test passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,173 @@
+#include <chrono>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsCalculateNormalVectors.hpp>
+#include <lsDomain.hpp>
+#include <lsExpand.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsReinitialize.hpp>
+#include <lsTestAsserts.hpp>
+
+namespace ls = viennals;
+
+/**
+  This benchmark compares the time per advection step when the level set is
+  rebuilt with Manhattan distances to the time per step when the values are
+  reinitialised to Euclidean distances after each rebuild. It also compares
+  the accuracy of the normal vectors of the resulting level sets to the
+  exact normal vectors of the growing sphere.
+  \example EuclideanReinitialization.cpp
+*/
+
+class ConstantVelocity : public ls::VelocityField<double> {
+public:
+  double getScalarVelocity(const ls::Vec3D<double> & /*coordinate*/,
+                           int /*material*/,
+                           const ls::Vec3D<double> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    return 1.;
+  }
+};
+
+/// Mean angle between the calculated and the exact normal vectors of a
+/// sphere centred at the origin.
+template <class T, int D>
+double normalError(ls::SmartPointer<ls::Domain<T, D>> levelSet) {
+  ls::CalculateNormalVectors<T, D>(levelSet).apply();
+  auto normals = levelSet->getPointData().getVectorData(
+      ls::CalculateNormalVectors<T, D>::normalVectorsLabel);
+  const double gridDelta = levelSet->getGrid().getGridDelta();
+
+  double error = 0.;
+  unsigned numberOfPoints = 0;
+  for (viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType>
+           it(levelSet->getDomain());
+       !it.isFinished(); it.next()) {
+    if (!it.isDefined() || std::abs(it.getValue()) > 0.5)
+      continue;
+
+    const auto &normal = normals->at(it.getPointId());
+    double cosine = 0.;
+    double radius = 0.;
+    for (int i = 0; i < D; ++i) {
+      const double coordinate = it.getStartIndices(i) * gridDelta;
+      cosine += normal[i] * coordinate;
+      radius += coordinate * coordinate;
+    }
+    cosine /= std::sqrt(radius);
+    error += std::acos(std::min(1., std::abs(cosine)));
+    ++numberOfPoints;
+  }
+  return error / numberOfPoints;
+}
+
+template <int D> void runTest() {
+  using T = double;
+
+  double gridDelta = 0.25;
+  auto sphere = ls::Domain<T, D>::New(gridDelta);
+  T origin[3] = {0., 0., 0.};
+  ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 6.)).apply();
+
+  // reinitialising a Euclidean level set must not move the interface and may
+  // only decrease the distances of the outer points
+  {
+    auto levelSet = ls::Domain<T, D>::New(sphere);
+    ls::Reinitialize<T, D>(levelSet).apply();
+    LSTEST_ASSERT_VALID_LS(levelSet, T, D);
+    VC_TEST_ASSERT(levelSet->getNumberOfPoints() ==
+                   sphere->getNumberOfPoints());
+
+    viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType>
+        itOld(sphere->getDomain());
+    viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType>
+        itNew(levelSet->getDomain());
+    for (; !itOld.isFinished(); itOld.next()) {
+      if (!itOld.isDefined())
+        continue;
+      itNew.goToIndicesSequential(itOld.getStartIndices());
+      if (std::abs(itOld.getValue()) <= 0.5) {
+        VC_TEST_ASSERT(itNew.getValue() == itOld.getValue());
+      } else {
+        VC_TEST_ASSERT(std::abs(itNew.getValue()) <=
+                       std::abs(itOld.getValue()));
+        VC_TEST_ASSERT(itNew.getValue() * itOld.getValue() > 0.);
+      }
+    }
+  }
+
+  auto velocities = ls::SmartPointer<ConstantVelocity>::New();
+  const unsigned numberOfSteps = 20;
+
+  std::vector<double> errors;
+  for (bool euclidean : {false, true}) {
+    auto levelSet = ls::Domain<T, D>::New(sphere);
+
+    ls::Advect<T, D> advectionKernel(levelSet, velocities);
+    advectionKernel.setEuclideanReinitialization(euclidean);
+    advectionKernel.setSingleStep(true);
+
+    const auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned i = 0; i < numberOfSteps; ++i) {
+      advectionKernel.apply();
+    }
+    const auto stop = std::chrono::high_resolution_clock::now();
+
+    LSTEST_ASSERT_VALID_LS(levelSet, T, D);
+    errors.push_back(normalError(levelSet));
+
+    std::cout << D << "D " << (euclidean ? "Euclidean" : "Manhattan")
+              << " rebuild: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(
+                     stop - start)
+                         .count() /
+                     numberOfSteps
+              << " us per step, mean normal error " << errors.back()
+              << " rad\n";
+  }
+
+  VC_TEST_ASSERT(errors[1] < errors[0]);
+
+  // the layers added when preparing the next step are reinitialised as well,
+  // so they are closer to the interface than the Manhattan distances
+  {
+    auto levelSet = ls::Domain<T, D>::New(sphere);
+    ls::Advect<T, D> advectionKernel(levelSet, velocities);
+    advectionKernel.setEuclideanReinitialization(true);
+    advectionKernel.setSingleStep(true);
+    advectionKernel.apply();
+
+    auto manhattan = ls::Domain<T, D>::New(levelSet);
+    advectionKernel.prepareLS();
+    ls::Expand<T, D>(manhattan, levelSet->getLevelSetWidth()).apply();
+    VC_TEST_ASSERT(levelSet->getNumberOfPoints() ==
+                   manhattan->getNumberOfPoints());
+
+    unsigned numberOfCloserPoints = 0;
+    viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType>
+        itManhattan(manhattan->getDomain());
+    viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType>
+        itEuclidean(levelSet->getDomain());
+    for (; !itManhattan.isFinished(); itManhattan.next()) {
+      if (!itManhattan.isDefined())
+        continue;
+      itEuclidean.goToIndicesSequential(itManhattan.getStartIndices());
+      VC_TEST_ASSERT(std::abs(itEuclidean.getValue()) <=
+                     std::abs(itManhattan.getValue()));
+      if (std::abs(itEuclidean.getValue()) <
+          std::abs(itManhattan.getValue()) - 1e-6)
+        ++numberOfCloserPoints;
+    }
+    VC_TEST_ASSERT(numberOfCloserPoints > 0);
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>();
+  runTest<3>();
+
+  return 0;
+}
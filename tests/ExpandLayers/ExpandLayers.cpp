@@ -0,0 +1,185 @@
+#include <iostream>
+
+#include <lsBooleanOperation.hpp>
+#include <lsDomain.hpp>
+#include <lsExpand.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that expanding a level set by several layers at once gives
+  exactly the same values and point data as adding one layer after the
+  other by sweeping over the whole level set for each layer.
+*/
+
+namespace ls = viennals;
+
+using T = double;
+
+// expansion adding one layer per sweep over the whole level set
+template <int D>
+void expandLayerByLayer(ls::SmartPointer<ls::Domain<T, D>> levelSet,
+                        int width) {
+  const T totalLimit = width * 0.5;
+  const int startWidth = levelSet->getLevelSetWidth();
+
+  for (int cycle = 0; cycle < width - startWidth; ++cycle) {
+    const T limit = (startWidth + cycle + 1) * T(0.5);
+
+    auto &grid = levelSet->getGrid();
+    auto newLevelSet = ls::Domain<T, D>::New(grid);
+    auto &newDomain = newLevelSet->getDomain();
+    auto &domain = levelSet->getDomain();
+    newDomain.initialize(domain.getNewSegmentation(), domain.getAllocation());
+
+    std::vector<std::vector<unsigned>> newDataSourceIds(
+        newDomain.getNumberOfSegments());
+
+#pragma omp parallel num_threads(newDomain.getNumberOfSegments())
+    {
+      int p = 0;
+#ifdef _OPENMP
+      p = omp_get_thread_num();
+#endif
+
+      auto &domainSegment = newDomain.getDomainSegment(p);
+
+      viennahrle::Index<D> const startVector =
+          (p == 0) ? grid.getMinGridPoint()
+                   : newDomain.getSegmentation()[p - 1];
+
+      viennahrle::Index<D> const endVector =
+          (p != static_cast<int>(newDomain.getNumberOfSegments() - 1))
+              ? newDomain.getSegmentation()[p]
+              : grid.incrementIndices(grid.getMaxGridPoint());
+
+      for (viennahrle::ConstSparseStarIterator<
+               typename ls::Domain<T, D>::DomainType, 1>
+               neighborIt(domain, startVector);
+           neighborIt.getIndices() < endVector; neighborIt.next()) {
+        auto &centerIt = neighborIt.getCenter();
+        if (std::abs(centerIt.getValue()) <= totalLimit) {
+          domainSegment.insertNextDefinedPoint(neighborIt.getIndices(),
+                                               centerIt.getValue());
+          newDataSourceIds[p].push_back(centerIt.getPointId());
+          continue;
+        }
+
+        const bool isPositive =
+            centerIt.getValue() > -std::numeric_limits<T>::epsilon();
+        T distance = isPositive ? ls::Domain<T, D>::POS_VALUE
+                                : ls::Domain<T, D>::NEG_VALUE;
+        int neighbor = -1;
+        for (int i = 0; i < 2 * D; i++) {
+          const T value = neighborIt.getNeighbor(i).getValue();
+          const T newValue = isPositive ? value + T(1) : value - T(1);
+          if (isPositive ? distance > newValue : distance < newValue) {
+            distance = newValue;
+            neighbor = i;
+          }
+        }
+        if (isPositive ? distance <= limit : distance >= -limit) {
+          domainSegment.insertNextDefinedPoint(neighborIt.getIndices(),
+                                               distance);
+          newDataSourceIds[p].push_back(
+              neighborIt.getNeighbor(neighbor).getPointId());
+        } else {
+          domainSegment.insertNextUndefinedPoint(
+              neighborIt.getIndices(), isPositive
+                                           ? ls::Domain<T, D>::POS_VALUE
+                                           : ls::Domain<T, D>::NEG_VALUE);
+        }
+      }
+    }
+
+    newLevelSet->getPointData().translateFromMultiData(
+        levelSet->getPointData(), newDataSourceIds);
+    newDomain.finalize();
+    levelSet->deepCopy(newLevelSet);
+  }
+  levelSet->getDomain().segment();
+  levelSet->finalize(width);
+}
+
+template <int D>
+void checkExpansion(ls::SmartPointer<ls::Domain<T, D>> levelSet, int width) {
+  typename ls::PointData<T>::ScalarDataType ids(levelSet->getNumberOfPoints());
+  for (std::size_t i = 0; i < ids.size(); ++i)
+    ids[i] = i;
+  levelSet->getPointData().insertNextScalarData(ids, "ids");
+
+  auto reference = ls::Domain<T, D>::New(levelSet);
+  expandLayerByLayer(reference, width);
+
+  auto expanded = ls::Domain<T, D>::New(levelSet);
+  ls::Expand<T, D>(expanded, width).apply();
+
+  LSTEST_ASSERT_VALID_LS(expanded, T, D);
+  VC_TEST_ASSERT(expanded->getLevelSetWidth() == width);
+  VC_TEST_ASSERT(expanded->getNumberOfPoints() ==
+                 reference->getNumberOfPoints());
+
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itA(
+      reference->getDomain());
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itB(
+      expanded->getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(itA.isDefined() == itB.isDefined());
+    if (itA.isDefined()) {
+      VC_TEST_ASSERT(itA.getValue() == itB.getValue());
+    } else {
+      VC_TEST_ASSERT((itA.getValue() < 0) == (itB.getValue() < 0));
+    }
+  }
+
+  VC_TEST_ASSERT(*expanded->getPointData().getScalarData("ids") ==
+                 *reference->getPointData().getScalarData("ids"));
+}
+
+// two overlapping spheres, so the values are not Manhattan distances
+template <int D>
+void makeSpheres(ls::SmartPointer<ls::Domain<T, D>> levelSet) {
+  T origin[3] = {0., 0., 0.};
+  ls::MakeGeometry<T, D>(levelSet, ls::Sphere<T, D>::New(origin, 4.3)).apply();
+
+  auto sphere = ls::Domain<T, D>::New(levelSet->getGrid());
+  origin[0] = 5.2;
+  ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 3.1)).apply();
+  ls::BooleanOperation<T, D>(levelSet, sphere, ls::BooleanOperationEnum::UNION)
+      .apply();
+}
+
+template <int D> void runTest() {
+  const double gridDelta = 0.5;
+
+  for (int width : {3, 4, 7, 12}) {
+    auto levelSet = ls::Domain<T, D>::New(gridDelta);
+    makeSpheres(levelSet);
+    checkExpansion(levelSet, width);
+  }
+
+  // spheres cut by reflective and periodic boundaries
+  double bounds[2 * D];
+  ls::BoundaryConditionEnum boundaryCons[D];
+  for (unsigned i = 0; i < D; ++i) {
+    bounds[2 * i] = -6.;
+    bounds[2 * i + 1] = 6.;
+    boundaryCons[i] = (i == 0) ? ls::BoundaryConditionEnum::PERIODIC_BOUNDARY
+                               : ls::BoundaryConditionEnum::REFLECTIVE_BOUNDARY;
+  }
+  for (int width : {3, 6, 11}) {
+    auto levelSet = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+    makeSpheres(levelSet);
+    checkExpansion(levelSet, width);
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>();
+  runTest<3>();
+
+  return 0;
+}
@@ -0,0 +1,114 @@
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsBooleanOperation.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that applying the rates directly after calculating them
+  gives the same result as storing them first, also when the top material
+  is etched through during a time step.
+*/
+
+namespace ls = viennals;
+
+class EtchingVelocity : public ls::VelocityField<double> {
+public:
+  double getScalarVelocity(const std::array<double, 3> & /*coordinate*/,
+                           int material,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    return (material == 1) ? -1. : -0.1;
+  }
+};
+
+template <class T, int D>
+void assertEqualLevelSets(ls::SmartPointer<ls::Domain<T, D>> first,
+                          ls::SmartPointer<ls::Domain<T, D>> second) {
+  VC_TEST_ASSERT(first->getNumberOfPoints() == second->getNumberOfPoints());
+
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itA(
+      first->getDomain());
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itB(
+      second->getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    if (!itA.isDefined())
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(itB.isDefined());
+    VC_TEST_ASSERT(std::abs(itA.getValue() - itB.getValue()) < 1e-12);
+  }
+}
+
+template <int D> void runTest(ls::TemporalSchemeEnum temporalScheme) {
+  using T = double;
+  double extent = 10;
+  double gridDelta = 0.5;
+  double bounds[2 * D] = {-extent, extent, -extent, extent};
+  if constexpr (D == 3) {
+    bounds[4] = -extent;
+    bounds[5] = extent;
+  }
+
+  typename ls::Domain<T, D>::BoundaryType boundaryCons[D];
+  for (unsigned i = 0; i < D - 1; ++i)
+    boundaryCons[i] = ls::Domain<T, D>::BoundaryType::REFLECTIVE_BOUNDARY;
+  boundaryCons[D - 1] = ls::Domain<T, D>::BoundaryType::INFINITE_BOUNDARY;
+
+  auto makeLayers = [&]() {
+    auto substrate = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+    T origin[3] = {0., 0., 0.};
+    T normal[3] = {0., 0., 0.};
+    normal[D - 1] = 1.;
+    ls::MakeGeometry<T, D>(substrate, ls::Plane<T, D>::New(origin, normal))
+        .apply();
+
+    // thin layer on top of the substrate, which is etched through quickly
+    auto layer = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+    origin[D - 1] = 0.7;
+    ls::MakeGeometry<T, D>(layer, ls::Plane<T, D>::New(origin, normal))
+        .apply();
+    ls::BooleanOperation<T, D>(layer, substrate, ls::BooleanOperationEnum::UNION)
+        .apply();
+
+    return std::vector<ls::SmartPointer<ls::Domain<T, D>>>{substrate, layer};
+  };
+
+  auto velocities = ls::SmartPointer<EtchingVelocity>::New();
+
+  auto storedLayers = makeLayers();
+  auto fusedLayers = makeLayers();
+
+  ls::Advect<T, D> storedAdvection(storedLayers, velocities);
+  storedAdvection.setTemporalScheme(temporalScheme);
+  storedAdvection.setSaveAdvectionVelocities(true);
+  storedAdvection.setAdvectionTime(2.);
+
+  ls::Advect<T, D> fusedAdvection(fusedLayers, velocities);
+  fusedAdvection.setTemporalScheme(temporalScheme);
+  fusedAdvection.setSaveAdvectionVelocities(true);
+  fusedAdvection.setAdvectionTime(2.);
+  fusedAdvection.setFusedRateUpdate(true);
+
+  storedAdvection.apply();
+  fusedAdvection.apply();
+
+  VC_TEST_ASSERT(storedAdvection.getNumberOfTimeSteps() ==
+                 fusedAdvection.getNumberOfTimeSteps());
+  for (unsigned i = 0; i < storedLayers.size(); ++i) {
+    LSTEST_ASSERT_VALID_LS(fusedLayers[i], T, D);
+    assertEqualLevelSets<T, D>(storedLayers[i], fusedLayers[i]);
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>(ls::TemporalSchemeEnum::FORWARD_EULER);
+  runTest<2>(ls::TemporalSchemeEnum::RUNGE_KUTTA_2ND_ORDER);
+  runTest<3>(ls::TemporalSchemeEnum::FORWARD_EULER);
+
+  return 0;
+}
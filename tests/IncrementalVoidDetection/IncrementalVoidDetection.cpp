@@ -0,0 +1,153 @@
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsBooleanOperation.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsMarkVoidPoints.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that marking the void points incrementally after the level
+  set changed gives the same markers as marking them from scratch, both for
+  changes which keep the voids and for changes which open or close a void.
+*/
+
+using NumericType = double;
+constexpr int D = 2;
+
+namespace ls = viennals;
+
+using LevelSetType = ls::SmartPointer<ls::Domain<NumericType, D>>;
+
+class ConstantVelocity : public ls::VelocityField<NumericType> {
+public:
+  NumericType
+  getScalarVelocity(const std::array<NumericType, 3> & /*coordinate*/,
+                    int /*material*/,
+                    const std::array<NumericType, 3> & /*normalVector*/,
+                    unsigned long /*pointId*/) override {
+    return 0.2;
+  }
+};
+
+void applySphere(LevelSetType domain, NumericType x, NumericType y,
+                 NumericType radius, ls::BooleanOperationEnum operation) {
+  auto sphere = LevelSetType::New(domain->getGrid());
+  NumericType origin[D] = {x, y};
+  ls::MakeGeometry(sphere, ls::Sphere<NumericType, D>::New(origin, radius))
+      .apply();
+  ls::BooleanOperation(domain, sphere, operation).apply();
+}
+
+// plane with two spherical voids below it
+void makeGeometry(LevelSetType domain) {
+  auto plane = LevelSetType::New(domain->getGrid());
+  NumericType origin[D] = {0., 0.35};
+  NumericType normal[D] = {0., 1.};
+  ls::MakeGeometry(plane, ls::Plane<NumericType, D>::New(origin, normal))
+      .apply();
+  ls::BooleanOperation(domain, plane, ls::BooleanOperationEnum::UNION).apply();
+
+  applySphere(domain, -8., -9.5, 5.1,
+              ls::BooleanOperationEnum::RELATIVE_COMPLEMENT);
+  applySphere(domain, 8., -9.5, 5.1,
+              ls::BooleanOperationEnum::RELATIVE_COMPLEMENT);
+}
+
+// compares the markers of the incremental marker with the ones of a full
+// labelling of a copy of the level set and returns the number of void points
+unsigned checkMarkers(LevelSetType domain,
+                      ls::MarkVoidPoints<NumericType, D> &incrementalMarker,
+                      bool detectLargestSurface = false) {
+  incrementalMarker.apply();
+  auto incrementalMarkers = domain->getPointData().getScalarData(
+      ls::MarkVoidPoints<NumericType, D>::voidPointLabel);
+  VC_TEST_ASSERT(incrementalMarkers);
+
+  auto copy = LevelSetType::New(domain);
+  ls::MarkVoidPoints<NumericType, D> fullMarker(copy);
+  fullMarker.setDetectLargestSurface(detectLargestSurface);
+  fullMarker.apply();
+  auto markers = copy->getPointData().getScalarData(
+      ls::MarkVoidPoints<NumericType, D>::voidPointLabel);
+  VC_TEST_ASSERT(markers);
+  VC_TEST_ASSERT(markers->size() == incrementalMarkers->size());
+
+  unsigned numberOfVoidPoints = 0;
+  for (std::size_t i = 0; i < markers->size(); ++i) {
+    if ((*markers)[i] != (*incrementalMarkers)[i]) {
+      std::cout << "ERROR: Wrong incremental VoidPointMarker "
+                << (*incrementalMarkers)[i] << " of point " << i
+                << ", expected " << (*markers)[i] << std::endl;
+      VC_TEST_ASSERT(false);
+    }
+    if ((*markers)[i] != 0)
+      ++numberOfVoidPoints;
+  }
+  return numberOfVoidPoints;
+}
+
+int main() {
+  omp_set_num_threads(2);
+
+  NumericType extent = 15;
+  NumericType gridDelta = 1;
+
+  double bounds[2 * D] = {-extent, extent, -extent, extent};
+  ls::BoundaryConditionEnum boundaryCons[D];
+  boundaryCons[0] = ls::BoundaryConditionEnum::REFLECTIVE_BOUNDARY;
+  boundaryCons[1] = ls::BoundaryConditionEnum::INFINITE_BOUNDARY;
+
+  auto domain = LevelSetType::New(bounds, boundaryCons, gridDelta);
+  makeGeometry(domain);
+
+  ls::MarkVoidPoints<NumericType, D> marker(domain);
+  marker.setIncremental(true);
+  const auto initialVoidPoints = checkMarkers(domain, marker);
+  VC_TEST_ASSERT(initialVoidPoints > 0);
+
+  // unchanged level set
+  VC_TEST_ASSERT(checkMarkers(domain, marker) == initialVoidPoints);
+
+  // small advection steps move the surfaces, but keep both voids
+  auto velocities = ls::SmartPointer<ConstantVelocity>::New();
+  for (unsigned i = 0; i < 3; ++i) {
+    ls::Advect<NumericType, D> advection(domain, velocities);
+    advection.setSingleStep(true);
+    advection.apply();
+    VC_TEST_ASSERT(checkMarkers(domain, marker) > 0);
+  }
+
+  // opening the left void to the top surface leaves only the right void
+  applySphere(domain, -8., -2., 3.5,
+              ls::BooleanOperationEnum::RELATIVE_COMPLEMENT);
+  const auto openedVoidPoints = checkMarkers(domain, marker);
+  VC_TEST_ASSERT(openedVoidPoints > 0);
+
+  // closing the opening again forms a new void
+  applySphere(domain, -8., 0., 4.5, ls::BooleanOperationEnum::UNION);
+  VC_TEST_ASSERT(checkMarkers(domain, marker) > openedVoidPoints);
+
+  // advection ignoring the void points marks them incrementally
+  ls::Advect<NumericType, D> advection(domain, velocities);
+  advection.setIgnoreVoids(true);
+  advection.setIncrementalVoidDetection(true);
+  advection.setAdvectionTime(1.5);
+  advection.apply();
+  LSTEST_ASSERT_VALID_LS(domain, NumericType, D);
+  ls::MarkVoidPoints<NumericType, D> advectionMarker(domain);
+  VC_TEST_ASSERT(checkMarkers(domain, advectionMarker) > 0);
+
+  // any change might make another surface the largest one, so it is always
+  // labelled again
+  ls::MarkVoidPoints<NumericType, D> largestMarker(domain);
+  largestMarker.setIncremental(true);
+  largestMarker.setDetectLargestSurface(true);
+  checkMarkers(domain, largestMarker, true);
+  applySphere(domain, 8., -2., 3.5,
+              ls::BooleanOperationEnum::RELATIVE_COMPLEMENT);
+  checkMarkers(domain, largestMarker, true);
+
+  return 0;
+}
@@ -0,0 +1,132 @@
+#include <iostream>
+
+#include <lsBooleanOperation.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsMaterialIndexField.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that the materials found in a single pass over a stack of
+  level sets are the same as the ones found by moving an iterator of each
+  lower level set to every point of the top level set. Also checks that the
+  runs of points exposing a static material contain exactly these points.
+*/
+
+namespace ls = viennals;
+
+template <int D> void runTest() {
+  using T = double;
+  using ConstSparseIterator =
+      viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType>;
+  constexpr T cutoff = 0.5;
+  constexpr T epsilon = 1e-4;
+
+  double gridDelta = 0.5;
+  double extent = 15.;
+  double bounds[2 * D] = {-extent, extent, -extent, extent};
+  if constexpr (D == 3) {
+    bounds[4] = -extent;
+    bounds[5] = extent;
+  }
+  typename ls::Domain<T, D>::BoundaryType boundaryCons[D];
+  for (unsigned i = 0; i < D - 1; ++i)
+    boundaryCons[i] = ls::Domain<T, D>::BoundaryType::REFLECTIVE_BOUNDARY;
+  boundaryCons[D - 1] = ls::Domain<T, D>::BoundaryType::INFINITE_BOUNDARY;
+
+  // substrate, a layer covering it and a sphere on top, so every material
+  // is exposed somewhere
+  std::vector<ls::SmartPointer<ls::Domain<T, D>>> stack;
+  for (unsigned i = 0; i < 2; ++i) {
+    auto plane = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+    T origin[3] = {0., 0., 0.};
+    origin[D - 1] = 2. * i;
+    T normal[3] = {0., 0., 0.};
+    normal[D - 1] = 1.;
+    ls::MakeGeometry<T, D>(plane, ls::Plane<T, D>::New(origin, normal))
+        .apply();
+    stack.push_back(plane);
+  }
+  {
+    // open the layer above the substrate on one side
+    auto cut = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+    T minCorner[3] = {-extent - 1., -extent - 1., -extent - 1.};
+    T maxCorner[3] = {0., extent + 1., extent + 1.};
+    maxCorner[D - 1] = 3.;
+    ls::MakeGeometry<T, D>(cut, ls::Box<T, D>::New(minCorner, maxCorner))
+        .apply();
+    ls::BooleanOperation<T, D>(stack[1], cut,
+                               ls::BooleanOperationEnum::RELATIVE_COMPLEMENT)
+        .apply();
+    ls::BooleanOperation<T, D>(stack[1], stack[0],
+                               ls::BooleanOperationEnum::UNION)
+        .apply();
+  }
+  {
+    auto sphere = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+    T origin[3] = {5., 0., 0.};
+    origin[D - 1] = 2.;
+    ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 3.)).apply();
+    ls::BooleanOperation<T, D>(sphere, stack[1],
+                               ls::BooleanOperationEnum::UNION)
+        .apply();
+    stack.push_back(sphere);
+  }
+
+  lsInternal::MaterialIndexField<T, D> materialIndices;
+  materialIndices.build(stack, cutoff, epsilon);
+  VC_TEST_ASSERT(materialIndices.size() == stack.back()->getNumberOfPoints());
+
+  // the substrate is static
+  lsInternal::MaterialIndexField<T, D> staticIndices;
+  staticIndices.build(stack, cutoff, epsilon, {true, false, false});
+  auto staticCursor = staticIndices.getStaticRunCursor(
+      stack.back()->getGrid().getMinGridPoint());
+
+  std::vector<ConstSparseIterator> iterators;
+  for (auto &levelSet : stack)
+    iterators.emplace_back(levelSet->getDomain());
+
+  std::vector<unsigned> exposed(stack.size(), 0);
+  for (auto &topIt = iterators.back(); !topIt.isFinished(); topIt.next()) {
+    if (!topIt.isDefined())
+      continue;
+
+    const auto pointId = topIt.getPointId();
+    if (std::abs(topIt.getValue()) > cutoff) {
+      VC_TEST_ASSERT(materialIndices.getMaterial(pointId) == -1);
+      continue;
+    }
+
+    int material = stack.size() - 1;
+    for (unsigned i = 0; i + 1 < stack.size(); ++i) {
+      iterators[i].goToIndicesSequential(topIt.getStartIndices());
+      if (iterators[i].getValue() <= topIt.getValue() + epsilon) {
+        material = i;
+        break;
+      }
+    }
+    auto &below = iterators[stack.size() - 2];
+    below.goToIndicesSequential(topIt.getStartIndices());
+
+    VC_TEST_ASSERT(materialIndices.getMaterial(pointId) == material);
+    VC_TEST_ASSERT(materialIndices.getValueBelow(pointId) == below.getValue());
+    VC_TEST_ASSERT((staticCursor.find(topIt.getStartIndices()) != nullptr) ==
+                   (material == 0));
+    ++exposed[material];
+  }
+
+  for (unsigned i = 0; i < stack.size(); ++i) {
+    VC_TEST_ASSERT(exposed[i] > 0);
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>();
+  runTest<3>();
+
+  std::cout << "Test passed!" << std::endl;
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that advecting a level set stored in single precision gives
+  the same level set as advecting it in double precision, up to the rounding
+  of the stored values, for all time integration schemes. The updates of the
+  values are accumulated in double precision, so the rounding errors must not
+  grow with the number of time steps.
+*/
+
+namespace ls = viennals;
+
+template <class T> class RadialVelocity : public ls::VelocityField<T> {
+public:
+  T getScalarVelocity(const std::array<T, 3> &coordinate, int /*material*/,
+                      const std::array<T, 3> & /*normalVector*/,
+                      unsigned long /*pointId*/) override {
+    return T(0.7) + T(0.05) * coordinate[0];
+  }
+};
+
+template <class T, int D>
+ls::SmartPointer<ls::Domain<T, D>>
+advectSphere(ls::TemporalSchemeEnum temporalScheme) {
+  double bounds[2 * D];
+  typename ls::Domain<T, D>::BoundaryType boundaryCons[D];
+  for (int i = 0; i < D; ++i) {
+    bounds[2 * i] = -8.;
+    bounds[2 * i + 1] = 8.;
+    boundaryCons[i] = ls::Domain<T, D>::BoundaryType::REFLECTIVE_BOUNDARY;
+  }
+  auto sphere = ls::Domain<T, D>::New(bounds, boundaryCons, 0.25);
+  T origin[3] = {0.1, 0.2, -0.1};
+  ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 3.)).apply();
+
+  auto velocities = ls::SmartPointer<RadialVelocity<T>>::New();
+  ls::Advect<T, D> advection(sphere, velocities);
+  advection.setSpatialScheme(ls::SpatialSchemeEnum::ENGQUIST_OSHER_2ND_ORDER);
+  advection.setTemporalScheme(temporalScheme);
+  advection.setAdvectionTime(2.);
+  advection.apply();
+  return sphere;
+}
+
+template <int D> void compareToDouble(ls::TemporalSchemeEnum temporalScheme) {
+  auto doubleSphere = advectSphere<double, D>(temporalScheme);
+  auto floatSphere = advectSphere<float, D>(temporalScheme);
+  LSTEST_ASSERT_VALID_LS(floatSphere, float, D);
+
+  using DoubleIterator = viennahrle::ConstSparseIterator<
+      typename ls::Domain<double, D>::DomainType>;
+  using FloatIterator = viennahrle::ConstSparseIterator<
+      typename ls::Domain<float, D>::DomainType>;
+
+  DoubleIterator doubleIt(doubleSphere->getDomain());
+  unsigned numberOfComparedPoints = 0;
+  double maxDifference = 0.;
+  for (FloatIterator it(floatSphere->getDomain());
+       !it.isFinished(); it.next()) {
+    if (!it.isDefined() || std::abs(it.getValue()) > 0.5)
+      continue;
+    doubleIt.goToIndicesSequential(it.getStartIndices());
+    if (!doubleIt.isDefined())
+      continue;
+    maxDifference =
+        std::max(maxDifference, std::abs(it.getValue() - doubleIt.getValue()));
+    ++numberOfComparedPoints;
+  }
+
+  std::cout << D << "D, temporal scheme "
+            << static_cast<unsigned>(temporalScheme) << ": "
+            << numberOfComparedPoints
+            << " points, largest difference to double precision "
+            << maxDifference << std::endl;
+  VC_TEST_ASSERT(numberOfComparedPoints > 0);
+  // the spatial schemes and velocities are evaluated in single precision,
+  // so the difference is well above the rounding of the stored values
+  VC_TEST_ASSERT(maxDifference < 1e-3);
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  for (auto temporalScheme :
+       {ls::TemporalSchemeEnum::FORWARD_EULER,
+        ls::TemporalSchemeEnum::RUNGE_KUTTA_2ND_ORDER,
+        ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER}) {
+    compareToDouble<2>(temporalScheme);
+    compareToDouble<3>(temporalScheme);
+  }
+
+  return 0;
+}
@@ -0,0 +1,94 @@
+#include <atomic>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsCompareChamfer.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that multirate time stepping, which reuses the rates of
+  slowly moving points for several time steps, queries the velocity field
+  less often than standard time stepping, while giving a similar surface.
+*/
+
+namespace ls = viennals;
+
+// a small hot spot on the surface moves much faster than the rest
+class HotSpotVelocity : public ls::VelocityField<double> {
+public:
+  std::atomic<unsigned long> numberOfCalls{0};
+
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int /*material*/,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    ++numberOfCalls;
+    return (std::abs(coordinate[0]) < 1.) ? -2. : -0.1;
+  }
+};
+
+template <int D> void runTest() {
+  using T = double;
+  double gridDelta = 0.2;
+
+  double bounds[2 * D] = {-10., 10., -10., 10.};
+  if constexpr (D == 3) {
+    bounds[4] = -10.;
+    bounds[5] = 10.;
+  }
+  typename ls::Domain<T, D>::BoundaryType boundaryCons[D];
+  for (int i = 0; i < D - 1; ++i)
+    boundaryCons[i] = ls::Domain<T, D>::BoundaryType::REFLECTIVE_BOUNDARY;
+  boundaryCons[D - 1] = ls::Domain<T, D>::BoundaryType::INFINITE_BOUNDARY;
+
+  auto makePlane = [&]() {
+    auto plane = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+    T origin[3] = {0., 0., 0.};
+    T normal[3] = {0., 0., 0.};
+    normal[D - 1] = 1.;
+    ls::MakeGeometry<T, D>(plane, ls::Plane<T, D>::New(origin, normal))
+        .apply();
+    return plane;
+  };
+
+  auto plane = makePlane();
+  auto multiratePlane = makePlane();
+
+  auto velocities = ls::SmartPointer<HotSpotVelocity>::New();
+  auto multirateVelocities = ls::SmartPointer<HotSpotVelocity>::New();
+
+  ls::Advect<T, D> advection(plane, velocities);
+  advection.setAdvectionTime(1.);
+  advection.apply();
+
+  ls::Advect<T, D> multirateAdvection(multiratePlane, multirateVelocities);
+  multirateAdvection.setMultirateTimeStepping(true, 4);
+  multirateAdvection.setAdvectionTime(1.);
+  multirateAdvection.apply();
+
+  std::cout << D << "D: " << velocities->numberOfCalls << " velocity calls, "
+            << multirateVelocities->numberOfCalls << " with multirate"
+            << std::endl;
+
+  VC_TEST_ASSERT(multirateVelocities->numberOfCalls <
+                 velocities->numberOfCalls / 2);
+  VC_TEST_ASSERT(std::abs(multirateAdvection.getAdvectedTime() - 1.) < 1e-6);
+  LSTEST_ASSERT_VALID_LS(multiratePlane, T, D);
+
+  ls::CompareChamfer<T, D> compare(plane, multiratePlane);
+  compare.apply();
+  std::cout << "Chamfer distance: " << compare.getChamferDistance()
+            << std::endl;
+  VC_TEST_ASSERT(compare.getChamferDistance() < 0.5 * gridDelta);
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>();
+  runTest<3>();
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+#include <iostream>
+
+#include <lsBooleanOperation.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsMarkVoidPoints.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that labelling the connected components of a level set
+  split into many segments gives the same void points and components as
+  labelling it as a single segment. The voids lie across the boundaries
+  of the segments.
+*/
+
+using NumericType = double;
+constexpr int D = 3;
+
+namespace ls = viennals;
+
+using LevelSetType = ls::SmartPointer<ls::Domain<NumericType, D>>;
+
+void makeGeometry(LevelSetType domain) {
+  auto plane = LevelSetType::New(domain->getGrid());
+  NumericType origin[D] = {0., 0., 10.3};
+  NumericType normal[D] = {0., 0., 1.};
+  ls::MakeGeometry(plane, ls::Plane<NumericType, D>::New(origin, normal))
+      .apply();
+  ls::BooleanOperation(domain, plane, ls::BooleanOperationEnum::UNION).apply();
+
+  // voids at different heights, the last one is opened to the top surface
+  NumericType centers[4][D] = {
+      {-6., -5., -9.}, {5., 4., -2.5}, {-4., 6., 4.}, {6., -6., 8.}};
+  for (auto &center : centers) {
+    auto hole = LevelSetType::New(domain->getGrid());
+    ls::MakeGeometry(hole, ls::Sphere<NumericType, D>::New(center, 3.6))
+        .apply();
+    ls::BooleanOperation(domain, hole,
+                         ls::BooleanOperationEnum::RELATIVE_COMPLEMENT)
+        .apply();
+  }
+}
+
+std::vector<NumericType> *markVoidPoints(LevelSetType domain,
+                                         const char *label) {
+  ls::MarkVoidPoints<NumericType, D> marker(domain);
+  marker.setSaveComponentIds(true);
+  marker.apply();
+  return domain->getPointData().getScalarData(label);
+}
+
+int main() {
+  NumericType extent = 15;
+  NumericType gridDelta = 1;
+
+  double bounds[2 * D] = {-extent, extent, -extent, extent, -extent, extent};
+  ls::BoundaryConditionEnum boundaryCons[D];
+  boundaryCons[0] = ls::BoundaryConditionEnum::REFLECTIVE_BOUNDARY;
+  boundaryCons[1] = ls::BoundaryConditionEnum::PERIODIC_BOUNDARY;
+  boundaryCons[2] = ls::BoundaryConditionEnum::INFINITE_BOUNDARY;
+
+  omp_set_num_threads(1);
+  auto serial = LevelSetType::New(bounds, boundaryCons, gridDelta);
+  makeGeometry(serial);
+  VC_TEST_ASSERT(serial->getNumberOfSegments() == 1);
+
+  omp_set_num_threads(8);
+  auto parallel = LevelSetType::New(serial);
+  parallel->getDomain().segment();
+  VC_TEST_ASSERT(parallel->getNumberOfSegments() > 1);
+  VC_TEST_ASSERT(parallel->getNumberOfPoints() == serial->getNumberOfPoints());
+
+  for (const char *label :
+       {ls::MarkVoidPoints<NumericType, D>::voidPointLabel,
+        "ConnectedComponentId"}) {
+    auto serialMarkers = markVoidPoints(serial, label);
+    auto parallelMarkers = markVoidPoints(parallel, label);
+    VC_TEST_ASSERT(serialMarkers && parallelMarkers);
+
+    using ConstSparseIterator =
+        viennahrle::ConstSparseIterator<ls::Domain<NumericType, D>::DomainType>;
+    ConstSparseIterator parallelIt(parallel->getDomain());
+    unsigned numberOfVoidPoints = 0;
+    for (ConstSparseIterator it(serial->getDomain()); !it.isFinished();
+         it.next()) {
+      if (!it.isDefined())
+        continue;
+      parallelIt.goToIndicesSequential(it.getStartIndices());
+      VC_TEST_ASSERT(parallelIt.isDefined());
+      const auto marker = serialMarkers->at(it.getPointId());
+      if (marker != parallelMarkers->at(parallelIt.getPointId())) {
+        std::cout << "ERROR: Different " << label << " "
+                  << parallelMarkers->at(parallelIt.getPointId()) << " at "
+                  << it.getStartIndices() << ", expected " << marker
+                  << std::endl;
+        VC_TEST_ASSERT(false);
+      }
+      if (marker != 0)
+        ++numberOfVoidPoints;
+    }
+    // there are void points and several components
+    VC_TEST_ASSERT(numberOfVoidPoints > 0);
+  }
+
+  return 0;
+}
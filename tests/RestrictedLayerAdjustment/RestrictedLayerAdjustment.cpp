@@ -0,0 +1,124 @@
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsBooleanOperation.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that adjusting the lower level sets only in the region in
+  which the top level set moved gives the same result as adjusting them
+  everywhere, when only a small part of a material stack is etched.
+*/
+
+namespace ls = viennals;
+
+class LocalEtch : public ls::VelocityField<double> {
+public:
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int material,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    if (std::abs(coordinate[0]) > 2.)
+      return 0.;
+    return (material == 0) ? -0.3 : -1.;
+  }
+};
+
+template <class T, int D>
+void checkEqual(ls::SmartPointer<ls::Domain<T, D>> levelSetA,
+                ls::SmartPointer<ls::Domain<T, D>> levelSetB,
+                double tolerance) {
+  VC_TEST_ASSERT(levelSetA->getNumberOfPoints() ==
+                 levelSetB->getNumberOfPoints());
+
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itA(
+      levelSetA->getDomain());
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itB(
+      levelSetB->getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    if (!itA.isDefined())
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(itB.isDefined());
+    VC_TEST_ASSERT(std::abs(itA.getValue() - itB.getValue()) <= tolerance);
+  }
+}
+
+template <int D> void runTest(ls::TemporalSchemeEnum temporalScheme) {
+  using T = double;
+  double gridDelta = 0.25;
+  double extent = 10.;
+
+  double bounds[2 * D] = {-extent, extent, -extent, extent};
+  if constexpr (D == 3) {
+    bounds[4] = -extent;
+    bounds[5] = extent;
+  }
+  typename ls::Domain<T, D>::BoundaryType boundaryCons[D];
+  for (unsigned i = 0; i < D - 1; ++i)
+    boundaryCons[i] = ls::Domain<T, D>::BoundaryType::PERIODIC_BOUNDARY;
+  boundaryCons[D - 1] = ls::Domain<T, D>::BoundaryType::INFINITE_BOUNDARY;
+
+  auto makePlane = [&](T height) {
+    auto plane = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+    T origin[3] = {0., 0., 0.};
+    origin[D - 1] = height;
+    T normal[3] = {0., 0., 0.};
+    normal[D - 1] = 1.;
+    ls::MakeGeometry<T, D>(plane, ls::Plane<T, D>::New(origin, normal))
+        .apply();
+    return plane;
+  };
+
+  // stack of three materials, each wrapping the ones below
+  std::vector<ls::SmartPointer<ls::Domain<T, D>>> stack;
+  for (unsigned i = 0; i < 3; ++i) {
+    stack.push_back(makePlane(1. + i));
+    if (i > 0)
+      ls::BooleanOperation<T, D>(stack[i], stack[i - 1],
+                                 ls::BooleanOperationEnum::UNION)
+          .apply();
+  }
+
+  auto velocities = ls::SmartPointer<LocalEtch>::New();
+
+  std::vector<std::vector<ls::SmartPointer<ls::Domain<T, D>>>> results;
+  for (bool restricted : {false, true}) {
+    std::vector<ls::SmartPointer<ls::Domain<T, D>>> levelSets;
+    ls::Advect<T, D> advectionKernel;
+    for (auto &levelSet : stack) {
+      levelSets.push_back(ls::Domain<T, D>::New(levelSet));
+      advectionKernel.insertNextLevelSet(levelSets.back());
+    }
+    advectionKernel.setVelocityField(velocities);
+    advectionKernel.setTemporalScheme(temporalScheme);
+    advectionKernel.setRestrictLayerAdjustment(restricted);
+
+    // several calls, since the first step of each call adjusts everything
+    for (unsigned i = 0; i < 3; ++i) {
+      advectionKernel.setAdvectionTime(0.8);
+      advectionKernel.apply();
+    }
+
+    for (auto &levelSet : levelSets)
+      LSTEST_ASSERT_VALID_LS(levelSet, T, D);
+    results.push_back(levelSets);
+  }
+
+  const double tolerance =
+      (temporalScheme == ls::TemporalSchemeEnum::FORWARD_EULER) ? 0. : 1e-6;
+  for (unsigned i = 0; i < stack.size(); ++i)
+    checkEqual(results[0][i], results[1][i], tolerance);
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>(ls::TemporalSchemeEnum::FORWARD_EULER);
+  runTest<2>(ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER);
+  runTest<3>(ls::TemporalSchemeEnum::FORWARD_EULER);
+
+  return 0;
+}
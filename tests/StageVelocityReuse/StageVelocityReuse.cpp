@@ -0,0 +1,129 @@
+#include <atomic>
+#include <cmath>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that the Runge-Kutta schemes only query the velocity field in
+  the first stage of each time step if the velocities should be reused, that
+  this does not change the result for velocities which are constant during a
+  time step, and that the velocities are evaluated in every stage if a
+  velocity update callback is set.
+*/
+
+namespace ls = viennals;
+
+class CountingVelocity : public ls::VelocityField<double> {
+  const double gradient;
+
+public:
+  std::atomic<unsigned long> numberOfCalls{0};
+
+  CountingVelocity(double passedGradient) : gradient(passedGradient) {}
+
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int /*material*/,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    ++numberOfCalls;
+    return 1. + gradient * coordinate[0];
+  }
+};
+
+template <int D>
+ls::SmartPointer<ls::Domain<double, D>>
+advectSphere(ls::TemporalSchemeEnum temporalScheme, bool reuse,
+             ls::SmartPointer<CountingVelocity> velocities,
+             bool setCallback = false) {
+  auto sphere = ls::Domain<double, D>::New(0.25);
+  double origin[3] = {0., 0., 0.};
+  ls::MakeGeometry<double, D>(sphere, ls::Sphere<double, D>::New(origin, 3.))
+      .apply();
+
+  ls::Advect<double, D> advection(sphere, velocities);
+  advection.setTemporalScheme(temporalScheme);
+  advection.setReuseStageVelocities(reuse);
+  if (setCallback)
+    advection.setVelocityUpdateCallback(
+        [](ls::SmartPointer<ls::Domain<double, D>>) { return true; });
+  advection.setAdvectionTime(0.5);
+  advection.apply();
+  return sphere;
+}
+
+template <int D>
+double maxDifference(ls::SmartPointer<ls::Domain<double, D>> &levelSetA,
+                     ls::SmartPointer<ls::Domain<double, D>> &levelSetB) {
+  using ConstSparseIterator = viennahrle::ConstSparseIterator<
+      typename ls::Domain<double, D>::DomainType>;
+
+  double difference = 0.;
+  ConstSparseIterator itB(levelSetB->getDomain());
+  for (ConstSparseIterator itA(levelSetA->getDomain()); !itA.isFinished();
+       itA.next()) {
+    if (!itA.isDefined() || std::abs(itA.getValue()) > 0.5)
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(itB.isDefined());
+    difference =
+        std::max(difference, std::abs(itA.getValue() - itB.getValue()));
+  }
+  return difference;
+}
+
+template <int D> void runTest(ls::TemporalSchemeEnum temporalScheme) {
+  // constant velocities give the same result
+  {
+    auto velocities = ls::SmartPointer<CountingVelocity>::New(0.);
+    auto reuseVelocities = ls::SmartPointer<CountingVelocity>::New(0.);
+    auto sphere = advectSphere<D>(temporalScheme, false, velocities);
+    auto reuseSphere = advectSphere<D>(temporalScheme, true, reuseVelocities);
+
+    std::cout << D << "D: " << velocities->numberOfCalls << " calls, "
+              << reuseVelocities->numberOfCalls << " calls with reuse"
+              << std::endl;
+    // the velocities are only evaluated in one of the stages
+    const double stages =
+        (temporalScheme == ls::TemporalSchemeEnum::RUNGE_KUTTA_2ND_ORDER) ? 2.
+                                                                          : 3.;
+    VC_TEST_ASSERT(reuseVelocities->numberOfCalls <
+                   (1. / stages + 0.2) * velocities->numberOfCalls);
+    VC_TEST_ASSERT(sphere->getNumberOfPoints() ==
+                   reuseSphere->getNumberOfPoints());
+    VC_TEST_ASSERT(maxDifference<D>(sphere, reuseSphere) < 1e-12);
+  }
+
+  // velocities changing in space only change slightly within a time step
+  {
+    auto velocities = ls::SmartPointer<CountingVelocity>::New(0.1);
+    auto reuseVelocities = ls::SmartPointer<CountingVelocity>::New(0.1);
+    auto sphere = advectSphere<D>(temporalScheme, false, velocities);
+    auto reuseSphere = advectSphere<D>(temporalScheme, true, reuseVelocities);
+    LSTEST_ASSERT_VALID_LS(reuseSphere, double, D);
+    VC_TEST_ASSERT(maxDifference<D>(sphere, reuseSphere) < 0.05);
+  }
+
+  // with a velocity update callback, velocities are always evaluated again
+  {
+    auto velocities = ls::SmartPointer<CountingVelocity>::New(0.);
+    auto reuseVelocities = ls::SmartPointer<CountingVelocity>::New(0.);
+    advectSphere<D>(temporalScheme, false, velocities, true);
+    advectSphere<D>(temporalScheme, true, reuseVelocities, true);
+    VC_TEST_ASSERT(reuseVelocities->numberOfCalls ==
+                   velocities->numberOfCalls);
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>(ls::TemporalSchemeEnum::RUNGE_KUTTA_2ND_ORDER);
+  runTest<2>(ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER);
+  runTest<3>(ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER);
+
+  return 0;
+}
@@ -0,0 +1,130 @@
+#include <atomic>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsBooleanOperation.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that skipping the points of materials which are marked as
+  static by the velocity field gives the same result as evaluating them,
+  while querying the velocity field less often.
+*/
+
+namespace ls = viennals;
+
+// the mask does not move, the substrate is etched
+class MaskedEtchVelocity : public ls::VelocityField<double> {
+  bool staticHint;
+
+public:
+  std::atomic<unsigned long> numberOfCalls{0};
+
+  MaskedEtchVelocity(bool hint) : staticHint(hint) {}
+
+  double getScalarVelocity(const std::array<double, 3> & /*coordinate*/,
+                           int material,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    ++numberOfCalls;
+    return (material == 0) ? 0. : -1.;
+  }
+
+  bool isStaticMaterial(int material) override {
+    return staticHint && material == 0;
+  }
+};
+
+template <int D> void runTest(ls::SpatialSchemeEnum spatialScheme) {
+  using T = double;
+  using ConstSparseIterator =
+      viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType>;
+  double gridDelta = 0.25;
+
+  double extent = 10.;
+  double bounds[2 * D] = {-extent, extent, -extent, extent};
+  if constexpr (D == 3) {
+    bounds[4] = -extent;
+    bounds[5] = extent;
+  }
+  typename ls::Domain<T, D>::BoundaryType boundaryCons[D];
+  for (int i = 0; i < D - 1; ++i)
+    boundaryCons[i] = ls::Domain<T, D>::BoundaryType::REFLECTIVE_BOUNDARY;
+  boundaryCons[D - 1] = ls::Domain<T, D>::BoundaryType::INFINITE_BOUNDARY;
+
+  auto makeLevelSets = [&]() {
+    auto substrate = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+    T origin[3] = {0., 0., 0.};
+    T normal[3] = {0., 0., 0.};
+    normal[D - 1] = 1.;
+    ls::MakeGeometry<T, D>(substrate, ls::Plane<T, D>::New(origin, normal))
+        .apply();
+
+    // the mask covers half of the substrate
+    auto mask = ls::Domain<T, D>::New(bounds, boundaryCons, gridDelta);
+    T minCorner[3] = {-extent - 1., -extent - 1., -extent - 1.};
+    T maxCorner[3] = {0., extent + 1., extent + 1.};
+    minCorner[D - 1] = -3.;
+    maxCorner[D - 1] = 2.;
+    ls::MakeGeometry<T, D>(mask, ls::Box<T, D>::New(minCorner, maxCorner))
+        .apply();
+    ls::BooleanOperation<T, D>(substrate, mask, ls::BooleanOperationEnum::UNION)
+        .apply();
+    return std::make_pair(mask, substrate);
+  };
+
+  auto [mask, substrate] = makeLevelSets();
+  auto [hintMask, hintSubstrate] = makeLevelSets();
+
+  auto velocities = ls::SmartPointer<MaskedEtchVelocity>::New(false);
+  auto hintVelocities = ls::SmartPointer<MaskedEtchVelocity>::New(true);
+
+  ls::Advect<T, D> advection;
+  advection.insertNextLevelSet(mask);
+  advection.insertNextLevelSet(substrate);
+  advection.setVelocityField(velocities);
+  advection.setSpatialScheme(spatialScheme);
+  advection.setAdvectionTime(2.);
+  advection.apply();
+
+  ls::Advect<T, D> hintAdvection;
+  hintAdvection.insertNextLevelSet(hintMask);
+  hintAdvection.insertNextLevelSet(hintSubstrate);
+  hintAdvection.setVelocityField(hintVelocities);
+  hintAdvection.setSpatialScheme(spatialScheme);
+  hintAdvection.setAdvectionTime(2.);
+  hintAdvection.apply();
+
+  std::cout << D << "D: " << velocities->numberOfCalls << " velocity calls, "
+            << hintVelocities->numberOfCalls << " with static mask"
+            << std::endl;
+
+  VC_TEST_ASSERT(hintVelocities->numberOfCalls < velocities->numberOfCalls);
+  VC_TEST_ASSERT(advection.getNumberOfTimeSteps() ==
+                 hintAdvection.getNumberOfTimeSteps());
+  LSTEST_ASSERT_VALID_LS(hintSubstrate, T, D);
+  VC_TEST_ASSERT(substrate->getNumberOfPoints() ==
+                 hintSubstrate->getNumberOfPoints());
+
+  ConstSparseIterator itA(substrate->getDomain());
+  ConstSparseIterator itB(hintSubstrate->getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    if (!itA.isDefined())
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(itB.isDefined());
+    VC_TEST_ASSERT(itA.getValue() == itB.getValue());
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>(ls::SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER);
+  runTest<3>(ls::SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER);
+  runTest<2>(ls::SpatialSchemeEnum::WENO_3RD_ORDER);
+
+  return 0;
+}
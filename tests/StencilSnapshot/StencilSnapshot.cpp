@@ -0,0 +1,219 @@
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <lsAdvect.hpp>
+#include <lsBooleanOperation.hpp>
+#include <lsCalculateCurvatures.hpp>
+#include <lsCalculateNormalVectors.hpp>
+#include <lsDetectFeatures.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsStencilSnapshot.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that normal vectors, curvatures and features calculated from
+  a stencil snapshot are the same as the ones calculated by iterating over
+  the level set, and that the snapshot is only built again once the level set
+  was changed.
+*/
+
+namespace ls = viennals;
+
+template <class T> class ConstantVelocity : public ls::VelocityField<T> {
+public:
+  T getScalarVelocity(const std::array<T, 3> & /*coordinate*/,
+                      int /*material*/,
+                      const std::array<T, 3> & /*normalVector*/,
+                      unsigned long /*pointId*/) override {
+    return 0.3;
+  }
+};
+
+// box with a spherical cap, which has edges and corners
+template <class T, int D> ls::SmartPointer<ls::Domain<T, D>> makeGeometry() {
+  double bounds[2 * D];
+  typename ls::Domain<T, D>::BoundaryType boundaryCons[D];
+  for (int i = 0; i < D; ++i) {
+    bounds[2 * i] = -10.;
+    bounds[2 * i + 1] = 10.;
+    boundaryCons[i] = ls::Domain<T, D>::BoundaryType::REFLECTIVE_BOUNDARY;
+  }
+  auto levelSet = ls::Domain<T, D>::New(bounds, boundaryCons, 0.4);
+
+  T minCorner[3] = {-4., -4., -4.};
+  T maxCorner[3] = {4., 4., 4.};
+  ls::MakeGeometry<T, D>(levelSet, ls::Box<T, D>::New(minCorner, maxCorner))
+      .apply();
+
+  auto sphere = ls::Domain<T, D>::New(levelSet->getGrid());
+  T origin[3] = {0., 0., 0.};
+  origin[D - 1] = 4.;
+  ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 3.)).apply();
+  ls::BooleanOperation<T, D>(levelSet, sphere,
+                             ls::BooleanOperationEnum::UNION)
+      .apply();
+  return levelSet;
+}
+
+template <class T, int D>
+void compareScalarData(ls::SmartPointer<ls::Domain<T, D>> &levelSet,
+                       ls::SmartPointer<ls::Domain<T, D>> &snapshotLevelSet,
+                       const char *label, T tolerance = 0.) {
+  auto *data = levelSet->getPointData().getScalarData(label);
+  auto *snapshotData = snapshotLevelSet->getPointData().getScalarData(label);
+  VC_TEST_ASSERT(data != nullptr && snapshotData != nullptr);
+  VC_TEST_ASSERT(data->size() == levelSet->getNumberOfPoints());
+  VC_TEST_ASSERT(data->size() == snapshotData->size());
+  for (std::size_t i = 0; i < data->size(); ++i)
+    VC_TEST_ASSERT(std::abs((*data)[i] - (*snapshotData)[i]) <= tolerance);
+}
+
+template <class T, int D>
+void compareVectorData(ls::SmartPointer<ls::Domain<T, D>> &levelSet,
+                       ls::SmartPointer<ls::Domain<T, D>> &snapshotLevelSet,
+                       const char *label, T tolerance) {
+  auto *data = levelSet->getPointData().getVectorData(label);
+  auto *snapshotData = snapshotLevelSet->getPointData().getVectorData(label);
+  VC_TEST_ASSERT(data != nullptr && snapshotData != nullptr);
+  VC_TEST_ASSERT(data->size() == levelSet->getNumberOfPoints());
+  VC_TEST_ASSERT(data->size() == snapshotData->size());
+  for (std::size_t i = 0; i < data->size(); ++i)
+    for (int j = 0; j < D; ++j)
+      VC_TEST_ASSERT(std::abs((*data)[i][j] - (*snapshotData)[i][j]) <=
+                     tolerance);
+}
+
+template <class T, int D> void compareAlgorithms() {
+  // the same formulas are evaluated, so only the rounding might differ
+  const T tolerance = 64 * std::numeric_limits<T>::epsilon();
+  auto levelSet = makeGeometry<T, D>();
+  auto snapshotLevelSet = ls::Domain<T, D>::New(levelSet);
+  auto snapshot = ls::SmartPointer<ls::StencilSnapshot<T, D>>::New(
+      snapshotLevelSet, ls::StencilShapeEnum::BOX, 1);
+
+  // normal vectors
+  for (auto method : {ls::NormalCalculationMethodEnum::CENTRAL_DIFFERENCES,
+                      ls::NormalCalculationMethodEnum::ONE_SIDED_MIN_MOD}) {
+    ls::CalculateNormalVectors<T, D> normals(levelSet);
+    normals.setMethod(method);
+    normals.apply();
+
+    ls::CalculateNormalVectors<T, D> snapshotNormals(snapshotLevelSet);
+    snapshotNormals.setMethod(method);
+    snapshotNormals.setStencilSnapshot(snapshot);
+    snapshotNormals.apply();
+    VC_TEST_ASSERT(snapshot->isValid());
+
+    compareVectorData(levelSet, snapshotLevelSet,
+                      ls::CalculateNormalVectors<T, D>::normalVectorsLabel,
+                      tolerance);
+  }
+
+  // curvatures
+  const auto curvatureType =
+      (D == 3) ? ls::CurvatureEnum::MEAN_AND_GAUSSIAN_CURVATURE
+               : ls::CurvatureEnum::MEAN_CURVATURE;
+  ls::CalculateCurvatures<T, D>(levelSet, curvatureType).apply();
+  ls::CalculateCurvatures<T, D> snapshotCurvatures(snapshotLevelSet,
+                                                   curvatureType);
+  snapshotCurvatures.setStencilSnapshot(snapshot);
+  snapshotCurvatures.apply();
+  compareScalarData(levelSet, snapshotLevelSet,
+                    ls::CalculateCurvatures<T, D>::meanCurvatureLabel,
+                    tolerance);
+  if constexpr (D == 3)
+    compareScalarData(levelSet, snapshotLevelSet,
+                      ls::CalculateCurvatures<T, D>::gaussianCurvatureLabel,
+                      tolerance);
+
+  // features, the normals angle method expands the level set
+  for (auto method : {ls::FeatureDetectionEnum::CURVATURE,
+                      ls::FeatureDetectionEnum::NORMALS_ANGLE}) {
+    ls::DetectFeatures<T, D> features(levelSet);
+    features.setDetectionMethod(method);
+    features.apply();
+    ls::DetectFeatures<T, D> snapshotFeatures(snapshotLevelSet);
+    snapshotFeatures.setDetectionMethod(method);
+    snapshotFeatures.setStencilSnapshot(snapshot);
+    snapshotFeatures.apply();
+    VC_TEST_ASSERT(snapshot->isValid());
+
+    compareScalarData(levelSet, snapshotLevelSet,
+                      ls::DetectFeatures<T, D>::featureMarkersLabel);
+    auto *markers = levelSet->getPointData().getScalarData(
+        ls::DetectFeatures<T, D>::featureMarkersLabel);
+    unsigned numberOfFeatures = 0;
+    for (auto marker : *markers)
+      numberOfFeatures += (marker == 1);
+    std::cout << D << "D: " << numberOfFeatures << " feature points"
+              << std::endl;
+    VC_TEST_ASSERT(numberOfFeatures > 0);
+  }
+}
+
+template <class T, int D> void checkVersions() {
+  auto levelSet = makeGeometry<T, D>();
+  ls::StencilSnapshot<T, D> snapshot(levelSet);
+  VC_TEST_ASSERT(!snapshot.isValid());
+  snapshot.apply();
+  VC_TEST_ASSERT(snapshot.isValid());
+  VC_TEST_ASSERT(snapshot.getNumberOfPoints() == levelSet->getNumberOfPoints());
+
+  // stencils of the center points are ordered by point id
+  auto stencil = snapshot.getStencil(0);
+  VC_TEST_ASSERT(stencil.getCenter().getPointId() == 0);
+  VC_TEST_ASSERT(stencil.getSize() == 2 * D);
+
+  // changing the point data does not change the values
+  const auto version = levelSet->getVersion();
+  std::vector<T> data(levelSet->getNumberOfPoints(), 1.);
+  levelSet->getPointData().insertNextScalarData(data, "Data");
+  VC_TEST_ASSERT(levelSet->getVersion() == version);
+  VC_TEST_ASSERT(snapshot.isValid());
+
+  // copies have different versions
+  auto copy = ls::Domain<T, D>::New(levelSet);
+  VC_TEST_ASSERT(copy->getVersion() != version);
+
+  // changing the shape or radius requires building the stencils again
+  snapshot.setRadius(2);
+  VC_TEST_ASSERT(!snapshot.isValid());
+  snapshot.apply();
+  VC_TEST_ASSERT(snapshot.isValid());
+  VC_TEST_ASSERT(snapshot.getStencil(0).getSize() == 4 * D);
+  VC_TEST_ASSERT(snapshot.contains(ls::StencilShapeEnum::STAR, 1));
+  VC_TEST_ASSERT(!snapshot.contains(ls::StencilShapeEnum::BOX, 1));
+
+  // advection changes the values
+  auto velocities = ls::SmartPointer<ConstantVelocity<T>>::New();
+  ls::Advect<T, D> advection(levelSet, velocities);
+  advection.setAdvectionTime(0.5);
+  advection.apply();
+  VC_TEST_ASSERT(levelSet->getVersion() != version);
+  VC_TEST_ASSERT(!snapshot.isValid());
+
+  snapshot.apply();
+  VC_TEST_ASSERT(snapshot.isValid());
+  VC_TEST_ASSERT(snapshot.getNumberOfPoints() == levelSet->getNumberOfPoints());
+
+  // so do boolean operations
+  ls::BooleanOperation<T, D>(levelSet, ls::BooleanOperationEnum::INVERT)
+      .apply();
+  VC_TEST_ASSERT(!snapshot.isValid());
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  compareAlgorithms<double, 2>();
+  compareAlgorithms<double, 3>();
+  compareAlgorithms<float, 3>();
+
+  checkVersions<double, 2>();
+  checkVersions<double, 3>();
+
+  return 0;
+}
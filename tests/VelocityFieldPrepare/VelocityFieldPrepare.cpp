@@ -0,0 +1,138 @@
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that Advect calls VelocityField::prepare2D with the stage and
+  its time before the velocities of every time step and Runge-Kutta stage
+  are requested, and VelocityField::finalize afterwards. The velocities are
+  calculated for all points of the top level set in prepare2D, which has to
+  give the same result as calculating them point by point.
+*/
+
+namespace ls = viennals;
+
+constexpr int D = 2;
+using LevelSetType = ls::SmartPointer<ls::Domain<double, D>>;
+
+double velocityAt(double x) { return 1. + 0.1 * x; }
+
+class PreparedVelocity : public ls::VelocityField<double> {
+  std::vector<double> preparedVelocities;
+  bool prepared = false;
+
+public:
+  std::vector<std::pair<unsigned, double>> stages;
+  unsigned numberOfUnpreparedRequests = 0;
+
+  void prepare2D(const std::vector<LevelSetType> &levelSets, unsigned stage,
+                 double time) override {
+    stages.emplace_back(stage, time);
+    auto &topLevelSet = levelSets.back();
+    const auto gridDelta = topLevelSet->getGrid().getGridDelta();
+    preparedVelocities.assign(topLevelSet->getNumberOfPoints(), 0.);
+    for (viennahrle::ConstSparseIterator<ls::Domain<double, D>::DomainType> it(
+             std::as_const(*topLevelSet).getDomain());
+         !it.isFinished(); it.next()) {
+      if (it.isDefined())
+        preparedVelocities[it.getPointId()] =
+            velocityAt(it.getStartIndices()[0] * gridDelta);
+    }
+    prepared = true;
+  }
+
+  void finalize() override {
+    preparedVelocities.clear();
+    prepared = false;
+  }
+
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int /*material*/,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long pointId) override {
+    if (!prepared || pointId >= preparedVelocities.size()) {
+#pragma omp atomic
+      ++numberOfUnpreparedRequests;
+      return velocityAt(coordinate[0]);
+    }
+    return preparedVelocities[pointId];
+  }
+};
+
+class DirectVelocity : public ls::VelocityField<double> {
+public:
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int /*material*/,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    return velocityAt(coordinate[0]);
+  }
+};
+
+LevelSetType makeSphere() {
+  auto sphere = LevelSetType::New(0.25);
+  double origin[D] = {0., 0.};
+  ls::MakeGeometry<double, D>(sphere, ls::Sphere<double, D>::New(origin, 3.))
+      .apply();
+  return sphere;
+}
+
+void runTest(ls::TemporalSchemeEnum temporalScheme, unsigned numberOfStages) {
+  auto sphere = makeSphere();
+  auto velocities = ls::SmartPointer<PreparedVelocity>::New();
+  ls::Advect<double, D> advection(sphere, velocities);
+  advection.setTemporalScheme(temporalScheme);
+  advection.setAdvectionTime(0.5);
+  advection.apply();
+
+  auto referenceSphere = makeSphere();
+  ls::Advect<double, D> referenceAdvection(
+      referenceSphere, ls::SmartPointer<DirectVelocity>::New());
+  referenceAdvection.setTemporalScheme(temporalScheme);
+  referenceAdvection.setAdvectionTime(0.5);
+  referenceAdvection.apply();
+
+  VC_TEST_ASSERT(velocities->numberOfUnpreparedRequests == 0);
+
+  // every stage of every time step was prepared, in order and at increasing
+  // times
+  const auto &stages = velocities->stages;
+  VC_TEST_ASSERT(stages.size() ==
+                 numberOfStages * advection.getNumberOfTimeSteps());
+  for (unsigned i = 0; i < stages.size(); ++i) {
+    VC_TEST_ASSERT(stages[i].first == i % numberOfStages);
+    VC_TEST_ASSERT(stages[i].second >= 0. && stages[i].second <= 0.5);
+    if (stages[i].first == 0 && i > 0)
+      VC_TEST_ASSERT(stages[i].second > stages[i - numberOfStages].second);
+    if (stages[i].first == 1)
+      VC_TEST_ASSERT(stages[i].second > stages[i - 1].second);
+  }
+  VC_TEST_ASSERT(stages.front().second == 0.);
+
+  using ConstSparseIterator =
+      viennahrle::ConstSparseIterator<ls::Domain<double, D>::DomainType>;
+  ConstSparseIterator referenceIt(referenceSphere->getDomain());
+  for (ConstSparseIterator it(sphere->getDomain()); !it.isFinished();
+       it.next()) {
+    if (!it.isDefined() || std::abs(it.getValue()) > 0.5)
+      continue;
+    referenceIt.goToIndicesSequential(it.getStartIndices());
+    VC_TEST_ASSERT(referenceIt.isDefined());
+    VC_TEST_ASSERT(it.getValue() == referenceIt.getValue());
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest(ls::TemporalSchemeEnum::FORWARD_EULER, 1);
+  runTest(ls::TemporalSchemeEnum::RUNGE_KUTTA_2ND_ORDER, 2);
+  runTest(ls::TemporalSchemeEnum::RUNGE_KUTTA_3RD_ORDER, 3);
+
+  return 0;
+}
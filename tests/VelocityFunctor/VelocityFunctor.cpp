@@ -0,0 +1,94 @@
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that advecting with the velocity type known at compile time
+  gives the same result as advecting through the virtual interface of the
+  velocity field.
+*/
+
+namespace ls = viennals;
+
+template <class T> T velocityFunction(const ls::Vec3D<T> &coordinate) {
+  return 1. + 0.1 * coordinate[0];
+}
+
+class RuntimeVelocity : public ls::VelocityField<double> {
+public:
+  double getScalarVelocity(const std::array<double, 3> &coordinate,
+                           int /*material*/,
+                           const std::array<double, 3> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    return velocityFunction<double>(coordinate);
+  }
+};
+
+template <int D> void runTest(ls::SpatialSchemeEnum spatialScheme) {
+  using T = double;
+  using ConstSparseIterator =
+      viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType>;
+  double gridDelta = 0.25;
+
+  auto makeSphere = [&]() {
+    auto sphere = ls::Domain<T, D>::New(gridDelta);
+    T origin[3] = {0., 0., 0.};
+    ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 3.)).apply();
+    return sphere;
+  };
+
+  auto sphere = makeSphere();
+  auto functorSphere = makeSphere();
+
+  ls::Advect<T, D> advection(sphere, ls::SmartPointer<RuntimeVelocity>::New());
+  advection.setSpatialScheme(spatialScheme);
+  advection.setAdvectionTime(0.5);
+  advection.apply();
+
+  auto function = [](const ls::Vec3D<T> &coordinate, int /*material*/,
+                     const ls::Vec3D<T> & /*normalVector*/,
+                     unsigned long /*pointId*/) {
+    return velocityFunction<T>(coordinate);
+  };
+  using FunctionVelocity = ls::FunctionVelocityField<T, decltype(function)>;
+
+  ls::Advect<T, D, FunctionVelocity> functorAdvection(
+      functorSphere, ls::SmartPointer<FunctionVelocity>::New(function));
+  functorAdvection.setSpatialScheme(spatialScheme);
+  functorAdvection.setAdvectionTime(0.5);
+  functorAdvection.apply();
+
+  VC_TEST_ASSERT(advection.getNumberOfTimeSteps() ==
+                 functorAdvection.getNumberOfTimeSteps());
+  LSTEST_ASSERT_VALID_LS(functorSphere, T, D);
+  VC_TEST_ASSERT(sphere->getNumberOfPoints() ==
+                 functorSphere->getNumberOfPoints());
+
+  ConstSparseIterator itA(sphere->getDomain());
+  ConstSparseIterator itB(functorSphere->getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    if (!itA.isDefined())
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(itB.isDefined());
+    VC_TEST_ASSERT(std::abs(itA.getValue() - itB.getValue()) < 1e-12);
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  for (auto spatialScheme :
+       {ls::SpatialSchemeEnum::ENGQUIST_OSHER_1ST_ORDER,
+        ls::SpatialSchemeEnum::LAX_FRIEDRICHS_1ST_ORDER,
+        ls::SpatialSchemeEnum::LOCAL_LAX_FRIEDRICHS_1ST_ORDER,
+        ls::SpatialSchemeEnum::WENO_3RD_ORDER}) {
+    runTest<2>(spatialScheme);
+    runTest<3>(spatialScheme);
+  }
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include <cmath>
+#include <iostream>
+
+#include <lsAdvect.hpp>
+#include <lsDomain.hpp>
+#include <lsMakeGeometry.hpp>
+#include <lsTestAsserts.hpp>
+
+/**
+  Test checking that distributing the active points between the threads
+  using work stealing gives the same result as letting each thread work on
+  one static segment of the level set. The velocity depends on the position,
+  so a point only gets the right velocity if it is processed correctly.
+*/
+
+namespace ls = viennals;
+
+class UnevenVelocity : public ls::VelocityField<double> {
+public:
+  double getScalarVelocity(const ls::Vec3D<double> &coordinate,
+                           int /*material*/,
+                           const ls::Vec3D<double> & /*normalVector*/,
+                           unsigned long /*pointId*/) override {
+    return (coordinate[1] < 2.) ? 1. : 1. + 0.1 * std::sin(coordinate[0]);
+  }
+};
+
+template <int D> void runTest() {
+  using T = double;
+
+  auto sphere = ls::SmartPointer<ls::Domain<T, D>>::New(0.5);
+  T origin[3] = {0., 0., 0.};
+  ls::MakeGeometry<T, D>(sphere, ls::Sphere<T, D>::New(origin, 5.)).apply();
+
+  auto velocities = ls::SmartPointer<UnevenVelocity>::New();
+
+  std::vector<ls::SmartPointer<ls::Domain<T, D>>> results;
+  for (bool workStealing : {false, true}) {
+    auto levelSet = ls::SmartPointer<ls::Domain<T, D>>::New(sphere);
+    levelSet->getDomain().segment();
+
+    ls::Advect<T, D> advectionKernel(levelSet, velocities);
+    advectionKernel.setWorkStealing(workStealing);
+    advectionKernel.setAdvectionTime(2.);
+    advectionKernel.apply();
+
+    LSTEST_ASSERT_VALID_LS(levelSet, T, D);
+    results.push_back(levelSet);
+  }
+
+  // the schedule must not change the result
+  VC_TEST_ASSERT(results[0]->getNumberOfPoints() ==
+                 results[1]->getNumberOfPoints());
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itA(
+      results[0]->getDomain());
+  viennahrle::ConstSparseIterator<typename ls::Domain<T, D>::DomainType> itB(
+      results[1]->getDomain());
+  for (; !itA.isFinished(); itA.next()) {
+    if (!itA.isDefined())
+      continue;
+    itB.goToIndicesSequential(itA.getStartIndices());
+    VC_TEST_ASSERT(std::abs(itA.getValue() - itB.getValue()) < 1e-12);
+  }
+}
+
+int main() {
+  omp_set_num_threads(4);
+
+  runTest<2>();
+  runTest<3>();
+
+  return 0;
+}